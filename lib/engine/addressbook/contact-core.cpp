@@ -56,6 +56,10 @@ Ekiga::ContactCore::add_source (SourcePtr source)
   sources.push_back (source);
   source_added (source);
   source->questions.connect (boost::ref (questions));
+
+  conns.add (source->book_added.connect (boost::bind (&Ekiga::ContactCore::on_book_added, this, _1)));
+  conns.add (source->book_removed.connect (boost::bind (&Ekiga::ContactCore::on_book_removed, this, _1)));
+  source->visit_books (boost::bind (&Ekiga::ContactCore::on_book_found, this, _1));
 }
 
 void
@@ -68,3 +72,53 @@ Ekiga::ContactCore::visit_sources (boost::function1<bool, SourcePtr > visitor) c
        ++iter)
     go_on = visitor (*iter);
 }
+
+void
+Ekiga::ContactCore::visit_matching_contacts (const std::string text,
+					     boost::function1<bool, ContactPtr > visitor) const
+{
+  index.visit_matches (text, visitor);
+}
+
+bool
+Ekiga::ContactCore::on_book_found (BookPtr book)
+{
+  on_book_added (book);
+
+  return true;
+}
+
+void
+Ekiga::ContactCore::on_book_added (BookPtr book)
+{
+  boost::shared_ptr<Ekiga::scoped_connections> book_conn (new Ekiga::scoped_connections);
+
+  book_conn->add (book->contact_added.connect (boost::bind (&Ekiga::ContactIndex::add, &index, _1)));
+  book_conn->add (book->contact_updated.connect (boost::bind (&Ekiga::ContactIndex::add, &index, _1)));
+  book_conn->add (book->contact_removed.connect (boost::bind (&Ekiga::ContactIndex::remove, &index, _1)));
+  book_conns[book] = book_conn;
+  book->visit_contacts (boost::bind (&Ekiga::ContactCore::on_contact_found, this, _1));
+}
+
+void
+Ekiga::ContactCore::on_book_removed (BookPtr book)
+{
+  book_conns.erase (book);
+  book->visit_contacts (boost::bind (&Ekiga::ContactCore::on_contact_gone, this, _1));
+}
+
+bool
+Ekiga::ContactCore::on_contact_found (ContactPtr contact)
+{
+  index.add (contact);
+
+  return true;
+}
+
+bool
+Ekiga::ContactCore::on_contact_gone (ContactPtr contact)
+{
+  index.remove (contact);
+
+  return true;
+}
@@ -37,6 +37,7 @@
 
 #include "services.h"
 #include "source.h"
+#include "contact-index.h"
 #include "scoped-connections.h"
 #include "action-provider.h"
 #include "chain-of-responsibility.h"
@@ -102,6 +103,19 @@ namespace Ekiga
     void visit_sources (boost::function1<bool, SourcePtr > visitor) const;
 
 
+    /** Triggers a callback for all contacts, from all books of all sources,
+     * whose name, uri or phone number starts with the given text. This uses
+     * an index kept up to date from the books' signals, so it is fast enough
+     * for as-you-type searching and doesn't query the backends. The
+     * presentities of the rosters (PresenceCore heaps) aren't indexed.
+     * @param The text to look for.
+     * @param The callback (the return value means "go on" and allows
+     *  stopping the visit)
+     */
+    void visit_matching_contacts (const std::string text,
+				  boost::function1<bool, ContactPtr > visitor) const;
+
+
     /** This signal is emitted when a Ekiga::Source has been
      * added to the ContactCore Service.
      */
@@ -116,6 +130,17 @@ namespace Ekiga
 
     std::list<SourcePtr > sources;
     Ekiga::scoped_connections conns;
+
+    ContactIndex index;
+
+    /* the connections to each book, dropped when it goes away */
+    std::map<BookPtr, boost::shared_ptr<Ekiga::scoped_connections> > book_conns;
+
+    void on_book_added (BookPtr book);
+    void on_book_removed (BookPtr book);
+    bool on_contact_found (ContactPtr contact);
+    bool on_contact_gone (ContactPtr contact);
+    bool on_book_found (BookPtr book);
   };
 
 /**
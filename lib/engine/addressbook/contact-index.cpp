@@ -0,0 +1,181 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         contact-index.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of a prefix index over contacts
+ *
+ */
+
+#include <set>
+
+#include <glib.h>
+
+#include "contact-index.h"
+
+/* casefolds, decomposes and drops the combining marks, so "Éric" and
+ * "eric" get the same key
+ */
+static const std::string
+index_key (const std::string str)
+{
+  std::string result;
+  gchar* folded = g_utf8_casefold (str.c_str (), -1);
+  gchar* decomposed = g_utf8_normalize (folded, -1, G_NORMALIZE_NFKD);
+
+  for (const gchar* ptr = decomposed;
+       ptr != NULL && *ptr != '\0';
+       ptr = g_utf8_next_char (ptr)) {
+
+    const gunichar ch = g_utf8_get_char (ptr);
+
+    if (g_unichar_type (ch) != G_UNICODE_NON_SPACING_MARK
+	&& g_unichar_type (ch) != G_UNICODE_SPACING_MARK
+	&& g_unichar_type (ch) != G_UNICODE_ENCLOSING_MARK)
+      result.append (ptr, g_utf8_next_char (ptr) - ptr);
+  }
+
+  g_free (decomposed);
+  g_free (folded);
+
+  return result;
+}
+
+static void
+add_name_keys (const std::string name,
+	       std::set<std::string>& result)
+{
+  const std::string folded = index_key (name);
+  std::string::size_type start = 0;
+
+  result.insert (folded);
+
+  /* each word of the name, so "smith" finds "John Smith" */
+  while (start != std::string::npos) {
+
+    std::string::size_type end = folded.find (' ', start);
+    if (end != start)
+      result.insert (folded.substr (start, end == std::string::npos ? end : end - start));
+    start = (end == std::string::npos) ? end : end + 1;
+  }
+}
+
+static void
+add_uri_keys (const std::string uri,
+	      std::set<std::string>& result)
+{
+  const std::string folded = index_key (uri);
+  std::string::size_type colon = folded.find (':');
+  std::string digits;
+
+  result.insert (folded);
+
+  /* "sip:john@example.org" should also be found by typing "john" */
+  if (colon != std::string::npos && colon + 1 < folded.length ())
+    result.insert (folded.substr (colon + 1));
+
+  /* and phone numbers whatever the way they were written */
+  for (std::string::const_iterator iter = folded.begin ();
+       iter != folded.end ();
+       ++iter)
+    if (g_ascii_isdigit (*iter))
+      digits += *iter;
+  if ( !digits.empty ())
+    result.insert (digits);
+}
+
+void
+Ekiga::ContactIndex::add (ContactPtr contact)
+{
+  std::set<std::string> contact_keys;
+  const std::set<std::string> uris = contact->get_uris ();
+
+  remove (contact);
+
+  add_name_keys (contact->get_name (), contact_keys);
+  for (std::set<std::string>::const_iterator iter = uris.begin ();
+       iter != uris.end ();
+       ++iter)
+    add_uri_keys (*iter, contact_keys);
+
+  contact_keys.erase ("");
+
+  std::list<std::string>& stored = keys[contact];
+  for (std::set<std::string>::const_iterator iter = contact_keys.begin ();
+       iter != contact_keys.end ();
+       ++iter) {
+
+    index.insert (std::make_pair (*iter, contact));
+    stored.push_back (*iter);
+  }
+}
+
+void
+Ekiga::ContactIndex::remove (ContactPtr contact)
+{
+  std::map<ContactPtr, std::list<std::string> >::iterator found = keys.find (contact);
+
+  if (found == keys.end ())
+    return;
+
+  for (std::list<std::string>::const_iterator key = found->second.begin ();
+       key != found->second.end ();
+       ++key) {
+
+    std::pair<index_type::iterator, index_type::iterator> range = index.equal_range (*key);
+    for (index_type::iterator iter = range.first; iter != range.second; ++iter)
+      if (iter->second == contact) {
+
+	index.erase (iter);
+	break;
+      }
+  }
+
+  keys.erase (found);
+}
+
+void
+Ekiga::ContactIndex::visit_matches (const std::string text,
+				    boost::function1<bool, ContactPtr> visitor) const
+{
+  const std::string prefix = index_key (text);
+  std::set<ContactPtr> visited;
+  bool go_on = true;
+
+  if (prefix.empty ())
+    return;
+
+  for (index_type::const_iterator iter = index.lower_bound (prefix);
+       go_on
+	 && iter != index.end ()
+	 && iter->first.compare (0, prefix.length (), prefix) == 0;
+       ++iter)
+    if (visited.insert (iter->second).second)
+      go_on = visitor (iter->second);
+}
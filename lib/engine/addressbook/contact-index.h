@@ -0,0 +1,104 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         contact-index.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : interface of a prefix index over contacts
+ *
+ */
+
+#ifndef __CONTACT_INDEX_H__
+#define __CONTACT_INDEX_H__
+
+#include <list>
+#include <map>
+
+#include "contact.h"
+
+namespace Ekiga
+{
+
+/**
+ * @addtogroup contacts
+ * @{
+ */
+
+  /** In-process prefix index over the names and uris of contacts.
+   *
+   * Each contact is indexed under several keys : the words of its name,
+   * its uris (with and without the scheme) and the digits of its phone
+   * numbers, all casefolded. Keys are kept sorted, so looking for a prefix
+   * is a logarithmic lookup followed by a walk over the matches only.
+   */
+  class ContactIndex
+  {
+  public:
+
+    /** Adds a contact to the index -- or reindexes it if it was already.
+     * @param The contact.
+     */
+    void add (ContactPtr contact);
+
+
+    /** Removes a contact from the index.
+     * @param The contact.
+     */
+    void remove (ContactPtr contact);
+
+
+    /** Triggers a callback for each contact having a key starting with
+     * the given text ; each contact is visited only once.
+     * @param The text typed by the user.
+     * @param The callback (the return value means "go on" and allows
+     *  stopping the visit)
+     */
+    void visit_matches (const std::string text,
+			boost::function1<bool, ContactPtr> visitor) const;
+
+
+    /** Returns the number of indexed contacts.
+     */
+    int size () const
+    { return keys.size (); }
+
+  private:
+
+    typedef std::multimap<std::string, ContactPtr> index_type;
+
+    index_type index;
+    std::map<ContactPtr, std::list<std::string> > keys;
+  };
+
+/**
+ * @}
+ */
+
+};
+
+#endif
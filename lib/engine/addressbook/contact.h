@@ -74,6 +74,14 @@ namespace Ekiga
      * @return whether that Ekiga::Contact corresponds to this uri.
      */
     virtual bool has_uri (const std::string uri) const = 0;
+
+    /** Returns the uris (and phone numbers) of that Ekiga::Contact.
+     * It is used to index the contact for searching ; contacts which
+     * don't implement it can only be found by name.
+     * @return The uris of the Ekiga::Contact.
+     */
+    virtual const std::set<std::string> get_uris () const
+    { return std::set<std::string> (); }
   };
 
 
@@ -38,6 +38,7 @@
 #include <iostream>
 #endif
 
+#include <algorithm>
 #include <math.h>
 
 #include <glib/gi18n.h>
@@ -47,6 +48,7 @@
 #include "ekiga-settings.h"
 
 #include "audioinput-core.h"
+#include "trace-ring.h"
 
 using namespace Ekiga;
 
@@ -81,11 +83,14 @@ AudioInputCore::AudioInputCore (Ekiga::ServiceCore& _core):
   stream_config.bits_per_sample = 0;
   stream_config.buffer_size = 0;
   stream_config.num_buffers = 0;
+  stream_users = 0;
 
   desired_volume = 0;
   current_volume = 0;
 
   current_manager = NULL;
+  devices_cache_valid = false;
+  devices_generation = 0;
   average_level = 0;
   calculate_average = false;
   yield = false;
@@ -132,15 +137,47 @@ AudioInputCore::setup ()
   g_free (audio_device);
 }
 
+static void
+trace_device_opened (AudioInputDevice& device,
+                     AudioInputSettings& /*settings*/)
+{
+  EKIGA_TRACE (TraceDeviceOpened, 0, "audioinput", device.GetString ().c_str ());
+}
+
+static void
+trace_device_closed (AudioInputDevice& device)
+{
+  EKIGA_TRACE (TraceDeviceClosed, 0, "audioinput", device.GetString ().c_str ());
+}
+
+static void
+trace_device_error (AudioInputDevice& device,
+                    AudioInputErrorCodes& error)
+{
+  EKIGA_TRACE (TraceDeviceError, error, "audioinput", device.GetString ().c_str ());
+}
+
 void
 AudioInputCore::add_manager (AudioInputManager& manager)
 {
-  managers.insert (&manager);
+  {
+    /* the devices may be listed from another thread meanwhile */
+    yield = true;
+    PWaitAndSignal m(core_mutex);
+
+    managers.insert (&manager);
+    devices_cache_valid = false;
+    devices_generation++;
+  }
   manager_added (manager);
 
   manager.device_error.connect   (boost::bind (boost::ref(device_error), boost::ref(manager), _1, _2));
   manager.device_opened.connect  (boost::bind (boost::ref(device_opened), boost::ref(manager), _1, _2));
   manager.device_closed.connect  (boost::bind (boost::ref(device_closed), boost::ref(manager), _1));
+
+  manager.device_error.connect (&trace_device_error);
+  manager.device_opened.connect (&trace_device_opened);
+  manager.device_closed.connect (&trace_device_closed);
 }
 
 
@@ -176,12 +213,32 @@ AudioInputCore::get_devices (std::vector<AudioInputDevice>& devices)
   yield = true;
   PWaitAndSignal m(core_mutex);
 
-  devices.clear();
+  /* Probing the managers can take a while, so it is done without the lock
+   * (unless our caller holds it), and the result is only kept if nothing
+   * changed the managers or the devices meanwhile
+   */
+  while (!devices_cache_valid) {
 
-  for (std::set<AudioInputManager*>::const_iterator iter = managers.begin ();
-       iter != managers.end ();
-       ++iter)
-    (*iter)->get_devices (devices);
+    std::set<AudioInputManager*> probed_managers = managers;
+    std::vector<AudioInputDevice> probed_devices;
+    unsigned generation = devices_generation;
+
+    core_mutex.Signal ();
+    for (std::set<AudioInputManager*>::const_iterator iter = probed_managers.begin ();
+         iter != probed_managers.end ();
+         ++iter)
+      (*iter)->get_devices (probed_devices);
+    yield = true;
+    core_mutex.Wait ();
+
+    if (generation == devices_generation) {
+
+      devices_cache = probed_devices;
+      devices_cache_valid = true;
+    }
+  }
+
+  devices = devices_cache;
 
 #if PTRACING
   for (std::vector<AudioInputDevice>::const_iterator iter = devices.begin ();
@@ -194,6 +251,16 @@ AudioInputCore::get_devices (std::vector<AudioInputDevice>& devices)
 
 }
 
+void
+AudioInputCore::refresh_devices ()
+{
+  yield = true;
+  PWaitAndSignal m(core_mutex);
+
+  devices_cache_valid = false;
+  devices_generation++;
+}
+
 void
 AudioInputCore::set_device (const std::string& device_string)
 {
@@ -269,6 +336,11 @@ AudioInputCore::add_device (const std::string& source,
 
     if ((*iter)->has_device (source, device_name, device)) {
 
+      if (devices_cache_valid
+          && std::find (devices_cache.begin (), devices_cache.end (), device) == devices_cache.end ())
+        devices_cache.push_back (device);
+      devices_generation++;
+
       device_added (device);
 
       boost::shared_ptr<Ekiga::Notification> notif (new Ekiga::Notification (Ekiga::Notification::Info,
@@ -296,6 +368,10 @@ AudioInputCore::remove_device (const std::string& source,
 
      if ((*iter)->has_device (source, device_name, device)) {
 
+       devices_cache.erase (std::remove (devices_cache.begin (), devices_cache.end (), device),
+                            devices_cache.end ());
+       devices_generation++;
+
        if ( ( current_device == device) && (preview_config.active || stream_config.active) ) {
 
             AudioInputDevice new_device;
@@ -382,9 +458,19 @@ AudioInputCore::start_stream (unsigned channels,
   yield = true;
   PWaitAndSignal m(core_mutex);
 
+  /* Several users can share the stream (the calls of a conference) : it
+   * stays as the first one started it, until the last one stops it */
+  if (stream_config.active) {
+
+    stream_users++;
+    PTRACE(4, "AudioInputCore\tStream already started " << stream_config.channels << "x" << stream_config.samplerate
+           << "/" << stream_config.bits_per_sample << ", now used " << stream_users << " times");
+    return;
+  }
+
   PTRACE(4, "AudioInputCore\tStarting stream " << channels << "x" << samplerate << "/" << bits_per_sample);
 
-  if (preview_config.active || stream_config.active) {
+  if (preview_config.active) {
 
     PTRACE(1, "AudioInputCore\tTrying to start stream in wrong state");
   }
@@ -395,6 +481,7 @@ AudioInputCore::start_stream (unsigned channels,
   stream_config.channels = channels;
   stream_config.samplerate = samplerate;
   stream_config.bits_per_sample = bits_per_sample;
+  stream_users = 1;
 
   average_level = 0;
 }
@@ -413,11 +500,26 @@ AudioInputCore::stop_stream ()
     return;
   }
 
+  if (stream_users > 1) {
+
+    stream_users--;
+    return;
+  }
+
   internal_close();
   stream_config.active = false;
+  stream_users = 0;
   average_level = 0;
 }
 
+unsigned
+AudioInputCore::get_stream_samplerate ()
+{
+  PWaitAndSignal m(core_mutex);
+
+  return (stream_config.active ? stream_config.samplerate : 0);
+}
+
 void
 AudioInputCore::get_frame_data (char* data,
 				unsigned size,
@@ -161,6 +161,13 @@ namespace Ekiga
       void get_devices(std::vector <std::string> & devices);
       void get_devices(std::vector <AudioInputDevice> & devices);
 
+      /** Forget the known devices
+       * The managers are only probed for their devices when needed : this
+       * makes the next call to get_devices probe them again. It is used when
+       * the devices changed in a way the HalManagers could not tell.
+       */
+      void refresh_devices ();
+
       /** Set a specific device
        * This functions sets the current audio input device.
        * It can also be used while in a stream or in preview mode,
@@ -220,6 +227,8 @@ namespace Ekiga
       /** Start the stream mode
        * Contrary to the video input core this can only be done if
        * preview is NOT active (responsability of the UI)
+       * If the stream is already started, it is shared: it keeps its
+       * parameters, and is only stopped by the last stop_stream().
        * @param channels the number of channels (1 or 2).
        * @param samplerate the samplerate.
        * @param bits_per_sample the number of bits per sample (e.g. 8, 16).
@@ -230,6 +239,11 @@ namespace Ekiga
        */
       void stop_stream ();
 
+      /** Get the sample rate of the stream, as it was started
+       * @return the sample rate, or 0 if the stream is not started.
+       */
+      unsigned get_stream_samplerate ();
+
 
       /** Get one audio buffer from the current manager.
        * This function will block until the buffer is completely filled.
@@ -314,8 +328,14 @@ namespace Ekiga
 
       std::set<AudioInputManager *> managers;
 
+      /* what the managers returned the last time we probed them */
+      std::vector<AudioInputDevice> devices_cache;
+      bool devices_cache_valid;
+      unsigned devices_generation; // bumped whenever the managers or devices change
+
       DeviceConfig preview_config;
       DeviceConfig stream_config;
+      unsigned stream_users;
 
       AudioInputManager* current_manager;
       AudioInputDevice current_device;
@@ -335,6 +355,10 @@ namespace Ekiga
       GSettings *audio_device_settings;
       guint audio_device_settings_signal;
     };
+
+    /* the key to get it from the ServiceCore */
+    const ServiceKey<AudioInputCore> audioinput_core_key ("audioinput-core");
+
 /**
  * @}
  */
@@ -46,6 +46,7 @@
 
 #include "audiooutput-core.h"
 #include "audiooutput-manager.h"
+#include "trace-ring.h"
 
 #include "ekiga-settings.h"
 
@@ -98,12 +99,15 @@ AudioOutputCore::AudioOutputCore (Ekiga::ServiceCore& core)
   current_primary_config.bits_per_sample = 0;
   current_primary_config.buffer_size = 0;
   current_primary_config.num_buffers = 0;
+  primary_users = 0;
 
   current_primary_volume = 0;
   desired_primary_volume = 0;
 
   current_manager[primary] = NULL;
   current_manager[secondary] = NULL;
+  devices_cache_valid = false;
+  devices_generation = 0;
   average_level = 0;
   calculate_average = false;
   yield = false;
@@ -293,15 +297,51 @@ AudioOutputCore::setup_sound_events (std::string e)
   }
 }
 
+static void
+trace_device_opened (AudioOutputPS ps,
+                     AudioOutputDevice& device,
+                     AudioOutputSettings& /*settings*/)
+{
+  EKIGA_TRACE (TraceDeviceOpened, ps, "audiooutput", device.GetString ().c_str ());
+}
+
+static void
+trace_device_closed (AudioOutputPS ps,
+                     AudioOutputDevice& device)
+{
+  EKIGA_TRACE (TraceDeviceClosed, ps, "audiooutput", device.GetString ().c_str ());
+}
+
+static void
+trace_device_error (AudioOutputPS /*ps*/,
+                    AudioOutputDevice& device,
+                    AudioOutputErrorCodes& error)
+{
+  EKIGA_TRACE (TraceDeviceError, error, "audiooutput", device.GetString ().c_str ());
+}
+
 void
 AudioOutputCore::add_manager (AudioOutputManager& manager)
 {
-  managers.insert (&manager);
+  {
+    /* the devices may be listed from another thread meanwhile */
+    yield = true;
+    PWaitAndSignal m_pri(core_mutex[primary]);
+    PWaitAndSignal m_sec(core_mutex[secondary]);
+
+    managers.insert (&manager);
+    devices_cache_valid = false;
+    devices_generation++;
+  }
   manager_added (manager);
 
   manager.device_error.connect (boost::bind (boost::ref(device_error), boost::ref(manager), _1, _2, _3));
   manager.device_opened.connect (boost::bind (boost::ref(device_opened), boost::ref(manager), _1, _2, _3));
   manager.device_closed.connect (boost::bind (boost::ref(device_closed), boost::ref(manager), _1, _2));
+
+  manager.device_error.connect (&trace_device_error);
+  manager.device_opened.connect (&trace_device_opened);
+  manager.device_closed.connect (&trace_device_closed);
 }
 
 void
@@ -372,14 +412,33 @@ AudioOutputCore::get_devices (std::vector <AudioOutputDevice>& devices)
 {
   yield = true;
   PWaitAndSignal m_pri(core_mutex[primary]);
-  PWaitAndSignal m_sec(core_mutex[secondary]);
 
-  devices.clear();
+  /* Probing the managers can take a while, so it is done without the lock
+   * (unless our caller holds it), and the result is only kept if nothing
+   * changed the managers or the devices meanwhile
+   */
+  while (!devices_cache_valid) {
 
-  for (std::set<AudioOutputManager*>::const_iterator iter = managers.begin ();
-       iter != managers.end ();
-       ++iter)
-    (*iter)->get_devices (devices);
+    std::set<AudioOutputManager*> probed_managers = managers;
+    std::vector<AudioOutputDevice> probed_devices;
+    unsigned generation = devices_generation;
+
+    core_mutex[primary].Signal ();
+    for (std::set<AudioOutputManager*>::const_iterator iter = probed_managers.begin ();
+         iter != probed_managers.end ();
+         ++iter)
+      (*iter)->get_devices (probed_devices);
+    yield = true;
+    core_mutex[primary].Wait ();
+
+    if (generation == devices_generation) {
+
+      devices_cache = probed_devices;
+      devices_cache_valid = true;
+    }
+  }
+
+  devices = devices_cache;
 
 #if PTRACING
   for (std::vector<AudioOutputDevice>::const_iterator iter = devices.begin ();
@@ -391,6 +450,16 @@ AudioOutputCore::get_devices (std::vector <AudioOutputDevice>& devices)
 
 }
 
+void
+AudioOutputCore::refresh_devices ()
+{
+  yield = true;
+  PWaitAndSignal m_pri(core_mutex[primary]);
+
+  devices_cache_valid = false;
+  devices_generation++;
+}
+
 void
 AudioOutputCore::set_device(AudioOutputPS ps,
                             const AudioOutputDevice& device)
@@ -443,6 +512,11 @@ AudioOutputCore::add_device (const std::string& sink,
 
      if ((*iter)->has_device (sink, device_name, device)) {
 
+       if (devices_cache_valid
+           && std::find (devices_cache.begin (), devices_cache.end (), device) == devices_cache.end ())
+         devices_cache.push_back (device);
+       devices_generation++;
+
        device_added(device);
 
        boost::shared_ptr<Ekiga::Notification> notif (new Ekiga::Notification (Ekiga::Notification::Info,
@@ -472,6 +546,10 @@ AudioOutputCore::remove_device (const std::string& sink,
 
      if ((*iter)->has_device (sink, device_name, device)) {
 
+       devices_cache.erase (std::remove (devices_cache.begin (), devices_cache.end (), device),
+                            devices_cache.end ());
+       devices_generation++;
+
        if ( (device == current_device[primary]) && (current_primary_config.active) ) {
 
          AudioOutputDevice new_device;
@@ -494,9 +572,14 @@ AudioOutputCore::start (unsigned channels,
   yield = true;
   PWaitAndSignal m_pri(core_mutex[primary]);
 
+  /* Several users can share the output (the calls of a conference) : it
+   * stays as the first one started it, until the last one stops it */
   if (current_primary_config.active) {
 
-    PTRACE(1, "AudioOutputCore\tTrying to start output device although already started");
+    primary_users++;
+    PTRACE(4, "AudioOutputCore\tOutput already started " << current_primary_config.channels << "x"
+           << current_primary_config.samplerate << "/" << current_primary_config.bits_per_sample
+           << ", now used " << primary_users << " times");
     return;
   }
 
@@ -509,6 +592,7 @@ AudioOutputCore::start (unsigned channels,
   current_primary_config.bits_per_sample = bits_per_sample;
   current_primary_config.buffer_size = 0;
   current_primary_config.num_buffers = 0;
+  primary_users = 1;
 }
 
 void
@@ -517,10 +601,25 @@ AudioOutputCore::stop()
   yield = true;
   PWaitAndSignal m_pri(core_mutex[primary]);
 
+  if (primary_users > 1) {
+
+    primary_users--;
+    return;
+  }
+
   average_level = 0;
   internal_close(primary);
 
   current_primary_config.active = false;
+  primary_users = 0;
+}
+
+unsigned
+AudioOutputCore::get_samplerate ()
+{
+  PWaitAndSignal m_pri(core_mutex[primary]);
+
+  return (current_primary_config.active ? current_primary_config.samplerate : 0);
 }
 
 void
@@ -582,7 +681,7 @@ AudioOutputCore::set_volume (AudioOutputPS ps,
     desired_primary_volume = volume;
 }
 
-void
+bool
 AudioOutputCore::play_buffer(AudioOutputPS ps,
                              const char* buffer,
                              unsigned long len,
@@ -590,6 +689,8 @@ AudioOutputCore::play_buffer(AudioOutputPS ps,
                              unsigned sample_rate,
                              unsigned bps)
 {
+  bool result = true;
+
   switch (ps) {
 
     case primary:
@@ -599,16 +700,16 @@ AudioOutputCore::play_buffer(AudioOutputPS ps,
 
         PTRACE(1, "AudioOutputCore\tDropping sound event, primary manager not set");
         core_mutex[primary].Signal();
-        return;
+        return true;
       }
 
       if (current_primary_config.active) {
 
         PTRACE(1, "AudioOutputCore\tDropping sound event, primary device not set");
         core_mutex[primary].Signal();
-        return;
+        return true;
       }
-      internal_play(primary, buffer, len, channels, sample_rate, bps);
+      result = internal_play(primary, buffer, len, channels, sample_rate, bps);
       core_mutex[primary].Signal();
 
       break;
@@ -618,12 +719,12 @@ AudioOutputCore::play_buffer(AudioOutputPS ps,
 
         if (current_manager[secondary]) {
 
-          internal_play(secondary, buffer, len, channels, sample_rate, bps);
+          result = internal_play(secondary, buffer, len, channels, sample_rate, bps);
           core_mutex[secondary].Signal();
         } else {
           core_mutex[secondary].Signal();
           PTRACE(1, "AudioOutputCore\tNo secondary audiooutput device defined, trying primary");
-          play_buffer(primary, buffer, len, channels, sample_rate, bps);
+          result = play_buffer(primary, buffer, len, channels, sample_rate, bps);
         }
 
       break;
@@ -631,6 +732,8 @@ AudioOutputCore::play_buffer(AudioOutputPS ps,
     default:
       break;
   }
+
+  return result;
 }
 
 void
@@ -749,7 +852,7 @@ AudioOutputCore::internal_close (AudioOutputPS ps)
     current_manager[ps]->close(ps);
 }
 
-void
+bool
 AudioOutputCore::internal_play(AudioOutputPS ps,
                                const char* buffer,
                                unsigned long len,
@@ -762,7 +865,7 @@ AudioOutputCore::internal_play(AudioOutputPS ps,
   unsigned buffer_size = (unsigned)((float)sample_rate/25);
 
   if (!internal_open ( ps, channels, sample_rate, bps))
-    return;
+    return false;
 
   if (current_manager[ps]) {
 
@@ -776,6 +879,8 @@ AudioOutputCore::internal_play(AudioOutputPS ps,
   }
 
   internal_close( ps);
+
+  return true;
 }
 
 void
@@ -155,6 +155,13 @@ namespace Ekiga
       void get_devices(std::vector <std::string> & devices);
       void get_devices(std::vector <AudioOutputDevice> & devices);
 
+      /** Forget the known devices
+       * The managers are only probed for their devices when needed : this
+       * makes the next call to get_devices probe them again. It is used when
+       * the devices changed in a way the HalManagers could not tell.
+       */
+      void refresh_devices ();
+
       /** Set a specific device
        * This function sets the current primary or secondary audio output device. This function can
        * also be used while in a stream or in preview mode. In that case the old
@@ -257,8 +264,9 @@ namespace Ekiga
        * @param channels the number of channels.
        * @param sample_rate the samplerate.
        * @param bps bits per sample.
+       * @return false if the device could not be opened with those parameters.
        */
-      void play_buffer(AudioOutputPS ps, const char* buffer, unsigned long len,
+      bool play_buffer(AudioOutputPS ps, const char* buffer, unsigned long len,
                        unsigned channels, unsigned sample_rate, unsigned bps);
 
 
@@ -272,6 +280,8 @@ namespace Ekiga
       void set_buffer_size (unsigned buffer_size, unsigned num_buffers);
 
      /** Start the audio output on the primary device
+       * If the output is already started, it is shared: it keeps its
+       * parameters, and is only stopped by the last stop().
        * @param channels the number of channels (1 or 2).
        * @param samplerate the samplerate.
        * @param bits_per_sample the number of bits per sample (e.g. 8, 16).
@@ -282,6 +292,11 @@ namespace Ekiga
        */
       void stop ();
 
+      /** Get the sample rate of the primary device output, as it was started
+       * @return the sample rate, or 0 if the output is not started.
+       */
+      unsigned get_samplerate ();
+
      /** Set one audio buffer in the current manager.
        * This function will pass one buffer to the current manager.
        * Requires the audio output to be started.
@@ -348,13 +363,18 @@ namespace Ekiga
       bool internal_open (AudioOutputPS ps, unsigned channels, unsigned samplerate,
                           unsigned bits_per_sample);
       void internal_close(AudioOutputPS ps);
-      void internal_play(AudioOutputPS ps, const char* buffer, unsigned long len,
+      bool internal_play(AudioOutputPS ps, const char* buffer, unsigned long len,
                          unsigned channels, unsigned sample_rate, unsigned bps);
 
       void calculate_average_level (const short *buffer, unsigned size);
 
       std::set<AudioOutputManager *> managers;
 
+      /* what the managers returned the last time we probed them */
+      std::vector<AudioOutputDevice> devices_cache;
+      bool devices_cache_valid;
+      unsigned devices_generation; // bumped whenever the managers or devices change
+
       typedef struct DeviceConfig {
         bool active;
         unsigned channels;
@@ -365,6 +385,7 @@ namespace Ekiga
       } DeviceConfig;
 
       DeviceConfig current_primary_config;
+      unsigned primary_users;
 
       AudioOutputManager* current_manager[2];
       AudioOutputDevice desired_primary_device;
@@ -387,6 +408,10 @@ namespace Ekiga
       GSettings *audio_device_settings;
       guint audio_device_settings_signals[2];
     };
+
+    /* the key to get it from the ServiceCore */
+    const ServiceKey<AudioOutputCore> audiooutput_core_key ("audiooutput-core");
+
 /**
  * @}
  */
@@ -40,12 +40,21 @@
 #include "platform/winpaths.h"
 #endif
 
+/* the rate the bundled sounds are played at, unless the device refuses it */
+#define BUNDLE_RATE 48000
+#define BUNDLE_FALLBACK_RATE 16000
+
 using namespace Ekiga;
 
 AudioEventScheduler::AudioEventScheduler (AudioOutputCore& _audio_output_core)
 : PThread (1000, NoAutoDeleteThread, HighestPriority, "AudioEventScheduler"),
-  audio_output_core (_audio_output_core)
+  audio_output_core (_audio_output_core),
+  bundle_rate (BUNDLE_RATE)
 {
+  gchar* filename = g_build_filename (DATA_DIR, "sounds", PACKAGE_NAME, SOUND_BUNDLE_FILE_NAME, NULL);
+  bundle.open (filename);
+  g_free (filename);
+
   end_thread = false;
   // Since windows does not like to restart a thread that
   // was never started, we do so here
@@ -96,11 +105,14 @@ void AudioEventScheduler::Main ()
 
     while (pending_event_list.size() > 0) {
       event = *(pending_event_list.begin()); pending_event_list.erase(pending_event_list.begin());
-      load_wav(event.name, event.is_file_name, buffer, buffer_len, channels, sample_rate, bps, ps);
-      if (buffer) {
-         audio_output_core.play_buffer (ps, buffer, buffer_len, channels, sample_rate, bps);
-        free (buffer);
-        buffer = NULL;
+      if (!play_bundled (event)) {
+
+        load_wav(event.name, event.is_file_name, buffer, buffer_len, channels, sample_rate, bps, ps);
+        if (buffer) {
+          audio_output_core.play_buffer (ps, buffer, buffer_len, channels, sample_rate, bps);
+          free (buffer);
+          buffer = NULL;
+        }
       }
       Current()->Sleep (10);
     }
@@ -251,6 +263,42 @@ void AudioEventScheduler::load_wav(const std::string & event_name, bool is_file_
 }
 
 
+bool AudioEventScheduler::play_bundled (const AudioEvent & event)
+{
+  std::string file_name;
+  AudioOutputPS ps = primary;
+  const short* samples = NULL;
+  unsigned long count = 0;
+
+  if (!bundle.is_open ())
+    return false;
+
+  if (event.is_file_name)
+    file_name = event.name;
+  else if (!get_file_name (event.name, file_name, ps))
+    return false;
+
+  // Only our own sounds are bundled, a path is one of the user's
+  if (file_name.find_first_of ("/" G_DIR_SEPARATOR_S) != std::string::npos
+      || !bundle.find (file_name, bundle_rate, samples, count))
+    return false;
+
+  PTRACE(4, "AEScheduler\tPlaying bundled " << file_name << " at " << bundle_rate << " Hz for event " << event.name);
+
+  if (!audio_output_core.play_buffer (ps, (const char*) samples, count * sizeof (short), 1, bundle_rate, 16)
+      && bundle_rate != BUNDLE_FALLBACK_RATE
+      && bundle.find (file_name, BUNDLE_FALLBACK_RATE, samples, count)) {
+
+    PTRACE(2, "AEScheduler\tThe device refused " << bundle_rate << " Hz, playing the bundled sounds at "
+           << BUNDLE_FALLBACK_RATE << " Hz from now on");
+    bundle_rate = BUNDLE_FALLBACK_RATE;
+    audio_output_core.play_buffer (ps, (const char*) samples, count * sizeof (short), 1, bundle_rate, 16);
+  }
+
+  return true;
+}
+
+
 void AudioEventScheduler::Terminate ()
 {
   quit ();
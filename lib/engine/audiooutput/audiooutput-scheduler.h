@@ -39,6 +39,7 @@
 #include "services.h"
 
 #include "audiooutput-info.h"
+#include "sound-bundle.h"
 
 #include <glib.h>
 #include <vector>
@@ -83,6 +84,7 @@ namespace Ekiga
     unsigned get_time_to_next_event();
     bool get_file_name(const std::string & event_name, std::string & file_name, AudioOutputPS & ps);
     void load_wav(const std::string & event_name, bool is_file_name, char* & buffer, unsigned long & len, unsigned & channels, unsigned & sample_rate, unsigned & bps, AudioOutputPS & ps);
+    bool play_bundled(const AudioEvent & event);
     void Terminate ();
 
     PSyncPoint run_thread;
@@ -98,6 +100,10 @@ namespace Ekiga
     std::vector <EventFileName> event_file_list;
 
     Ekiga::AudioOutputCore& audio_output_core;
+
+    /* our own sounds, ready to play, and the rate we play them at */
+    SoundBundle bundle;
+    unsigned bundle_rate;
   };
 };
 #endif
@@ -0,0 +1,75 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         sound-bundle-format.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : layout of the file bundling the sound events,
+ *                          shared by the tool writing it and Ekiga.
+ *
+ */
+
+#ifndef __SOUND_BUNDLE_FORMAT_H__
+#define __SOUND_BUNDLE_FORMAT_H__
+
+#include <stdint.h>
+
+/* The sounds of the events, converted at build time to mono 16 bits at a
+ * few rates, one after the other, each aligned on 16 bytes. The file
+ * starts with a header, then the index, one entry per sound and rate.
+ *
+ * The numbers and the samples are in the byte order of the machine which
+ * built the bundle: a machine with the other one ignores it and reads the
+ * WAV files, as does a version of Ekiga which doesn't know the format.
+ */
+
+#define SOUND_BUNDLE_FILE_NAME "ekiga-sounds.bundle"
+#define SOUND_BUNDLE_MAGIC "EKSOUND1"
+#define SOUND_BUNDLE_BYTE_ORDER 0x01020304
+#define SOUND_BUNDLE_NAME_SIZE 48
+#define SOUND_BUNDLE_ALIGNMENT 16
+
+namespace Ekiga
+{
+  struct SoundBundleHeader
+  {
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t count;             // of entries in the index
+  };
+
+  struct SoundBundleEntry
+  {
+    char name[SOUND_BUNDLE_NAME_SIZE];  // the name of the WAV file, NUL-terminated
+    uint32_t rate;
+    uint32_t samples;
+    uint32_t offset;            // from the start of the file
+    uint32_t reserved;
+  };
+};
+
+#endif
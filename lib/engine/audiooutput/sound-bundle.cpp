@@ -0,0 +1,132 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         sound-bundle.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the mapped bundle of the
+ *                          sound events.
+ *
+ */
+
+#include <string.h>
+
+#include <ptlib.h>
+
+#include "sound-bundle.h"
+
+using namespace Ekiga;
+
+SoundBundle::SoundBundle (): map(NULL), data(NULL), entries(NULL), count(0)
+{
+}
+
+SoundBundle::~SoundBundle ()
+{
+  close ();
+}
+
+bool
+SoundBundle::open (const std::string & path)
+{
+  GError* error = NULL;
+
+  close ();
+
+  map = g_mapped_file_new (path.c_str (), FALSE, &error);
+  if (map == NULL) {
+
+    PTRACE(4, "SoundBundle\tNo bundle " << path << ": " << error->message);
+    g_error_free (error);
+    return false;
+  }
+
+  data = g_mapped_file_get_contents (map);
+  const gsize size = g_mapped_file_get_length (map);
+  const SoundBundleHeader* header = (const SoundBundleHeader*) data;
+
+  if (size < sizeof (SoundBundleHeader)
+      || memcmp (header->magic, SOUND_BUNDLE_MAGIC, sizeof (header->magic))
+      || header->byte_order != SOUND_BUNDLE_BYTE_ORDER
+      || size < sizeof (SoundBundleHeader) + (gsize) header->count * sizeof (SoundBundleEntry)) {
+
+    PTRACE(1, "SoundBundle\tIgnoring " << path << ", which isn't a bundle for this machine");
+    close ();
+    return false;
+  }
+
+  count = header->count;
+  entries = (const SoundBundleEntry*) (data + sizeof (SoundBundleHeader));
+
+  for (unsigned i = 0; i < count; i++) {
+
+    if (entries[i].offset % sizeof (short) != 0
+        || entries[i].offset > size
+        || entries[i].samples > (size - entries[i].offset) / sizeof (short)
+        || memchr (entries[i].name, 0, SOUND_BUNDLE_NAME_SIZE) == NULL) {
+
+      PTRACE(1, "SoundBundle\tIgnoring " << path << ", which is damaged");
+      close ();
+      return false;
+    }
+  }
+
+  PTRACE(4, "SoundBundle\tMapped " << path << ", " << count << " sounds in " << size << " bytes");
+
+  return true;
+}
+
+bool
+SoundBundle::find (const std::string & name,
+                   unsigned rate,
+                   const short* & samples,
+                   unsigned long & samples_count) const
+{
+  for (unsigned i = 0; i < count; i++) {
+
+    if (entries[i].rate == rate && name == entries[i].name) {
+
+      samples = (const short*) (data + entries[i].offset);
+      samples_count = entries[i].samples;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+SoundBundle::close ()
+{
+  if (map != NULL)
+    g_mapped_file_unref (map);
+
+  map = NULL;
+  data = NULL;
+  entries = NULL;
+  count = 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         sound-bundle.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the mapped bundle of the sound
+ *                          events.
+ *
+ */
+
+#ifndef __SOUND_BUNDLE_H__
+#define __SOUND_BUNDLE_H__
+
+#include <string>
+#include <glib.h>
+#include <boost/noncopyable.hpp>
+
+#include "sound-bundle-format.h"
+
+namespace Ekiga
+{
+
+  /**
+   * @addtogroup audiooutput
+   * @{
+   */
+
+  /* The sound events, as sound-bundle-format.h describes them: the file
+   * is mapped read-only, and the sounds are played straight from it.
+   */
+  class SoundBundle: public boost::noncopyable
+  {
+  public:
+
+    SoundBundle ();
+
+    ~SoundBundle ();
+
+    /* Returns false if there is no such file, or if it isn't a bundle
+     * this machine can use */
+    bool open (const std::string & path);
+
+    bool is_open () const
+    { return map != NULL; }
+
+    /* Finds the sound the WAV file of that name was converted to at
+     * that rate: samples points into the map, and stays valid for as
+     * long as the bundle is open */
+    bool find (const std::string & name,
+               unsigned rate,
+               const short* & samples,
+               unsigned long & count) const;
+
+  private:
+
+    void close ();
+
+    GMappedFile* map;
+    const char* data;
+    const SoundBundleEntry* entries;
+    unsigned count;
+  };
+
+  /**
+   * @}
+   */
+};
+
+#endif
@@ -51,7 +51,8 @@ History::Book::create (Ekiga::ServiceCore & core)
 
 
 History::Book::Book (Ekiga::ServiceCore& core):
-  contact_core(core.get<Ekiga::ContactCore>("contact-core")), doc()
+  contact_core(core.get<Ekiga::ContactCore>("contact-core")), doc(),
+  saving(boost::bind (&History::Book::save, this))
 {
   boost::shared_ptr<Ekiga::CallCore> call_core = core.get<Ekiga::CallCore> ("call-core");
 
@@ -67,6 +68,7 @@ History::Book::Book (Ekiga::ServiceCore& core):
 
 History::Book::~Book ()
 {
+  saving.flush ();
 }
 
 
@@ -97,7 +99,8 @@ History::Book::add (const std::string & name,
 		    const std::string & uri,
                     const time_t & call_start,
                     const std::string & call_duration,
-		    const call_type c_t)
+		    const call_type c_t,
+		    const Ekiga::CallQualitySummary & quality)
 {
   boost::shared_ptr<Ekiga::ContactCore> ccore = contact_core.lock ();
 
@@ -106,11 +109,11 @@ History::Book::add (const std::string & name,
     xmlNodePtr root = xmlDocGetRootElement (doc.get ());
 
     boost::shared_ptr<History::Contact> contact =
-      History::Contact::create (ccore, doc, name, uri, call_start, call_duration, c_t);
+      History::Contact::create (ccore, doc, name, uri, call_start, call_duration, c_t, quality);
 
     xmlAddChild (root, contact->get_node ());
 
-    save ();
+    saving.schedule ();
 
     common_add (contact);
 
@@ -204,7 +207,7 @@ History::Book::clear ()
   root = xmlNewDocNode (doc.get (), NULL, BAD_CAST "list", NULL);
   xmlDocSetRootElement (doc.get (), root);
 
-  save ();
+  saving.schedule ();
 }
 
 void
@@ -221,11 +224,27 @@ void
 History::Book::on_cleared_call (boost::shared_ptr<Ekiga::Call> call,
 				std::string /*message*/)
 {
+  /* the full time series is only worth keeping on request */
+  const gchar* quality_dir = g_getenv ("EKIGA_CALL_QUALITY_DIR");
+  if (quality_dir != NULL) {
+
+    gchar* basename = g_strdup_printf ("%" G_GINT64_FORMAT "-%s.csv",
+                                       (gint64) call->get_start_time (),
+                                       call->get_id ().c_str ());
+    g_strdelimit (basename, G_DIR_SEPARATOR_S, '_');
+    gchar* filename = g_build_filename (quality_dir, basename, NULL);
+    if (!call->export_quality (filename))
+      g_warning ("Could not export the call quality to %s", filename);
+    g_free (filename);
+    g_free (basename);
+  }
+
   add (call->get_remote_party_name (),
        call->get_remote_uri (),
        call->get_start_time (),
        call->get_duration (),
-       (call->is_outgoing ()?PLACED:RECEIVED));
+       (call->is_outgoing ()?PLACED:RECEIVED),
+       call->get_quality_summary ());
 }
 
 void
@@ -259,7 +278,7 @@ History::Book::enforce_size_limit()
 
   if (flag) {
 
-    save ();
+    saving.schedule ();
     updated (this->shared_from_this ());
   }
 }
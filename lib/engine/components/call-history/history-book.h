@@ -41,6 +41,7 @@
 #include "history-contact.h"
 
 #include "ekiga-settings.h"
+#include "write-behind.h"
 #include "scoped-connections.h"
 #include "book-impl.h"
 #include "dynamic-object.h"
@@ -83,7 +84,8 @@ namespace History
               const std::string & uri,
               const time_t & call_start,
               const std::string & call_duration,
-              const call_type c_t);
+              const call_type c_t,
+              const Ekiga::CallQualitySummary & quality = Ekiga::CallQualitySummary ());
 
     void clear ();
 
@@ -112,6 +114,7 @@ namespace History
     boost::shared_ptr<xmlDoc> doc;
     std::list<ContactPtr> ordered_contacts;
     boost::shared_ptr<Ekiga::Settings> contacts_settings;
+    Ekiga::WriteBehind saving;
   };
 
   typedef boost::shared_ptr<Book> BookPtr;
@@ -51,6 +51,95 @@ struct null_deleter
     }
 };
 
+static void
+set_int_prop (xmlNodePtr node,
+	      const char* name,
+	      long value)
+{
+  gchar* tmp = g_strdup_printf ("%ld", value);
+  xmlSetProp (node, BAD_CAST name, BAD_CAST tmp);
+  g_free (tmp);
+}
+
+static void
+set_double_prop (xmlNodePtr node,
+		 const char* name,
+		 double value)
+{
+  gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+  g_ascii_formatd (buffer, sizeof (buffer), "%.2f", value);
+  xmlSetProp (node, BAD_CAST name, BAD_CAST buffer);
+}
+
+static double
+get_number_prop (xmlNodePtr node,
+		 const char* name)
+{
+  double result = 0;
+  xmlChar* xml_str = xmlGetProp (node, BAD_CAST name);
+
+  if (xml_str != NULL) {
+
+    result = g_ascii_strtod ((const char *) xml_str, NULL);
+    xmlFree (xml_str);
+  }
+
+  return result;
+}
+
+/* the summary of the media quality is an empty element with one
+ * attribute per figure
+ */
+static void
+quality_to_node (xmlNodePtr parent,
+		 const Ekiga::CallQualitySummary & quality)
+{
+  xmlNodePtr node = xmlNewChild (parent, NULL, BAD_CAST "quality", NULL);
+
+  set_int_prop (node, "samples", quality.samples);
+  set_int_prop (node, "jitter_p50", quality.jitter.p50);
+  set_int_prop (node, "jitter_p95", quality.jitter.p95);
+  set_int_prop (node, "jitter_p99", quality.jitter.p99);
+  set_int_prop (node, "remote_jitter_p50", quality.remote_jitter.p50);
+  set_int_prop (node, "remote_jitter_p95", quality.remote_jitter.p95);
+  set_int_prop (node, "remote_jitter_p99", quality.remote_jitter.p99);
+  set_int_prop (node, "loss_bursts", quality.loss_bursts);
+  set_int_prop (node, "longest_loss_burst", quality.longest_loss_burst);
+  set_int_prop (node, "lossy_samples", quality.lossy_samples);
+  set_double_prop (node, "received_fps_mean", quality.received_fps_mean);
+  set_double_prop (node, "received_fps_variance", quality.received_fps_variance);
+  set_double_prop (node, "transmitted_fps_mean", quality.transmitted_fps_mean);
+  set_double_prop (node, "transmitted_fps_variance", quality.transmitted_fps_variance);
+  set_int_prop (node, "transmitted_audio_bandwidth", quality.transmitted_audio_bandwidth);
+  set_int_prop (node, "received_audio_bandwidth", quality.received_audio_bandwidth);
+  set_int_prop (node, "transmitted_video_bandwidth", quality.transmitted_video_bandwidth);
+  set_int_prop (node, "received_video_bandwidth", quality.received_video_bandwidth);
+}
+
+static void
+quality_from_node (xmlNodePtr node,
+		   Ekiga::CallQualitySummary & quality)
+{
+  quality.samples = get_number_prop (node, "samples");
+  quality.jitter.p50 = get_number_prop (node, "jitter_p50");
+  quality.jitter.p95 = get_number_prop (node, "jitter_p95");
+  quality.jitter.p99 = get_number_prop (node, "jitter_p99");
+  quality.remote_jitter.p50 = get_number_prop (node, "remote_jitter_p50");
+  quality.remote_jitter.p95 = get_number_prop (node, "remote_jitter_p95");
+  quality.remote_jitter.p99 = get_number_prop (node, "remote_jitter_p99");
+  quality.loss_bursts = get_number_prop (node, "loss_bursts");
+  quality.longest_loss_burst = get_number_prop (node, "longest_loss_burst");
+  quality.lossy_samples = get_number_prop (node, "lossy_samples");
+  quality.received_fps_mean = get_number_prop (node, "received_fps_mean");
+  quality.received_fps_variance = get_number_prop (node, "received_fps_variance");
+  quality.transmitted_fps_mean = get_number_prop (node, "transmitted_fps_mean");
+  quality.transmitted_fps_variance = get_number_prop (node, "transmitted_fps_variance");
+  quality.transmitted_audio_bandwidth = get_number_prop (node, "transmitted_audio_bandwidth");
+  quality.received_audio_bandwidth = get_number_prop (node, "received_audio_bandwidth");
+  quality.transmitted_video_bandwidth = get_number_prop (node, "transmitted_video_bandwidth");
+  quality.received_video_bandwidth = get_number_prop (node, "received_video_bandwidth");
+}
+
 
 boost::shared_ptr<History::Contact>
 History::Contact::create (boost::shared_ptr<Ekiga::ContactCore> _contact_core,
@@ -68,9 +157,10 @@ History::Contact::create (boost::shared_ptr<Ekiga::ContactCore> _contact_core,
                           const std::string _uri,
                           time_t _call_start,
                           const std::string _call_duration,
-                          call_type c_t)
+                          call_type c_t,
+                          const Ekiga::CallQualitySummary & _quality)
 {
-  return boost::shared_ptr<History::Contact> (new History::Contact (_contact_core, _doc, _name, _uri, _call_start, _call_duration, c_t));
+  return boost::shared_ptr<History::Contact> (new History::Contact (_contact_core, _doc, _name, _uri, _call_start, _call_duration, c_t, _quality));
 }
 
 
@@ -125,6 +215,9 @@ History::Contact::Contact (boost::shared_ptr<Ekiga::ContactCore> _contact_core,
 	  call_duration = (const char *) xml_str;
         xmlFree (xml_str);
       }
+
+      if (xmlStrEqual (BAD_CAST ("quality"), child->name))
+        quality_from_node (child, quality);
     }
   }
 
@@ -141,9 +234,11 @@ History::Contact::Contact (boost::shared_ptr<Ekiga::ContactCore> _contact_core,
 			   const std::string _uri,
                            time_t _call_start,
                            const std::string _call_duration,
-			   call_type c_t):
+			   call_type c_t,
+			   const Ekiga::CallQualitySummary & _quality):
   contact_core(_contact_core), doc(_doc),
-  name(_name), uri(_uri), call_start(_call_start), call_duration(_call_duration), m_type(c_t)
+  name(_name), uri(_uri), call_start(_call_start), call_duration(_call_duration), m_type(c_t),
+  quality(_quality)
 {
   gchar* tmp = NULL;
   std::string callp;
@@ -163,6 +258,9 @@ History::Contact::Contact (boost::shared_ptr<Ekiga::ContactCore> _contact_core,
   xmlNewChild (node, NULL,
 	       BAD_CAST "call_duration", BAD_CAST call_duration.c_str ());
 
+  if (quality.samples > 0)
+    quality_to_node (node, quality);
+
   /* FIXME: I don't like the way it's done */
   tmp = g_strdup_printf ("%d", m_type);
   xmlSetProp (node, BAD_CAST "type", BAD_CAST tmp);
@@ -190,6 +288,16 @@ History::Contact::has_uri (const std::string uri_) const
   return uri == uri_;
 }
 
+const std::set<std::string>
+History::Contact::get_uris () const
+{
+  std::set<std::string> result;
+
+  result.insert (uri);
+
+  return result;
+}
+
 const std::set<std::string>
 History::Contact::get_groups () const
 {
@@ -237,6 +345,12 @@ History::Contact::get_call_duration () const
   return call_duration;
 }
 
+const Ekiga::CallQualitySummary &
+History::Contact::get_quality () const
+{
+  return quality;
+}
+
 const std::string
 History::Contact::get_uri () const
 {
@@ -41,6 +41,7 @@
 
 #include "services.h"
 #include "contact-core.h"
+#include "call-quality.h"
 #include "dynamic-object.h"
 
 namespace History
@@ -75,7 +76,8 @@ namespace History
                                               const std::string _uri,
                                               time_t call_start,
                                               const std::string call_duration,
-                                              call_type c_t);
+                                              call_type c_t,
+                                              const Ekiga::CallQualitySummary & quality = Ekiga::CallQualitySummary ());
 
     ~Contact ();
 
@@ -85,6 +87,8 @@ namespace History
 
     bool has_uri (const std::string uri_) const;
 
+    const std::set<std::string> get_uris () const;
+
     const std::set<std::string> get_groups () const;
 
 
@@ -97,6 +101,9 @@ namespace History
 
     const std::string get_call_duration () const;
 
+    /* samples is zero when no quality was recorded for the call */
+    const Ekiga::CallQualitySummary & get_quality () const;
+
     const std::string get_uri () const;
 
   private:
@@ -110,7 +117,8 @@ namespace History
 	     const std::string _uri,
              time_t call_start,
              const std::string call_duration,
-	     call_type c_t);
+	     call_type c_t,
+	     const Ekiga::CallQualitySummary & quality);
 
 
     boost::weak_ptr<Ekiga::ContactCore> contact_core;
@@ -122,6 +130,7 @@ namespace History
     time_t call_start;
     std::string call_duration;
     call_type m_type;
+    Ekiga::CallQualitySummary quality;
   };
 
   typedef boost::shared_ptr<Contact> ContactPtr;
@@ -70,6 +70,14 @@ struct HISTORYSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "HISTORY"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("contact-core");
+    result.push_back ("call-core");
+    return result;
+  }
+
   bool result;
 };
 
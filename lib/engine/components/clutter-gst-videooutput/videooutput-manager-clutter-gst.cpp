@@ -45,6 +45,7 @@
 #include "videooutput-core.h"
 #include "videooutput-manager-clutter-gst.h"
 #include "videoinput-info.h"
+#include "video-kernels.h"
 
 #include "runtime.h"
 
@@ -52,6 +53,10 @@
 GMVideoOutputManager_clutter_gst::GMVideoOutputManager_clutter_gst (G_GNUC_UNUSED Ekiga::ServiceCore & _core)
 {
   devices_nbr = 0;
+  composite = false;
+  pip = true;
+  self_view_width = 0;
+  self_view_height = 0;
 
   for (int i = 0 ; i < 3 ; i++) {
     texture[i] = NULL;
@@ -59,6 +64,12 @@ GMVideoOutputManager_clutter_gst::GMVideoOutputManager_clutter_gst (G_GNUC_UNUSE
     current_height[i] = 0;
     current_width[i] = 0;
   }
+
+  Ekiga::SettingsCallback setup_cb =
+    boost::bind (&GMVideoOutputManager_clutter_gst::setup, this, _1);
+  video_display_settings =
+    Ekiga::SettingsPtr (new Ekiga::Settings (VIDEO_DISPLAY_SCHEMA, setup_cb));
+  setup ();
 }
 
 
@@ -73,6 +84,19 @@ GMVideoOutputManager_clutter_gst::quit ()
 }
 
 
+void
+GMVideoOutputManager_clutter_gst::setup (const std::string & setting)
+{
+  PWaitAndSignal m(device_mutex);
+
+  if (setting.empty () || setting == "composite-pip")
+    composite = video_display_settings->get_bool ("composite-pip");
+
+  if (setting.empty () || setting == "enable-pip")
+    pip = video_display_settings->get_bool ("enable-pip");
+}
+
+
 void
 GMVideoOutputManager_clutter_gst::open ()
 {
@@ -181,6 +205,18 @@ GMVideoOutputManager_clutter_gst::set_frame_data (const char *data,
     return;
   }
 
+  if (composite && _devices_nbr > 1 && i == Ekiga::VideoOutputManager::LOCAL) {
+
+    update_self_view (data, width, height);
+    /* the local pipeline idles during the call, and the local stream
+     * gets announced again after it */
+    if (current_width[i] != 0)
+      gst_element_set_state (pipeline[i], GST_STATE_PAUSED);
+    current_width[i] = 0;
+    current_height[i] = 0;
+    return;
+  }
+
   if (current_width[i] != width || current_height[i] != height) {
     Ekiga::Runtime::run_in_main
       (boost::bind (&GMVideoOutputManager_clutter_gst::device_opened_in_main,
@@ -224,6 +260,8 @@ GMVideoOutputManager_clutter_gst::set_frame_data (const char *data,
   buffer = gst_buffer_new_and_alloc (buffer_size);
   gst_buffer_map (buffer, &info, GST_MAP_WRITE);
   memcpy ((void *) info.data, (const void *) data, buffer_size);
+  if (composite && _devices_nbr > 1 && i == Ekiga::VideoOutputManager::REMOTE)
+    draw_self_view ((char *) info.data, width, height);
   info.size = buffer_size;
   gst_buffer_unmap (buffer, &info);
   gst_app_src_push_buffer (GST_APP_SRC (appsrc), buffer);
@@ -232,6 +270,68 @@ GMVideoOutputManager_clutter_gst::set_frame_data (const char *data,
 }
 
 
+void
+GMVideoOutputManager_clutter_gst::update_self_view (const char *data,
+                                                    unsigned width,
+                                                    unsigned height)
+{
+  /* a quarter of the width of the remote video, as the call window does */
+  unsigned target_width = (current_width[Ekiga::VideoOutputManager::REMOTE] / 4) & ~1u;
+  unsigned target_height = 0;
+
+  if (target_width > 0 && width > 0)
+    target_height = (height * target_width / width) & ~1u;
+
+  if (!pip || target_width < 2 || target_height < 2) {
+
+    self_view_width = 0;
+    self_view_height = 0;
+    return;
+  }
+
+  Ekiga::VideoKernels::ConstI420 source (data, width, height);
+
+  /* bilinear scaling only looks at the four nearest pixels: average the
+   * picture down first when it is much larger than the result */
+  if (width >= 2 * target_width && height >= 2 * target_height) {
+
+    half_frame.resize ((width / 2) * (height / 2) * 3 / 2);
+    Ekiga::VideoKernels::I420 half (&half_frame[0], width / 2, height / 2);
+    Ekiga::VideoKernels::halve (source, half);
+    source = half;
+  }
+
+  self_view.resize (target_width * target_height * 3 / 2);
+  Ekiga::VideoKernels::scale (source,
+                              Ekiga::VideoKernels::I420 (&self_view[0],
+                                                         target_width,
+                                                         target_height));
+  self_view_width = target_width;
+  self_view_height = target_height;
+}
+
+
+void
+GMVideoOutputManager_clutter_gst::draw_self_view (char *frame,
+                                                  unsigned width,
+                                                  unsigned height)
+{
+  const int margin = (width / 40) & ~1u;
+
+  /* a self view made for another size of remote video would look odd:
+   * wait for the next local frame */
+  if (!pip || self_view_width == 0 || self_view_width != ((width / 4) & ~1u))
+    return;
+
+  Ekiga::VideoKernels::blit (Ekiga::VideoKernels::ConstI420 (&self_view[0],
+                                                            self_view_width,
+                                                            self_view_height),
+                             Ekiga::VideoKernels::I420 (frame, width, height),
+                             margin,
+                             (int) height - (int) self_view_height - margin);
+}
+
+
 void
 GMVideoOutputManager_clutter_gst::set_display_info (const gpointer _local_video,
                                                     const gpointer _remote_video)
@@ -39,6 +39,9 @@
 
 #include "services.h"
 #include "videooutput-manager.h"
+#include "ekiga-settings.h"
+
+#include <vector>
 
 #include <glib.h>
 
@@ -72,6 +75,20 @@ public:
   void set_ext_display_info (const gpointer ext_video);
 
 private:
+  void setup (const std::string & setting = "");
+
+  /* In the composite mode, during calls, the local video isn't displayed
+   * as a stream of its own: a small copy of it is drawn into each remote
+   * frame, bottom left like the picture-in-picture of the call window.
+   */
+  void update_self_view (const char *data,
+                         unsigned width,
+                         unsigned height);
+
+  void draw_self_view (char *frame,
+                       unsigned width,
+                       unsigned height);
+
   void size_changed_in_main (Ekiga::VideoOutputManager::VideoView type,
                              unsigned width,
 			     unsigned height);
@@ -96,6 +113,15 @@ private:
   ClutterActor *texture[3];
 
   int devices_nbr;
+
+  Ekiga::SettingsPtr video_display_settings;
+  bool composite;
+  bool pip;
+
+  std::vector<char> half_frame;
+  std::vector<char> self_view;
+  unsigned self_view_width;
+  unsigned self_view_height;
 };
 
 /**
@@ -71,6 +71,15 @@ struct GUDevSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "GUDEV"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("hal-core");
+    result.push_back ("audioinput-core");
+    result.push_back ("audiooutput-core");
+    return result;
+  }
+
   bool result;
 };
 
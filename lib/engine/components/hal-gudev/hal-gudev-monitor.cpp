@@ -35,7 +35,16 @@
  */
 
 #include "hal-gudev-monitor.h"
-#include <algorithm>
+
+#include <stdio.h>
+#include <string.h>
+
+/* how long (in ms) we wait for the sound uevents to stop coming */
+#define SOUND_SETTLE_DELAY 500
+
+/* PTLIB names its ALSA devices after the short names of the cards */
+#define ALSA_SOURCE "ALSA"
+#define ALSA_CARDS "/proc/asound/cards"
 
 #if DEBUG
 static void
@@ -70,15 +79,38 @@ gudev_monitor_uevent_handler (G_GNUC_UNUSED GUdevClient* client,
 }
 
 
+gboolean
+gudev_monitor_sound_settled (gpointer data)
+{
+  GUDevMonitor* monitor = (GUDevMonitor*) data;
+
+  monitor->sound_timeout = 0;
+  monitor->sound_devices_changed ();
+
+  return FALSE;
+}
+
+
+gboolean
+gudev_monitor_take_baseline (gpointer data)
+{
+  GUDevMonitor* monitor = (GUDevMonitor*) data;
+
+  monitor->baseline_id = 0;
+  monitor->take_baseline ();
+
+  return FALSE;
+}
+
+
 GUDevMonitor::GUDevMonitor (boost::shared_ptr<Ekiga::AudioInputCore> _audioinput_core,
                             boost::shared_ptr<Ekiga::AudioOutputCore> _audiooutput_core)
         : audioinput_core(_audioinput_core), audiooutput_core(_audiooutput_core)
 {
   const gchar* subsystems[] = { "video4linux", "sound", NULL};
   client = g_udev_client_new (subsystems);
-
-  _audioinput_core->get_devices (audio_input_devices);
-  _audiooutput_core->get_devices (audio_output_devices);
+  sound_timeout = 0;
+  baseline_id = g_idle_add (gudev_monitor_take_baseline, this);
 
   g_signal_connect (G_OBJECT (client), "uevent",
 		    G_CALLBACK (gudev_monitor_uevent_handler), this);
@@ -87,6 +119,10 @@ GUDevMonitor::GUDevMonitor (boost::shared_ptr<Ekiga::AudioInputCore> _audioinput
 
 GUDevMonitor::~GUDevMonitor ()
 {
+  if (sound_timeout != 0)
+    g_source_remove (sound_timeout);
+  if (baseline_id != 0)
+    g_source_remove (baseline_id);
   g_object_unref (client);
 }
 
@@ -128,58 +164,295 @@ GUDevMonitor::device_change (GUdevDevice* device,
     }
   }
   else if (g_str_equal (subsystem, "sound")) {
-    // Audio device detected
-    std::vector<std::string> new_audio_input_devices;
-    std::vector<std::string> new_audio_output_devices;
-    boost::shared_ptr<Ekiga::AudioInputCore> aicore = audioinput_core.lock ();
-    boost::shared_ptr<Ekiga::AudioOutputCore> aocore = audiooutput_core.lock ();
-    Ekiga::Device dev;
-    if (!aicore || !aocore)
-      return;
-
-    aicore->get_devices (new_audio_input_devices);
-    aocore->get_devices (new_audio_output_devices);
-
-    std::vector<std::string>::iterator iter;
-    // This is awful with an exploding O complexity. I'm ashamed.
-    for (iter = new_audio_input_devices.begin ();
-         iter != new_audio_input_devices.end ();
-         ++iter) {
-      std::vector<std::string>::iterator it = std::find (audio_input_devices.begin (), audio_input_devices.end (), (*iter));
-      if (it == audio_input_devices.end () && !(*iter).empty ()) {
-        if (add) {
-          dev.SetFromString (*iter);
-          audioinput_device_added (dev.source, dev.name);
-        }
-        break;
+
+    /* a card comes with its controls and pcms : only the card itself
+     * matters, the others just make the burst longer
+     */
+    int number = -1;
+    const char* name = g_udev_device_get_name (device);
+    if ((add || remove)
+        && name != NULL && sscanf (name, "card%d", &number) == 1 && number >= 0)
+      card_events.push_back (std::make_pair (number, (bool) add));
+
+    if (sound_timeout != 0)
+      g_source_remove (sound_timeout);
+    sound_timeout = g_timeout_add (SOUND_SETTLE_DELAY, gudev_monitor_sound_settled, this);
+  }
+}
+
+
+/* Reads the short name of a card from the ALSA list, and whether it can
+ * capture and play from its pcms : that is all we need to know which
+ * devices it brings, without probing the sound servers again.
+ */
+static bool
+read_card (int number,
+           std::string& name,
+           bool& capture,
+           bool& playback)
+{
+  gchar* contents = NULL;
+  gchar** lines = NULL;
+  gchar* path = NULL;
+  GDir* dir = NULL;
+  const gchar* entry = NULL;
+  bool found = false;
+
+  if (!g_file_get_contents (ALSA_CARDS, &contents, NULL, NULL))
+    return false;
+
+  // the first line of a card reads : " 0 [PCH            ]: HDA-Intel - HDA Intel PCH"
+  lines = g_strsplit (contents, "\n", -1);
+  for (int ii = 0; lines[ii] != NULL && !found; ii++) {
+
+    int line_number = -1;
+    const gchar* separator = strstr (lines[ii], "]: ");
+    if (separator != NULL && sscanf (lines[ii], " %d [", &line_number) == 1 && line_number == number) {
+
+      separator = strstr (separator, " - ");
+      if (separator != NULL) {
+
+        gchar* short_name = g_strstrip (g_strdup (separator + 3));
+        name = short_name;
+        found = !name.empty ();
+        g_free (short_name);
       }
-      else
-        audio_input_devices.erase (it);
     }
-    if (remove && audio_input_devices.size () > 0) {
-      dev.SetFromString (audio_input_devices[0]);
-      audioinput_device_removed (dev.source, dev.name);
+  }
+  g_strfreev (lines);
+  g_free (contents);
+
+  if (!found)
+    return false;
+
+  capture = false;
+  playback = false;
+  path = g_strdup_printf ("/proc/asound/card%d", number);
+  dir = g_dir_open (path, 0, NULL);
+  if (dir != NULL) {
+
+    while ((entry = g_dir_read_name (dir)) != NULL)
+      if (g_str_has_prefix (entry, "pcm")) {
+
+        capture = capture || g_str_has_suffix (entry, "c");
+        playback = playback || g_str_has_suffix (entry, "p");
+      }
+    g_dir_close (dir);
+  }
+  g_free (path);
+
+  return true;
+}
+
+
+/* the known devices are keyed by source and name : that is what the
+ * uevents let us rebuild
+ */
+static std::string
+device_key (const std::string& source,
+            const std::string& name)
+{
+  return source + "/" + name;
+}
+
+
+static void
+insert_devices (const std::vector<std::string>& devices,
+                boost::unordered_set<std::string>& result)
+{
+  Ekiga::Device dev;
+
+  for (std::vector<std::string>::const_iterator iter = devices.begin ();
+       iter != devices.end ();
+       ++iter)
+    if (!iter->empty ()) {
+
+      dev.SetFromString (*iter);
+      result.insert (device_key (dev.source, dev.name));
     }
-    audio_input_devices = new_audio_input_devices;
-
-    for (iter = new_audio_output_devices.begin ();
-         iter != new_audio_output_devices.end ();
-         ++iter) {
-      std::vector<std::string>::iterator it = std::find (audio_output_devices.begin (), audio_output_devices.end (), (*iter));
-      if (it == audio_output_devices.end () && !(*iter).empty ()) {
-        if (add) {
-          dev.SetFromString (*iter);
-          audiooutput_device_added (dev.source, dev.name);
-        }
-        break;
+}
+
+
+void
+GUDevMonitor::take_baseline ()
+{
+  std::vector<std::string> devices;
+  boost::shared_ptr<Ekiga::AudioInputCore> aicore = audioinput_core.lock ();
+  boost::shared_ptr<Ekiga::AudioOutputCore> aocore = audiooutput_core.lock ();
+
+  if (aicore) {
+
+    aicore->get_devices (devices);
+    insert_devices (devices, audio_input_devices);
+  }
+  if (aocore) {
+
+    aocore->get_devices (devices);
+    insert_devices (devices, audio_output_devices);
+  }
+
+  // the cards present now will be known by number when they go
+  for (int number = 0; number < MAX_SOUND_CARDS; number++) {
+
+    SoundCard card;
+    if (read_card (number, card.name, card.capture, card.playback))
+      cards[number] = card;
+  }
+}
+
+
+/* Applies the burst of card additions and removals to what we know,
+ * telling the cores which devices came and went : they update their
+ * caches from that. Only when a card can't be told apart by its name do
+ * we probe everything again.
+ */
+void
+GUDevMonitor::sound_devices_changed ()
+{
+  std::list<std::pair<int, bool> > events;
+  bool rescan = false;
+
+  if (baseline_id != 0) {
+
+    g_source_remove (baseline_id);
+    baseline_id = 0;
+    take_baseline ();
+  }
+
+  events.swap (card_events);
+  for (std::list<std::pair<int, bool> >::const_iterator iter = events.begin ();
+       iter != events.end ();
+       ++iter) {
+
+    if (iter->second) {
+
+      SoundCard card;
+      if (!read_card (iter->first, card.name, card.capture, card.playback)
+          || (card.capture && audio_input_devices.count (device_key (ALSA_SOURCE, card.name)))
+          || (card.playback && audio_output_devices.count (device_key (ALSA_SOURCE, card.name)))) {
+
+        // gone already, or PTLIB will have given it another name
+        rescan = true;
+        continue;
+      }
+
+      cards[iter->first] = card;
+      if (card.capture) {
+
+        audio_input_devices.insert (device_key (ALSA_SOURCE, card.name));
+        audioinput_device_added (ALSA_SOURCE, card.name);
+      }
+      if (card.playback) {
+
+        audio_output_devices.insert (device_key (ALSA_SOURCE, card.name));
+        audiooutput_device_added (ALSA_SOURCE, card.name);
       }
-      else
-        audio_output_devices.erase (it);
     }
-    if (remove && audio_output_devices.size () > 0) {
-      dev.SetFromString (audio_output_devices[0]);
-      audiooutput_device_removed (dev.source, dev.name);
+    else {
+
+      std::map<int, SoundCard>::iterator card = cards.find (iter->first);
+      if (card == cards.end ()) {
+
+        rescan = true;
+        continue;
+      }
+
+      if (audio_input_devices.erase (device_key (ALSA_SOURCE, card->second.name)))
+        audioinput_device_removed (ALSA_SOURCE, card->second.name);
+      if (audio_output_devices.erase (device_key (ALSA_SOURCE, card->second.name)))
+        audiooutput_device_removed (ALSA_SOURCE, card->second.name);
+      cards.erase (card);
     }
-    audio_output_devices = new_audio_output_devices;
+  }
+
+  if (rescan)
+    rescan_sound_devices ();
+}
+
+
+/* puts in result what is in devices but not in known */
+static void
+diff_devices (const boost::unordered_set<std::string>& devices,
+              const boost::unordered_set<std::string>& known,
+              std::vector<std::string>& result)
+{
+  for (boost::unordered_set<std::string>::const_iterator iter = devices.begin ();
+       iter != devices.end ();
+       ++iter)
+    if (known.find (*iter) == known.end ())
+      result.push_back (*iter);
+}
+
+
+/* splits a device key back */
+static void
+split_key (const std::string& key,
+           std::string& source,
+           std::string& name)
+{
+  std::string::size_type separator = key.find ('/');
+
+  source = key.substr (0, separator);
+  name = key.substr (separator + 1);
+}
+
+
+void
+GUDevMonitor::rescan_sound_devices ()
+{
+  std::vector<std::string> devices;
+  std::vector<std::string> added;
+  std::vector<std::string> removed;
+  std::string source;
+  std::string name;
+  boost::shared_ptr<Ekiga::AudioInputCore> aicore = audioinput_core.lock ();
+  boost::shared_ptr<Ekiga::AudioOutputCore> aocore = audiooutput_core.lock ();
+  if (!aicore || !aocore)
+    return;
+
+  cards.clear ();
+  for (int number = 0; number < MAX_SOUND_CARDS; number++) {
+
+    SoundCard card;
+    if (read_card (number, card.name, card.capture, card.playback))
+      cards[number] = card;
+  }
+
+  aicore->refresh_devices ();
+  aicore->get_devices (devices);
+  {
+    device_set new_devices;
+    insert_devices (devices, new_devices);
+    diff_devices (new_devices, audio_input_devices, added);
+    diff_devices (audio_input_devices, new_devices, removed);
+    audio_input_devices.swap (new_devices);
+  }
+  for (std::vector<std::string>::const_iterator iter = added.begin (); iter != added.end (); ++iter) {
+    split_key (*iter, source, name);
+    audioinput_device_added (source, name);
+  }
+  for (std::vector<std::string>::const_iterator iter = removed.begin (); iter != removed.end (); ++iter) {
+    split_key (*iter, source, name);
+    audioinput_device_removed (source, name);
+  }
+
+  added.clear ();
+  removed.clear ();
+  aocore->refresh_devices ();
+  aocore->get_devices (devices);
+  {
+    device_set new_devices;
+    insert_devices (devices, new_devices);
+    diff_devices (new_devices, audio_output_devices, added);
+    diff_devices (audio_output_devices, new_devices, removed);
+    audio_output_devices.swap (new_devices);
+  }
+  for (std::vector<std::string>::const_iterator iter = added.begin (); iter != added.end (); ++iter) {
+    split_key (*iter, source, name);
+    audiooutput_device_added (source, name);
+  }
+  for (std::vector<std::string>::const_iterator iter = removed.begin (); iter != removed.end (); ++iter) {
+    split_key (*iter, source, name);
+    audiooutput_device_removed (source, name);
   }
 }
@@ -43,6 +43,13 @@
 #include "audiooutput-core.h"
 
 #include <gudev/gudev.h>
+#include <boost/unordered_set.hpp>
+
+#include <list>
+#include <map>
+
+/* as many as ALSA can have */
+#define MAX_SOUND_CARDS 32
 
 class GUDevMonitor:
   public Ekiga::Service,
@@ -74,12 +81,40 @@ private:
   void device_change (GUdevDevice* device,
                       const gchar* action);
 
+  /* A sound card comes with a burst of uevents : we wait for the burst to
+   * be over, then apply the cards which came and went to the devices we
+   * know, and to the caches of the cores through the hal signals. Probing
+   * all the audio devices again is only for when that isn't enough.
+   */
+  friend gboolean gudev_monitor_sound_settled (gpointer data);
+  void sound_devices_changed ();
+  void rescan_sound_devices ();
+
+  /* The devices known when we start, to compare with : they are read once
+   * the main loop runs, from the lists the engine probed in the background,
+   * instead of probing them again while the engine starts.
+   */
+  friend gboolean gudev_monitor_take_baseline (gpointer data);
+  void take_baseline ();
+
   GUdevClient* client;
+  guint sound_timeout;
+  guint baseline_id;
+
+  struct SoundCard
+  {
+    std::string name;
+    bool capture;
+    bool playback;
+  };
+  std::map<int, SoundCard> cards; // by number, to know what goes away
+  std::list<std::pair<int, bool> > card_events; // number, added, during the burst
 
   boost::weak_ptr<Ekiga::AudioInputCore> audioinput_core;
   boost::weak_ptr<Ekiga::AudioOutputCore> audiooutput_core;
-  std::vector<std::string> audio_input_devices;
-  std::vector<std::string> audio_output_devices;
+  typedef boost::unordered_set<std::string> device_set; // "source/name"
+  device_set audio_input_devices;
+  device_set audio_output_devices;
 };
 
 #endif
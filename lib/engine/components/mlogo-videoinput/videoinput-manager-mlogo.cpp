@@ -38,6 +38,7 @@
 #include <glib.h>
 
 #include "runtime.h"
+#include "video-kernels.h"
 
 #include "pixmaps/icon.h"
 
@@ -90,14 +91,10 @@ bool GMVideoInputManager_mlogo::open (unsigned width, unsigned height, unsigned
   increment = 1;
 
   background_frame = (char*) malloc ((current_state.width * current_state.height * 3) >> 1);
-  memset (background_frame, 0, current_state.width*current_state.height); //ff
-  memset (background_frame + (current_state.width * current_state.height),
-          0x7f,
-          (current_state.width*current_state.height) >> 2);
-  memset (background_frame + (current_state.width * current_state.height) +
-                            ((current_state.width * current_state.height) >> 2),
-          0x7f,
-          (current_state.width*current_state.height) >> 2);
+  Ekiga::VideoKernels::fill (Ekiga::VideoKernels::I420 (background_frame,
+                                                       current_state.width,
+                                                       current_state.height),
+                             0, 0x7f, 0x7f);
 
   adaptive_delay.Restart ();
   adaptive_delay.SetMaximumSlip ((unsigned)(500.0 / fps));
@@ -134,12 +131,13 @@ bool GMVideoInputManager_mlogo::get_frame_data (char *data)
 
   memcpy (data, background_frame, (current_state.width * current_state.height * 3) >> 1);
 
-  CopyYUVArea  ((char*)&gm_icon_yuv,
-                gm_icon_width, gm_icon_height,
-                data,
-                (current_state.width - gm_icon_width) >> 1,
-                moving ? pos : (int) (current_state.height - gm_icon_height) / 2,
-                current_state.width, current_state.height);
+  Ekiga::VideoKernels::blit (Ekiga::VideoKernels::ConstI420 ((const char*) &gm_icon_yuv,
+                                                            gm_icon_width, gm_icon_height),
+                             Ekiga::VideoKernels::I420 (data,
+                                                        current_state.width,
+                                                        current_state.height),
+                             (current_state.width - gm_icon_width) >> 1,
+                             moving ? pos : (int) (current_state.height - gm_icon_height) / 2);
   pos = pos + increment;
 
   if (pos > current_state.height - gm_icon_height - 10)
@@ -150,53 +148,6 @@ bool GMVideoInputManager_mlogo::get_frame_data (char *data)
   return true;
 }
 
-void GMVideoInputManager_mlogo::CopyYUVArea (const char* srcFrame,
-                                             unsigned srcWidth,
-                                             unsigned srcHeight,
-                                             char* dstFrame,
-                                             unsigned dstX,
-                                             unsigned dstY,
-                                             unsigned dstWidth,
-                                             unsigned dstHeight)
-{
-  unsigned line = 0;
-//Y
-  dstFrame += dstY * dstWidth;
-  for (line = 0; line<srcHeight; line++) {
-    if (dstY + line < dstHeight)
-      memcpy (dstFrame + dstX, srcFrame, srcWidth);
-    srcFrame += srcWidth;
-    dstFrame += dstWidth;
-  }
-  dstFrame += (dstHeight - dstY - srcHeight)* dstWidth;
-
-  dstY = dstY >> 1;
-  dstX = dstX >> 1;
-  srcWidth  = srcWidth >> 1;
-  srcHeight = srcHeight >> 1;
-  dstWidth  = dstWidth >> 1;
-  dstHeight = dstHeight >> 1;
-
-//U
-  dstFrame += dstY * dstWidth;
-  for (line = 0; line<srcHeight; line++) {
-    if (dstY + line < dstHeight)
-      memcpy (dstFrame + dstX, srcFrame , srcWidth);
-    srcFrame += srcWidth;
-    dstFrame += dstWidth;
-  }
-  dstFrame += (dstHeight - dstY - srcHeight)* dstWidth;
-
-//V
-  dstFrame += dstY * dstWidth;
-  for (line = 0; line<srcHeight; line++) {
-    if (dstY + line < dstHeight)
-      memcpy (dstFrame + dstX, srcFrame , srcWidth);
-    srcFrame += srcWidth;
-    dstFrame += dstWidth;
-  }
-}
-
 bool GMVideoInputManager_mlogo::has_device (const std::string & /*source*/,
                                             const std::string & /*device_name*/,
                                             unsigned /*capabilities*/,
@@ -77,15 +77,6 @@
 			       Ekiga::VideoInputDevice & device);
 
   protected:
-      void CopyYUVArea (const char* srcFrame,
-			unsigned srcWidth,
-			unsigned srcHeight,
-			char* dstFrame,
-			unsigned dstX,
-			unsigned dstY,
-			unsigned dstWidth,
-			unsigned dstHeight);
-
       char* background_frame;
       unsigned pos;
       unsigned increment;
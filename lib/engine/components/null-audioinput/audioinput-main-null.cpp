@@ -69,6 +69,13 @@ struct NULLAUDIOINPUTSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "NULLAUDIOINPUT"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("audioinput-core");
+    return result;
+  }
+
   bool result;
 };
 
@@ -69,6 +69,13 @@ struct NULLAUDIOOUTPUTSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "NULLAUDIOOUTPUT"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("audiooutput-core");
+    return result;
+  }
+
   bool result;
 };
 
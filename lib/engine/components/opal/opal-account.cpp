@@ -41,6 +41,8 @@
 #include <glib.h>
 #include <glib/gi18n.h>
 
+#include <libxml/parser.h>
+
 #include <ptlib.h>
 #include <ptclib/guid.h>
 
@@ -77,6 +79,40 @@ canonize_uri (std::string uri)
   return uri;
 }
 
+static std::string
+presentity_key (boost::shared_ptr<Opal::Presentity> pres)
+{
+  return Opal::index_key (pres->get_uri ());
+}
+
+struct find_presentity_helper
+{
+  find_presentity_helper (const std::string uri_): uri(uri_)
+  {}
+
+  bool operator() (Opal::PresentityPtr pres)
+  {
+    if (pres->get_uri () == uri)
+      result = pres;
+
+    return !result;
+  }
+
+  std::string uri;
+  Opal::PresentityPtr result;
+};
+
+static bool
+set_presence_and_note (boost::shared_ptr<Opal::Presentity> pres,
+                       const std::string presence,
+                       const std::string note)
+{
+  pres->set_presence (presence);
+  pres->set_note (note);
+
+  return true;
+}
+
 
 xmlNodePtr
 Opal::Account::build_node(Opal::Account::Type typus,
@@ -205,7 +241,12 @@ Opal::Account::Account (Opal::Bank & _bank,
   message_waiting_number = 0;
   failed_registration_already_notified = false;
   dead = false;
+  presence_list_active = false;
+  presence_updates_scheduled = false;
 
+  presentities.set_key (boost::bind (&presentity_key, _1));
+
+  load_config ();
   decide_type ();
 
   for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
@@ -295,28 +336,101 @@ Opal::Account::get_groups () const
 }
 
 
-const std::string
-Opal::Account::get_name () const
+boost::shared_ptr<const Opal::Account::Config>
+Opal::Account::get_config () const
 {
-  std::string result;
+  PWaitAndSignal m(config_mutex);
+
+  return config;
+}
+
+
+void
+Opal::Account::load_config ()
+{
+  boost::shared_ptr<Config> new_config (new Config);
   xmlChar* xml_str = NULL;
 
-  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+  new_config->protocol_name = "SIP";
+  xml_str = xmlGetProp (node, BAD_CAST "type");
+  if (xml_str != NULL) {
+
+    new_config->protocol_name = (const char*)xml_str;
+    xmlFree (xml_str);
+    if (new_config->protocol_name.compare ("Ekiga") == 0 || new_config->protocol_name.compare ("DiamondCard") == 0)
+      new_config->protocol_name = "SIP";
+  }
 
-    if (child->type == XML_ELEMENT_NODE && child->name != NULL && xmlStrEqual (BAD_CAST "name", child->name)) {
+  new_config->timeout = 0;
+  xml_str = xmlGetProp (node, BAD_CAST "timeout");
+  if (xml_str != NULL) {
 
-      xml_str = xmlNodeGetContent (child);
-      if (xml_str != NULL) {
+    new_config->timeout = std::strtoul ((const char*)xml_str, NULL, 0);
+    xmlFree (xml_str);
+  }
 
-        result = (const char*)xml_str;
-        xmlFree (xml_str);
-      } else {
-        result = _("Unnamed");
-      }
+  xml_str = xmlGetProp (node, BAD_CAST "presence_list");
+  if (xml_str != NULL) {
+
+    new_config->presence_list = (const char*)xml_str;
+    xmlFree (xml_str);
+  }
+
+  new_config->enabled = false;
+  xml_str = xmlGetProp (node, BAD_CAST "enabled");
+  if (xml_str != NULL) {
+
+    new_config->enabled = xmlStrEqual (xml_str, BAD_CAST "true");
+    xmlFree (xml_str);
+  }
+
+  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+
+    if (child->type != XML_ELEMENT_NODE || child->name == NULL)
+      continue;
+
+    std::string* field = NULL;
+    if (xmlStrEqual (BAD_CAST "name", child->name))
+      field = &new_config->name;
+    else if (xmlStrEqual (BAD_CAST "host", child->name))
+      field = &new_config->host;
+    else if (xmlStrEqual (BAD_CAST "outbound_proxy", child->name))
+      field = &new_config->outbound_proxy;
+    else if (xmlStrEqual (BAD_CAST "user", child->name))
+      field = &new_config->user;
+    else if (xmlStrEqual (BAD_CAST "auth_user", child->name))
+      field = &new_config->auth_user;
+    else if (xmlStrEqual (BAD_CAST "password", child->name))
+      field = &new_config->password;
+
+    if (field == NULL)
+      continue;
+
+    xml_str = xmlNodeGetContent (child);
+    if (xml_str != NULL) {
+
+      *field = (const char*)xml_str;
+      xmlFree (xml_str);
+    }
+    else if (field == &new_config->name) {
+
+      *field = _("Unnamed");
     }
   }
 
-  return result;
+  new_config->aor = (new_config->protocol_name == "SIP" ? "sip:" : "h323:") + new_config->user;
+  if (new_config->user.find ("@") == string::npos)
+    new_config->aor += "@" + new_config->host;
+
+  PWaitAndSignal m(config_mutex);
+  config = new_config;
+}
+
+
+const std::string
+Opal::Account::get_name () const
+{
+  return get_config ()->name;
 }
 
 const std::string
@@ -352,162 +466,55 @@ Opal::Account::get_state () const
 const std::string
 Opal::Account::get_aor () const
 {
-  std::stringstream str;
-
-  str << (get_protocol_name () == "SIP" ? "sip:" : "h323:") << get_username ();
-
-  if (get_username ().find ("@") == string::npos)
-    str << "@" << get_host ();
-
-  return str.str ();
+  return get_config ()->aor;
 }
 
 const std::string
 Opal::Account::get_protocol_name () const
 {
-  std::string result = "SIP";
-  xmlChar* xml_str = xmlGetProp (node, BAD_CAST "type");
-
-  if (xml_str != NULL) {
-
-    result = (const char*)xml_str;
-    xmlFree (xml_str);
-    if (result.compare ("Ekiga") == 0 || result.compare ("DiamondCard") == 0)
-      result = "SIP";
-  }
-
-  return result;
+  return get_config ()->protocol_name;
 }
 
 
 const std::string
 Opal::Account::get_host () const
 {
-  std::string result;
-  xmlChar* xml_str = NULL;
-
-  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
-
-    if (child->type == XML_ELEMENT_NODE && child->name != NULL && xmlStrEqual (BAD_CAST "host", child->name)) {
-
-      xml_str = xmlNodeGetContent (child);
-      if (xml_str != NULL) {
-
-        result = (const char*)xml_str;
-        xmlFree (xml_str);
-      }
-    }
-  }
-
-  return result;
+  return get_config ()->host;
 }
 
 
 const std::string
 Opal::Account::get_outbound_proxy () const
 {
-  std::string result;
-  xmlChar* xml_str = NULL;
-
-  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
-
-    if (child->type == XML_ELEMENT_NODE && child->name != NULL && xmlStrEqual (BAD_CAST "outbound_proxy", child->name)) {
-
-      xml_str = xmlNodeGetContent (child);
-      if (xml_str != NULL) {
-
-        result = (const char*)xml_str;
-        xmlFree (xml_str);
-      }
-    }
-  }
-
-  return result;
+  return get_config ()->outbound_proxy;
 }
 
 
 const std::string
 Opal::Account::get_username () const
 {
-  std::string result;
-  xmlChar* xml_str = NULL;
-
-  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
-
-    if (child->type == XML_ELEMENT_NODE && child->name != NULL && xmlStrEqual (BAD_CAST "user", child->name)) {
-
-      xml_str = xmlNodeGetContent (child);
-      if (xml_str != NULL) {
-
-        result = (const char*)xml_str;
-        xmlFree (xml_str);
-      }
-    }
-  }
-
-  return result;
+  return get_config ()->user;
 }
 
 
 const std::string
 Opal::Account::get_authentication_username () const
 {
-  std::string result;
-  xmlChar* xml_str = NULL;
-
-  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
-
-    if (child->type == XML_ELEMENT_NODE && child->name != NULL && xmlStrEqual (BAD_CAST "auth_user", child->name)) {
-
-      xml_str = xmlNodeGetContent (child);
-      if (xml_str != NULL) {
-
-        result = (const char*)xml_str;
-        xmlFree (xml_str);
-      }
-    }
-  }
-
-  return result;
+  return get_config ()->auth_user;
 }
 
 
 const std::string
 Opal::Account::get_password () const
 {
-  std::string result;
-  xmlChar* xml_str = NULL;
-
-  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
-
-    if (child->type == XML_ELEMENT_NODE && child->name != NULL && xmlStrEqual (BAD_CAST "password", child->name)) {
-
-      xml_str = xmlNodeGetContent (child);
-      if (xml_str != NULL) {
-
-        result = (const char*)xml_str;
-        xmlFree (xml_str);
-      }
-    }
-  }
-
-  return result;
+  return get_config ()->password;
 }
 
 
 unsigned
 Opal::Account::get_timeout () const
 {
-  unsigned result = 0;
-  xmlChar* xml_str = xmlGetProp (node, BAD_CAST "timeout");
-
-  if (xml_str != NULL) {
-
-    result = std::strtoul ((const char*)xml_str, NULL, 0);
-    xmlFree (xml_str);
-  }
-
-  return result;
+  return get_config ()->timeout;
 }
 
 
@@ -527,6 +534,7 @@ Opal::Account::set_authentication_settings (const std::string& username,
         robust_xmlNodeSetContent (node, &child, "password", password);
     }
   }
+  load_config ();
 
   enable ();
 }
@@ -538,6 +546,7 @@ Opal::Account::enable ()
   PString _aor;
   if (!is_enabled ()) {
     xmlSetProp (node, BAD_CAST "enabled", BAD_CAST "true");
+    load_config ();
     trigger_saving ();
   }
 
@@ -572,6 +581,7 @@ Opal::Account::disable ()
 {
   if (is_enabled ()) {
     xmlSetProp (node, BAD_CAST "enabled", BAD_CAST "false");
+    load_config ();
     trigger_saving ();
   }
 
@@ -597,6 +607,7 @@ Opal::Account::disable ()
       if (type != Account::H323 && sip_endpoint)
         sip_endpoint->Unsubscribe (SIPSubscribe::MessageSummary, get_full_uri (get_aor ()));
 
+      unsubscribe_presence_list ();
       opal_presentity->Close ();
     }
     if (sip_endpoint) {
@@ -621,19 +632,7 @@ Opal::Account::disable ()
 bool
 Opal::Account::is_enabled () const
 {
-  bool result = false;
-  xmlChar* xml_str = xmlGetProp (node, BAD_CAST "enabled");
-
-  if (xml_str != NULL) {
-
-    if (xmlStrEqual (xml_str, BAD_CAST "true"))
-      result = true;
-    else
-      result = false;
-    xmlFree (xml_str);
-  }
-
-  return result;
+  return get_config ()->enabled;
 }
 
 
@@ -748,6 +747,10 @@ Opal::Account::edit ()
                    Ekiga::FormVisitor::PASSWORD, false, false);
     request->text ("outbound_proxy", _("Outbound _Proxy"), get_outbound_proxy (), _("proxy.company.com"),
                    Ekiga::FormVisitor::STANDARD, true, true);
+    /* Translators: a RFC 4662 resource list, through which the presence of
+     * all contacts is watched with a single subscription */
+    request->text ("presence_list", _("Presence _List"), get_config ()->presence_list, _("sip:jon-buddies@ekiga.net"),
+                   Ekiga::FormVisitor::URI, true, true);
     request->text ("timeout", _("_Timeout"), "3600", "3600",
                    Ekiga::FormVisitor::NUMBER, true, false);
   }
@@ -791,6 +794,9 @@ Opal::Account::on_edit_form_submitted (bool submitted,
   if (new_authentication_user.empty ())
     new_authentication_user = new_user;
   std::string new_password = result.text ("password");
+  std::string new_presence_list = get_config ()->presence_list;
+  if (type == Account::SIP)
+    new_presence_list = result.text ("presence_list");
   bool new_enabled = result.boolean ("enabled");
   bool should_enable = false;
   bool should_disable = false;
@@ -830,6 +836,7 @@ Opal::Account::on_edit_form_submitted (bool submitted,
           || get_authentication_username () != new_authentication_user
           || get_password () != new_password
           || get_timeout () != new_timeout
+          || get_config ()->presence_list != new_presence_list
           || is_enabled () != new_enabled) {
 
         should_enable = true;
@@ -847,6 +854,11 @@ Opal::Account::on_edit_form_submitted (bool submitted,
       xmlSetProp (node, BAD_CAST "timeout", BAD_CAST sstream.str ().c_str ());
     }
 
+    if (new_presence_list.empty ())
+      xmlUnsetProp (node, BAD_CAST "presence_list");
+    else
+      xmlSetProp (node, BAD_CAST "presence_list", BAD_CAST new_presence_list.c_str ());
+
     for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
 
       if (child->type == XML_ELEMENT_NODE && child->name != NULL) {
@@ -866,6 +878,7 @@ Opal::Account::on_edit_form_submitted (bool submitted,
       }
     }
 
+    load_config ();
     decide_type ();
 
     if (should_enable)
@@ -921,7 +934,7 @@ Opal::Account::on_add_contact_form_submitted (bool submitted,
     return false;
   }
 
-  if (is_supported_uri (uri)) {
+  if ( !presentities.find_by_key (index_key (uri))) {
     xmlNodePtr presnode = Opal::Presentity::build_node (name, uri, groups);
     xmlAddChild (roster_node, presnode);
     trigger_saving ();
@@ -932,10 +945,7 @@ Opal::Account::on_add_contact_form_submitted (bool submitted,
     return true;
   }
   else {
-    if (is_supported_uri (uri))
-      error = _("You supplied an unsupported address");
-    else
-      error = _("You already have a contact with this address!");
+    error = _("You already have a contact with this address!");
   }
 
   return false;
@@ -972,7 +982,7 @@ Opal::Account::load_presentity (boost::weak_ptr<Ekiga::PresenceCore> _presence_c
   // When the presentity emits trigger_saving, we relay it "upstream" so that the
   // Bank can save everything.
   presentities.add_connection (pres, pres->trigger_saving.connect (boost::ref (trigger_saving)));
-  presentities.add_connection (pres, pres->removed.connect (boost::bind (&Opal::Account::unfetch, this, pres->get_uri ()), boost::signals2::at_front));  // slot from DynamicObjectStore must be the last called
+  presentities.add_connection (pres, pres->removed.connect (boost::bind (&Opal::Account::on_presentity_removed, this, _1), boost::signals2::at_front));  // slot from DynamicObjectStore must be the last called
   add_presentity (pres);
 
   return pres;
@@ -990,6 +1000,10 @@ Opal::Account::fetch (const std::string uri)
   if (!is_enabled ())
     return;
 
+  // The presence list already covers it
+  if (presence_list_active)
+    return;
+
   // Subscribe now
   if (state == Registered) {
     PTRACE(4, "Ekiga\tSubscribeToPresence for " << uri.c_str () << " (fetch)");
@@ -998,11 +1012,43 @@ Opal::Account::fetch (const std::string uri)
 }
 
 
+boost::shared_ptr<Opal::Presentity>
+Opal::Account::find_presentity (const std::string uri) const
+{
+  find_presentity_helper helper(uri);
+
+  presentities.visit_objects_by_key (index_key (uri), boost::ref (helper));
+
+  return helper.result;
+}
+
+
+void
+Opal::Account::index_presentity (boost::shared_ptr<Presentity> pres)
+{
+  presentities.update_key (pres);
+}
+
+
+void
+Opal::Account::on_presentity_removed (boost::shared_ptr<Presentity> pres)
+{
+  // the presentity's node is already gone: the store knows its uri
+  if ( !presentities.contains (pres))
+    return;
+
+  const std::string uri = presentities.get_key (pres);
+  if (presentities.count_by_key (uri) == 1)
+    unfetch (uri);
+}
+
+
 void
 Opal::Account::unfetch (const std::string uri)
 {
   if (is_supported_uri (uri) && opal_presentity) {
-    opal_presentity->UnsubscribeFromPresence (get_full_uri (uri));
+    if (!presence_list_active)
+      opal_presentity->UnsubscribeFromPresence (get_full_uri (uri));
     Ekiga::Runtime::run_in_main (boost::bind (&Opal::Account::presence_status_in_main, this, uri, "unknown", ""));
   }
 }
@@ -1057,6 +1103,7 @@ Opal::Account::handle_registration_event (Ekiga::Account::RegistrationState stat
 
         opal_presentity->Open ();
 
+        subscribe_presence_list ();
         for (Ekiga::HeapImpl<Opal::Presentity>::iterator iter = Ekiga::HeapImpl<Opal::Presentity>::begin ();
              iter != Ekiga::HeapImpl<Opal::Presentity>::end ();
              ++iter)
@@ -1181,122 +1228,16 @@ Opal::Account::OnPresenceChange (OpalPresentity& /*presentity*/,
       return;
     break;
   case OpalPresenceInfo::Available:
-    new_presence = "available";
-    // First we rely on the note content
-    // for older PABX system having custom implementations
-    if (note.Find ("dnd") != P_MAX_INDEX
-        || note.Find ("meeting") != P_MAX_INDEX
-        || note.Find ("do not disturb") != P_MAX_INDEX
-        || note.Find ("busy") != P_MAX_INDEX
-        || info->m_activities.Contains ("busy"))
-      new_presence = "busy";
-    else if (note.Find ("away") != P_MAX_INDEX
-             || note.Find ("out") != P_MAX_INDEX
-             || note.Find ("vacation") != P_MAX_INDEX
-             || note.Find ("holiday") != P_MAX_INDEX
-             || note.Find ("lunch") != P_MAX_INDEX
-             || info->m_activities.Contains ("away"))
-      new_presence = "away";
-    else if (note.Find ("phone") != P_MAX_INDEX
-             || note.Find ("ringing") != P_MAX_INDEX
-             || note.Find ("call") != P_MAX_INDEX)
-      new_presence = "inacall";
-    // Then we rely on the activities as defined in RFC 4480
-    // they are order by importance as a user could have several
-    // activities running on simultaneously, but we do not want
-    // to handle that.
-    else if (info->m_activities.Contains ("appointment")) {
-      new_presence = "away";
-      new_note = _("Appointment");
-    }
-    else if (info->m_activities.Contains ("breakfast")) {
-      new_presence = "away";
-      new_note = _("Breakfast");
-    }
-    else if (info->m_activities.Contains ("dinner")) {
-      new_presence = "away";
-      new_note = _("Dinner");
-    }
-    else if (info->m_activities.Contains ("vacation")
-             || info->m_activities.Contains ("holiday")) {
-      new_presence = "away";
-      new_note = _("Holiday");
-    }
-    else if (info->m_activities.Contains ("in-transit")) {
-      new_presence = "away";
-      new_note = _("In transit");
-    }
-    else if (info->m_activities.Contains ("looking-for-work")) {
-      new_presence = "away";
-      new_note = _("Looking for work");
-    }
-    else if (info->m_activities.Contains ("lunch")) {
-      new_presence = "away";
-      new_note = _("Lunch");
-    }
-    else if (info->m_activities.Contains ("meal")) {
-      new_presence = "away";
-      new_note = _("Meal");
-    }
-    else if (info->m_activities.Contains ("meeting")) {
-      new_presence = "away";
-      new_note = _("Meeting");
-    }
-    else if (info->m_activities.Contains ("on-the-phone")) {
-      new_presence = "inacall";
-      new_note = _("On the phone");
-    }
-    else if (info->m_activities.Contains ("playing")) {
-      new_presence = "away";
-      new_note = _("Playing");
-    }
-    else if (info->m_activities.Contains ("shopping")) {
-      new_presence = "away";
-      new_note = _("Shopping");
-    }
-    else if (info->m_activities.Contains ("sleeping")) {
-      new_presence = "away";
-      new_note = _("Sleeping");
-    }
-    else if (info->m_activities.Contains ("working")) {
-      new_presence = "busy";
-      new_note = _("Working");
-    }
-    else if (info->m_activities.Contains ("other")) {
-      new_presence = "away";
-      new_note = "";
-    }
-    else if (info->m_activities.Contains ("performance")) {
-      new_presence = "away";
-      new_note = _("Performance");
-    }
-    else if (info->m_activities.Contains ("permanent-absence")) {
-      new_presence = "away";
-      new_note = _("Permanent Absence");
-    }
-    else if (info->m_activities.Contains ("presentation")) {
-      new_presence = "away";
-      new_note = _("Presentation");
-    }
-    else if (info->m_activities.Contains ("spectator")) {
-      new_presence = "away";
-      new_note = _("Spectator");
-    }
-    else if (info->m_activities.Contains ("steering")) {
-      new_presence = "away";
-      new_note = _("Steering");
-    }
-    else if (info->m_activities.Contains ("travel")) {
-      new_presence = "away";
-      new_note = _("Business or personal trip");
-    }
-    else if (info->m_activities.Contains ("tv")) {
-      new_presence = "away";
-      new_note = _("Watching TV");
-    }
-    else if (info->m_activities.Contains ("worship")) {
-      new_presence = "away";
-      new_note = _("Worship");
+    {
+      const PresenceRule* rule = classify_presence (note, info->m_activities);
+
+      new_presence = "available";
+      if (rule != NULL) {
+
+        new_presence = rule->presence;
+        if (rule->note != NULL)
+          new_note = (*rule->note ? gettext (rule->note) : "");
+      }
     }
     break;
   case OpalPresenceInfo::NoPresence:
@@ -1326,18 +1267,90 @@ Opal::Account::presence_status_in_main (std::string uri,
                                         std::string uri_presence,
                                         std::string uri_note) const
 {
-  for (Ekiga::HeapImpl<Opal::Presentity>::const_iterator iter = Ekiga::HeapImpl<Opal::Presentity>::begin ();
+  presentities.visit_objects_by_key (index_key (uri),
+                                     boost::bind (&set_presence_and_note, _1, uri_presence, uri_note));
+  presence_received (uri, uri_presence);
+  note_received (uri, uri_note);
+}
+
+
+void
+Opal::Account::subscribe_presence_list ()
+{
+  const std::string list_uri = get_config ()->presence_list;
+
+  presence_list_active = false;
+  if (list_uri.empty () || type == Account::H323 || !sip_endpoint)
+    return;
+
+  presence_list_active = sip_endpoint->SubscribeToPresenceList (*this, list_uri, presence_list_token);
+}
+
+
+void
+Opal::Account::unsubscribe_presence_list ()
+{
+  if (!presence_list_token.IsEmpty () && sip_endpoint)
+    sip_endpoint->Unsubscribe (presence_list_token);
+
+  presence_list_token = PString ();
+  presence_list_active = false;
+}
+
+
+void
+Opal::Account::handle_presence_list_failure ()
+{
+  if (!presence_list_active)
+    return;
+
+  // Fall back to subscribing to each contact
+  unsubscribe_presence_list ();
+  for (Ekiga::HeapImpl<Opal::Presentity>::iterator iter = Ekiga::HeapImpl<Opal::Presentity>::begin ();
        iter != Ekiga::HeapImpl<Opal::Presentity>::end ();
-       ++iter) {
+       ++iter)
+    fetch ((*iter)->get_uri ());
+}
 
-    if ((*iter)->has_uri (uri)) {
 
-      (*iter)->set_presence (uri_presence);
-      (*iter)->set_note (uri_note);
-    }
+void
+Opal::Account::handle_presence_list_notification (const std::string body)
+{
+  std::list<PresenceUpdate> updates;
+
+  parse_presence_notification (body, updates);
+
+  if (updates.empty ())
+    return;
+
+  /* All the parts of a notification come one after the other : they will
+   * be given to the presentities in a single run of the main loop.
+   */
+  PWaitAndSignal m(presence_updates_mutex);
+  presence_updates.splice (presence_updates.end (), updates);
+  if (!presence_updates_scheduled) {
+
+    presence_updates_scheduled = true;
+    Ekiga::Runtime::run_in_main (boost::bind (&Opal::Account::flush_presence_updates, this));
   }
-  presence_received (uri, uri_presence);
-  note_received (uri, uri_note);
+}
+
+
+void
+Opal::Account::flush_presence_updates ()
+{
+  std::list<PresenceUpdate> updates;
+
+  {
+    PWaitAndSignal m(presence_updates_mutex);
+    updates.swap (presence_updates);
+    presence_updates_scheduled = false;
+  }
+
+  for (std::list<PresenceUpdate>::const_iterator iter = updates.begin ();
+       iter != updates.end ();
+       ++iter)
+    presence_status_in_main (iter->uri, iter->presence, iter->note);
 }
 
 
@@ -51,6 +51,7 @@
 #include "heap-impl.h"
 
 #include "opal-presentity.h"
+#include "opal-presence-rules.h"
 
 namespace Opal
 {
@@ -121,6 +122,28 @@ public:
 
     ~Account ();
 
+    /* The configuration of the account, as parsed from its XML node.
+     * A snapshot is never modified : it is replaced as a whole when the
+     * account is edited, so the opal threads can keep using the one they
+     * got while the main thread changes the account.
+     */
+    struct Config
+    {
+      std::string name;
+      std::string protocol_name;
+      std::string host;
+      std::string outbound_proxy;
+      std::string user;
+      std::string auth_user;
+      std::string password;
+      std::string aor;
+      std::string presence_list;
+      unsigned timeout;
+      bool enabled;
+    };
+
+    boost::shared_ptr<const Config> get_config () const;
+
     const std::string get_name () const;
 
     const std::string get_status () const;
@@ -133,6 +156,9 @@ public:
 
     std::list<std::string> get_groups () const;
 
+    /* The presentity with exactly that uri, if there is one */
+    boost::shared_ptr<Presentity> find_presentity (const std::string uri) const;
+
     /** Returns the protocol name of the Opal::Account.
      * This function is purely virtual and should be implemented by the
      * Ekiga::Account descendant.
@@ -208,6 +234,17 @@ public:
      */
     void handle_message_waiting_information (const std::string info);
 
+    /* Those methods are public to be called by the sip endpoint, when the
+     * account watches the presence of its contacts through a single RFC 4662
+     * resource list subscription, instead of one subscription per contact.
+     *
+     * The first one can be called from the opal threads, with the body of
+     * one part of a list notification : the parts are parsed and queued,
+     * then given to the presentities in a single batch in the main thread.
+     */
+    void handle_presence_list_notification (const std::string body);
+    void handle_presence_list_failure ();
+
     const PString get_full_uri (const PString & uri) const;
 
 protected:
@@ -232,10 +269,20 @@ private:
 
     void fetch (const std::string uri);
     void unfetch (const std::string uri);
+
+    /* The presentities are indexed by their (canonical) uri, so that
+     * presence notifications do not walk the whole roster ; this is to
+     * be called when the uri of one changes.
+     */
+    void index_presentity (boost::shared_ptr<Presentity> pres);
+    void on_presentity_removed (boost::shared_ptr<Presentity> pres);
     bool is_supported_uri (const std::string & uri);
 
     void decide_type ();
 
+    /* parses the XML node into a new configuration snapshot */
+    void load_config ();
+
     void add_contact ();
 
     bool on_add_contact_form_submitted (bool submitted,
@@ -268,10 +315,24 @@ private:
     boost::function0<std::list<std::string> > existing_groups;
     xmlNodePtr node;
     xmlNodePtr roster_node;
+
+    boost::shared_ptr<const Config> config;
+    mutable PMutex config_mutex;
+
     void presence_status_in_main (std::string uri,
                                   std::string presence,
                                   std::string status) const;
 
+    /* the RFC 4662 resource list subscription, when there is one */
+    void subscribe_presence_list ();
+    void unsubscribe_presence_list ();
+    void flush_presence_updates ();
+    PString presence_list_token;
+    bool presence_list_active;
+    std::list<PresenceUpdate> presence_updates;
+    bool presence_updates_scheduled;
+    PMutex presence_updates_mutex;
+
     Bank & bank;
 
     boost::weak_ptr<Ekiga::PresenceCore> presence_core;
@@ -0,0 +1,269 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+
+/*
+ *                         opal-audio-bridge.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the local conference bridge,
+ *                          mixing the sound of several calls.
+ *
+ */
+
+#include <vector>
+
+#include "opal-audio-bridge.h"
+
+#include "audioinput-core.h"
+#include "audiooutput-core.h"
+
+/* how many buffers the devices get, when the bridge opens them */
+#define DEVICE_BUFFERS 3
+
+namespace
+{
+  class BridgeThread : public PThread
+  {
+    PCLASSINFO(BridgeThread, PThread);
+
+  public:
+
+    BridgeThread (Opal::AudioBridge & _bridge)
+      : PThread (1000, NoAutoDeleteThread, HighestPriority, "AudioBridge"),
+      bridge (_bridge)
+    {
+      this->Resume ();
+    }
+
+    void Main ()
+    {
+      bridge.run ();
+    }
+
+  private:
+    Opal::AudioBridge & bridge;
+  };
+};
+
+
+Opal::AudioBridge::AudioBridge (Ekiga::ServiceCore & _core)
+  : audioinput_handle (_core, Ekiga::audioinput_core_key),
+    audiooutput_handle (_core, Ekiga::audiooutput_core_key),
+    running (false), thread (NULL)
+{
+}
+
+
+Opal::AudioBridge::~AudioBridge ()
+{
+  PWaitAndSignal m(legs_mutex);
+
+  legs.clear ();
+  stop ();
+}
+
+
+void
+Opal::AudioBridge::join (const std::string & token)
+{
+  PWaitAndSignal m(legs_mutex);
+
+  if (legs.find (token) != legs.end ())
+    return;
+
+  legs[token] = mixer.add_leg ();
+  PTRACE (3, "Opal::AudioBridge\tCall " << token << " joined, " << legs.size () << " in the conference");
+
+  if (thread == NULL) {
+
+    {
+      PWaitAndSignal r(running_mutex);
+      running = true;
+    }
+    thread = new BridgeThread (*this);
+  }
+}
+
+
+void
+Opal::AudioBridge::leave (const std::string & token)
+{
+  PWaitAndSignal m(legs_mutex);
+
+  std::map<std::string, Ekiga::AudioMixer::LegId>::iterator iter = legs.find (token);
+  if (iter == legs.end ())
+    return;
+
+  mixer.remove_leg (iter->second);
+  legs.erase (iter);
+  PTRACE (3, "Opal::AudioBridge\tCall " << token << " left, " << legs.size () << " in the conference");
+
+  if (legs.empty ())
+    stop ();
+}
+
+
+bool
+Opal::AudioBridge::is_joined (const std::string & token)
+{
+  PWaitAndSignal m(legs_mutex);
+
+  return legs.find (token) != legs.end ();
+}
+
+
+bool
+Opal::AudioBridge::write (const std::string & token,
+                          const short* samples,
+                          unsigned n,
+                          unsigned rate)
+{
+  Ekiga::AudioMixer::LegId leg;
+
+  {
+    PWaitAndSignal m(legs_mutex);
+
+    std::map<std::string, Ekiga::AudioMixer::LegId>::const_iterator iter = legs.find (token);
+    if (iter == legs.end ())
+      return false;
+    leg = iter->second;
+  }
+
+  /* waiting paces the media thread, as the device would */
+  mixer.put (leg, samples, n, rate, true);
+
+  return true;
+}
+
+
+bool
+Opal::AudioBridge::read (const std::string & token,
+                         short* samples,
+                         unsigned n,
+                         unsigned rate)
+{
+  Ekiga::AudioMixer::LegId leg;
+
+  {
+    PWaitAndSignal m(legs_mutex);
+
+    std::map<std::string, Ekiga::AudioMixer::LegId>::const_iterator iter = legs.find (token);
+    if (iter == legs.end ())
+      return false;
+    leg = iter->second;
+  }
+
+  mixer.get (leg, samples, n, rate, true);
+
+  return true;
+}
+
+
+void
+Opal::AudioBridge::run ()
+{
+  boost::shared_ptr<Ekiga::AudioInputCore> audioinput_core = audioinput_handle.get ();
+  boost::shared_ptr<Ekiga::AudioOutputCore> audiooutput_core = audiooutput_handle.get ();
+  if (!audioinput_core || !audiooutput_core)
+    return;
+
+  const unsigned period_bytes = mixer.get_period_size () * sizeof (short);
+  Ekiga::AudioMixer::LegId local = mixer.add_leg ();
+  std::vector<short> said;
+  std::vector<short> heard;
+  unsigned bytes = 0;
+
+  /* The calls may have opened the devices already: then they are
+   * shared, and stay as the calls opened them */
+  if (audioinput_core->get_stream_samplerate () == 0)
+    audioinput_core->set_stream_buffer_size (period_bytes, DEVICE_BUFFERS);
+  audioinput_core->start_stream (1, mixer.get_rate (), 16);
+
+  bool output_opened = (audiooutput_core->get_samplerate () == 0);
+  audiooutput_core->start (1, mixer.get_rate (), 16);
+  if (output_opened)
+    audiooutput_core->set_buffer_size (period_bytes, DEVICE_BUFFERS);
+
+  PTRACE (3, "Opal::AudioBridge\tStarted, recording at " << audioinput_core->get_stream_samplerate ()
+          << " Hz, playing at " << audiooutput_core->get_samplerate () << " Hz");
+
+  while (is_running ()) {
+
+    const unsigned in_rate = audioinput_core->get_stream_samplerate ();
+    const unsigned out_rate = audiooutput_core->get_samplerate ();
+
+    said.resize (in_rate * mixer.get_period () / 1000);
+    heard.resize (out_rate * mixer.get_period () / 1000);
+    if (said.empty () || heard.empty ()) {
+
+      PThread::Sleep (mixer.get_period ());
+      continue;
+    }
+
+    /* the microphone is the clock of the conference */
+    audioinput_core->get_frame_data ((char *) &said[0], said.size () * sizeof (short), bytes);
+    mixer.put (local, &said[0], bytes / sizeof (short), in_rate, false);
+
+    mixer.mix ();
+
+    mixer.get (local, &heard[0], heard.size (), out_rate, false);
+    audiooutput_core->set_frame_data ((const char *) &heard[0], heard.size () * sizeof (short), bytes);
+  }
+
+  mixer.remove_leg (local);
+  audioinput_core->stop_stream ();
+  audiooutput_core->stop ();
+
+  PTRACE (3, "Opal::AudioBridge\tStopped, " << mixer.get_mixed () << " periods mixed since the start");
+}
+
+
+bool
+Opal::AudioBridge::is_running ()
+{
+  PWaitAndSignal m(running_mutex);
+
+  return running;
+}
+
+
+void
+Opal::AudioBridge::stop ()
+{
+  {
+    PWaitAndSignal m(running_mutex);
+    running = false;
+  }
+
+  if (thread != NULL) {
+
+    thread->WaitForTermination ();
+    delete thread;
+    thread = NULL;
+  }
+}
@@ -0,0 +1,117 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+
+/*
+ *                         opal-audio-bridge.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the local conference bridge,
+ *                          mixing the sound of several calls.
+ *
+ */
+
+#ifndef __OPAL_AUDIO_BRIDGE_H__
+#define __OPAL_AUDIO_BRIDGE_H__
+
+#include <map>
+#include <string>
+
+#include <ptlib.h>
+#include <boost/noncopyable.hpp>
+
+#include "services.h"
+#include "audio-mixer.h"
+
+namespace Ekiga {
+
+  class AudioInputCore;
+  class AudioOutputCore;
+};
+
+namespace Opal {
+
+  /* A local conference: the calls which join it, and the local user,
+   * each hear all the others.
+   *
+   * The sound channels of the joined calls stop using the audio devices:
+   * they give and take their sound to and from the mixer, and a thread
+   * of the bridge, paced by the microphone, feeds it with the local
+   * user's voice, mixes, and plays what the local user hears. The thread
+   * runs for as long as there is a call in the conference.
+   */
+  class AudioBridge: public boost::noncopyable
+  {
+  public:
+
+    AudioBridge (Ekiga::ServiceCore & core);
+
+    ~AudioBridge ();
+
+    /* Add or remove the call with that token */
+    void join (const std::string & token);
+
+    void leave (const std::string & token);
+
+    bool is_joined (const std::string & token);
+
+    /* For the sound channels: they return false when the call is not in
+     * the conference, and the channel has to use the device itself */
+    bool write (const std::string & token,
+                const short* samples,
+                unsigned n,
+                unsigned rate);
+
+    bool read (const std::string & token,
+               short* samples,
+               unsigned n,
+               unsigned rate);
+
+    /* The body of the thread */
+    void run ();
+
+  private:
+
+    bool is_running ();
+
+    void stop ();
+
+    /* the thread gets the devices through those, not by name */
+    Ekiga::ServiceHandle<Ekiga::AudioInputCore> audioinput_handle;
+    Ekiga::ServiceHandle<Ekiga::AudioOutputCore> audiooutput_handle;
+    Ekiga::AudioMixer mixer;
+
+    PMutex legs_mutex;
+    std::map<std::string, Ekiga::AudioMixer::LegId> legs;
+
+    PMutex running_mutex;
+    bool running;
+    PThread* thread;
+  };
+};
+
+#endif
@@ -38,11 +38,13 @@
 #pragma implementation "opal-audio.h"
 
 #include "opal-audio.h"
+#include "opal-audio-bridge.h"
 
 PSoundChannel_EKIGA::PSoundChannel_EKIGA (boost::shared_ptr<Ekiga::AudioInputCore> _audioinput_core,
                                           boost::shared_ptr<Ekiga::AudioOutputCore> _audiooutput_core):
   audioinput_core (_audioinput_core),
-  audiooutput_core (_audiooutput_core)
+  audiooutput_core (_audiooutput_core),
+  bridge (NULL)
 {
   opened = false;
 }
@@ -56,7 +58,8 @@ PSoundChannel_EKIGA::PSoundChannel_EKIGA (const PString & /*_device*/,
                                           boost::shared_ptr<Ekiga::AudioInputCore> _audioinput_core,
                                           boost::shared_ptr<Ekiga::AudioOutputCore> _audiooutput_core):
   audioinput_core (_audioinput_core),
-  audiooutput_core (_audiooutput_core)
+  audiooutput_core (_audiooutput_core),
+  bridge (NULL)
 {
   opened = false;
   Params params (dir, device, PString::Empty(), numChannels, sampleRate, bitsPerSample);
@@ -118,7 +121,10 @@ bool PSoundChannel_EKIGA::Write (const void *buf, PINDEX len)
   unsigned bytesWritten = 0;
 
   if (direction == Player) {
-    audiooutput_core->set_frame_data((char*)buf, len, bytesWritten);
+    if (bridge && bridge->write (token, (const short*) buf, len / sizeof (short), mSampleRate))
+      bytesWritten = len;
+    else
+      audiooutput_core->set_frame_data((char*)buf, len, bytesWritten);
   }
 
   lastWriteCount = bytesWritten;
@@ -131,7 +137,10 @@ bool PSoundChannel_EKIGA::Read (void * buf, PINDEX len)
   unsigned bytesRead = 0;
 
   if (direction == Recorder) {
-    audioinput_core->get_frame_data((char*)buf, len, bytesRead);
+    if (bridge && bridge->read (token, (short*) buf, len / sizeof (short), mSampleRate))
+      bytesRead = len;
+    else
+      audioinput_core->get_frame_data((char*)buf, len, bytesRead);
   }
 
   lastReadCount = bytesRead;
@@ -188,3 +197,14 @@ bool PSoundChannel_EKIGA::IsOpen () const
   return opened;
 }
 
+
+void PSoundChannel_EKIGA::SetBridge (Opal::AudioBridge *_bridge,
+                                     const std::string & _token)
+{
+  /* the mixer only knows 16 bits mono */
+  if (mNumChannels != 1 || mBitsPerSample != 16)
+    return;
+
+  bridge = _bridge;
+  token = _token;
+}
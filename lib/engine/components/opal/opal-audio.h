@@ -44,6 +44,10 @@
 #include "audioinput-core.h"
 #include "audiooutput-core.h"
 
+namespace Opal {
+  class AudioBridge;
+};
+
 class PSoundChannel_EKIGA : public PSoundChannel {
   PCLASSINFO(PSoundChannel_EKIGA, PSoundChannel); 
 public:
@@ -69,6 +73,9 @@ public:
   bool GetBuffers(PINDEX & size, PINDEX & count);
   bool IsOpen() const;
 
+  /* The channel belongs to that call, which can join the bridge */
+  void SetBridge(Opal::AudioBridge *bridge, const std::string & token);
+
  private:
 
   PSoundChannel::Directions direction;
@@ -91,6 +98,9 @@ public:
   boost::shared_ptr<Ekiga::AudioInputCore> audioinput_core;
   boost::shared_ptr<Ekiga::AudioOutputCore> audiooutput_core;
   bool opened;
+
+  Opal::AudioBridge *bridge;
+  std::string token;
 };
 
 #endif
@@ -83,15 +83,18 @@ Opal::Bank::Bank (Ekiga::ServiceCore& core,
 #ifdef HAVE_H323
   h323_endpoint(_h323_endpoint),
 #endif
-  sip_endpoint(_sip_endpoint)
+  sip_endpoint(_sip_endpoint),
+  saving(boost::bind (&Opal::Bank::save, this))
 {
   // FIXME
   sip_endpoint->mwi_event.connect (boost::bind(&Opal::Bank::on_mwi_event, this, _1, _2));
+  endpoint.nat_changed.connect (boost::bind (&Opal::Bank::on_nat_changed, this));
 }
 
 
 Opal::Bank::~Bank ()
 {
+  saving.flush ();
   delete protocols_settings;
 }
 
@@ -114,10 +117,12 @@ Opal::Bank::load_account (boost::function0<std::list<std::string> > _existing_gr
                            _existing_groups,
                            _node);
 
-  accounts.add_connection (account, account->trigger_saving.connect (boost::bind (&Opal::Bank::save, this)));
+  accounts.add_connection (account, account->trigger_saving.connect (boost::bind (&Ekiga::WriteBehind::schedule, &saving)));
   accounts.add_connection (account, account->removed.connect (boost::bind (&Opal::Bank::on_account_removed, this, _1), boost::signals2::at_front));  // slot from DynamicObjectStore must be the last called
+  accounts.add_connection (account, account->updated.connect (boost::bind (&Opal::Bank::reindex_accounts, this, AccountPtr ())));
 
   add_account (account);
+  reindex_accounts ();
   add_heap (account);
 
   activate (account);
@@ -303,7 +308,7 @@ Opal::Bank::add (Account::Type acc_type,
   xmlNodePtr child = Opal::Account::build_node (acc_type, name, host, outbound_proxy, user, auth_user, password, enabled, timeout);
   xmlAddChild (node, child);
 
-  save ();
+  saving.schedule ();
 
   load_account (boost::bind(&Opal::Bank::existing_groups, this), child);
 }
@@ -312,22 +317,51 @@ Opal::Bank::add (Account::Type acc_type,
 Opal::AccountPtr
 Opal::Bank::find_account (const std::string& _aor)
 {
-  AccountPtr result;
-  std::string aor = _aor;
-  std::string::size_type t = aor.find_first_of (";");
+  std::string::size_type t = _aor.find_first_of (";");
 
   if (t != std::string::npos)
-    aor = aor.substr (0, t);
+    return find_account (_aor.substr (0, t));
 
+  PWaitAndSignal m(accounts_index_mutex);
+  accounts_index_type::const_iterator iter;
+
+  // find by account name+host (aor)
+  if (_aor.find ("@") != std::string::npos) {
+
+    iter = accounts_by_aor.find (_aor);
+    if (iter != accounts_by_aor.end ())
+      return iter->second;
+  }
+
+  // find by host
+  iter = accounts_by_host.find (_aor);
+  if (iter != accounts_by_host.end ())
+    return iter->second;
+
+  return AccountPtr ();
+}
+
+
+void
+Opal::Bank::reindex_accounts (AccountPtr removed_account)
+{
+  PWaitAndSignal m(accounts_index_mutex);
+
+  accounts_by_aor.clear ();
+  accounts_by_host.clear ();
+
+  // the first account wins, as with the linear search we used to do
   for (Ekiga::BankImpl<Opal::Account>::iterator iter = Ekiga::BankImpl<Opal::Account>::begin ();
        iter != Ekiga::BankImpl<Opal::Account>::end ();
        ++iter) {
-    if (aor.find ("@") != std::string::npos && (*iter)->get_aor () == aor)  // find by account name+host (aor)
-        return *iter;
-    else if ((*iter)->get_host () == aor)  // find by host
-      return *iter;
+
+    if (*iter == removed_account)
+      continue;
+
+    boost::shared_ptr<const Account::Config> config = (*iter)->get_config ();
+    accounts_by_aor.insert (std::make_pair (config->aor, *iter));
+    accounts_by_host.insert (std::make_pair (config->host, *iter));
   }
-  return result;
 }
 
 
@@ -350,6 +384,8 @@ Opal::Bank::on_account_removed (boost::shared_ptr<Account> account)
   boost::shared_ptr<Ekiga::PresenceCore> pcore = presence_core.lock ();
   if (pcore)
     pcore->remove_presence_fetcher (account);
+
+  reindex_accounts (account);
 }
 
 
@@ -415,36 +451,17 @@ Opal::Bank::existing_groups () const
   return result;
 }
 
-struct find_presentity_helper
-{
-  find_presentity_helper (const std::string uri_): uri(uri_)
-  {}
-
-  bool operator() (Ekiga::PresentityPtr pres)
-  {
-    Opal::PresentityPtr presentity = boost::dynamic_pointer_cast<Opal::Presentity> (pres);
-
-    if (presentity && presentity->get_uri () == uri)
-      result = presentity;
-
-    return !result;
-  }
-
-  std::string uri;
-  Ekiga::PresentityPtr result;
-};
-
 Ekiga::PresentityPtr
 Opal::Bank::find_presentity_for_uri (const std::string uri) const
 {
-  find_presentity_helper helper(uri);
+  Ekiga::PresentityPtr result;
 
   for (Ekiga::ClusterImpl<Opal::Account>::const_iterator iter = Ekiga::ClusterImpl<Opal::Account>::begin ();
-       iter != Ekiga::ClusterImpl<Opal::Account>::end () && !helper.result;
+       iter != Ekiga::ClusterImpl<Opal::Account>::end () && !result;
        ++iter)
-    (*iter)->visit_presentities(boost::ref(helper));
+    result = (*iter)->find_presentity (uri);
 
-  return helper.result;
+  return result;
 }
 
 void
@@ -571,6 +588,16 @@ Opal::Bank::add_actions ()
 }
 
 
+/* The accounts registered with NAT settings which turned out to be wrong */
+void
+Opal::Bank::on_nat_changed ()
+{
+  for (iterator iter = begin (); iter != end (); ++iter)
+    if ((*iter)->is_enabled ())
+      (*iter)->enable ();
+}
+
+
 void
 Opal::Bank::activate (boost::shared_ptr<Opal::Account> account)
 {
@@ -40,10 +40,13 @@
 
 #include "config.h"
 
+#include <boost/unordered_map.hpp>
+
 #include "contact-core.h"
 #include "presence-core.h"
 
 #include "ekiga-settings.h"
+#include "write-behind.h"
 
 #include "sip-endpoint.h"
 #include "h323-endpoint.h"
@@ -111,6 +114,7 @@ public:
 
 
     /** Find the account with the given address of record in the Bank
+     * This can be called from the opal threads.
      * @param aor is the address of record of the Account or the host to look
      *        for
      * @return The Opal::Account if an Account was found, false otherwise.
@@ -169,6 +173,15 @@ private:
 
     void on_account_removed (boost::shared_ptr<Account> account);
 
+    /* The accounts are indexed by aor and by host for find_account ;
+     * the indexes are rebuilt whenever an account changes.
+     */
+    void reindex_accounts (AccountPtr removed_account = AccountPtr ());
+    typedef boost::unordered_map<std::string, AccountPtr> accounts_index_type;
+    accounts_index_type accounts_by_aor;
+    accounts_index_type accounts_by_host;
+    PMutex accounts_index_mutex;
+
     void on_mwi_event (std::string aor,
                        std::string info);
 
@@ -178,6 +191,8 @@ private:
 
     void activate (boost::shared_ptr<Account> account);
 
+    void on_nat_changed ();
+
     Ekiga::Settings *protocols_settings;
 
     Opal::EndPoint& endpoint;
@@ -185,8 +200,13 @@ private:
     Opal::H323::EndPoint* h323_endpoint;
 #endif
     Opal::Sip::EndPoint* sip_endpoint;
+
+    Ekiga::WriteBehind saving;
   };
 
+  /* the key to get it from the ServiceCore */
+  const Ekiga::ServiceKey<Bank> bank_key ("opal-account-store");
+
   /**
    * @}
    */
@@ -45,8 +45,11 @@
 
 /* The engine class */
 Opal::CallManager::CallManager (Ekiga::ServiceCore& _core,
-                                Opal::EndPoint& _endpoint) : core(_core), endpoint(_endpoint)
+                                Opal::EndPoint& _endpoint) : core(_core), endpoint(_endpoint), codecs_applied(false)
 {
+  /* Gather the media formats once, before the calls need them */
+  Opal::CodecCatalog::get ();
+
   /* Setup things */
   Ekiga::SettingsCallback setup_cb = boost::bind (&Opal::CallManager::setup, this, _1);
   audio_codecs_settings = Ekiga::SettingsPtr (new Ekiga::Settings (AUDIO_CODECS_SCHEMA, setup_cb));
@@ -112,25 +115,32 @@ const std::string & Opal::CallManager::get_display_name () const
 
 void Opal::CallManager::set_codecs (Ekiga::CodecList & _codecs)
 {
-  PStringArray mask, order;
-  OpalMediaFormatList formats;
-  OpalMediaFormat::GetAllRegisteredMediaFormats (formats);
+  const CodecCatalog & catalog = CodecCatalog::get ();
+  std::vector<CodecCatalog::Id> ids;
+  PStringArray order;
 
   codecs = _codecs;
 
   for (Ekiga::CodecList::const_iterator iter = codecs.begin ();
        iter != codecs.end ();
-       iter++)
-    if ((*iter).active)
+       iter++) {
+
+    CodecCatalog::Id id = catalog.find ((*iter).name);
+    if ((*iter).active && id != CodecCatalog::Unknown) {
+
       order += (*iter).name;
+      ids.push_back (id);
+    }
+  }
 
-  formats.Remove (order);
+  if (codecs_applied && ids == applied_codecs)
+    return;
 
-  for (int i = 0 ; i < formats.GetSize () ; i++)
-    mask += (const char *) formats[i];
+  applied_codecs = ids;
+  codecs_applied = true;
 
   endpoint.SetMediaFormatOrder (order);
-  endpoint.SetMediaFormatMask (mask);
+  endpoint.SetMediaFormatMask (catalog.get_mask (ids));
   PTRACE (4, "Opal::CallManager\tSet codecs: " << setfill(';') << endpoint.GetMediaFormatOrder ());
   PTRACE (4, "Opal::CallManager\tDisabled codecs: " << setfill(';') << endpoint.GetMediaFormatMask ());
 }
@@ -185,43 +195,33 @@ void Opal::CallManager::setup (const std::string & setting)
   if (setting.empty () || setting == "auto-answer")
     set_auto_answer (call_options_settings->get_bool ("auto-answer"));
 
-  if (setting.empty () || setting == "maximum-video-tx-bitrate") {
+  if (setting.empty ()
+      || setting == "maximum-video-tx-bitrate"
+      || setting == "temporal-spatial-tradeoff"
+      || setting == "size"
+      || setting == "max-frame-rate"
+      || setting == "maximum-video-bitrate") {
 
+    /* Setting the video options updates and registers again every video
+     * format: do it once for all of them */
     Opal::EndPoint::VideoOptions options;
     endpoint.GetVideoOptions (options);
-    options.maximum_transmitted_bitrate = video_codecs_settings->get_int ("maximum-video-tx-bitrate");
-    endpoint.SetVideoOptions (options);
-  }
 
-  if (setting.empty () || setting == "temporal-spatial-tradeoff") {
+    if (setting.empty () || setting == "maximum-video-tx-bitrate")
+      options.maximum_transmitted_bitrate = video_codecs_settings->get_int ("maximum-video-tx-bitrate");
 
-    Opal::EndPoint::VideoOptions options;
-    endpoint.GetVideoOptions (options);
-    options.temporal_spatial_tradeoff = video_codecs_settings->get_int ("temporal-spatial-tradeoff");
-    endpoint.SetVideoOptions (options);
-  }
+    if (setting.empty () || setting == "temporal-spatial-tradeoff")
+      options.temporal_spatial_tradeoff = video_codecs_settings->get_int ("temporal-spatial-tradeoff");
 
-  if (setting.empty () || setting == "size") {
+    if (setting.empty () || setting == "size")
+      options.size = video_devices_settings->get_enum ("size");
 
-    Opal::EndPoint::VideoOptions options;
-    endpoint.GetVideoOptions (options);
-    options.size = video_devices_settings->get_enum ("size");
-    endpoint.SetVideoOptions (options);
-  }
+    if (setting.empty () || setting == "max-frame-rate")
+      options.maximum_frame_rate = video_codecs_settings->get_int ("max-frame-rate");
 
-  if (setting.empty () || setting == "max-frame-rate") {
+    if (setting.empty () || setting == "maximum-video-bitrate")
+      options.maximum_bitrate = video_codecs_settings->get_int ("maximum-video-bitrate");
 
-    Opal::EndPoint::VideoOptions options;
-    endpoint.GetVideoOptions (options);
-    options.maximum_frame_rate = video_codecs_settings->get_int ("max-frame-rate");
-    endpoint.SetVideoOptions (options);
-  }
-
-  if (setting.empty () || setting == "maximum-video-bitrate") {
-
-    Opal::EndPoint::VideoOptions options;
-    endpoint.GetVideoOptions (options);
-    options.maximum_bitrate = video_codecs_settings->get_int ("maximum-video-bitrate");
     endpoint.SetVideoOptions (options);
   }
 
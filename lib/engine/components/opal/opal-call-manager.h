@@ -42,6 +42,7 @@
 #include "opal-endpoint.h"
 #include "opal-call.h"
 #include "opal-codec-description.h"
+#include "opal-codec-catalog.h"
 
 #include "ekiga-settings.h"
 
@@ -140,6 +141,11 @@ private:
 
     std::string display_name;
     Ekiga::CodecList codecs;
+
+    /* The codecs last given to the endpoint, not to do it again when
+     * the list didn't really change */
+    std::vector<CodecCatalog::Id> applied_codecs;
+    bool codecs_applied;
   };
 };
 #endif
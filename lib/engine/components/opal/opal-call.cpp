@@ -40,7 +40,9 @@
 #include <glib/gi18n.h>
 #include <opal/opal.h>
 #include <ep/pcss.h>
+#include <opal/rtpconn.h>
 #include <sip/sippdu.h>
+#include <sip/sipcon.h>
 
 #include "call.h"
 #include "opal-call.h"
@@ -48,10 +50,28 @@
 #include "notification-core.h"
 #include "call-core.h"
 #include "runtime.h"
-#include "known-codecs.h"
+#include "trace-ring.h"
+#include "opal-codec-catalog.h"
+
+/* Seconds between two samples of the media quality */
+#define QUALITY_SAMPLE_INTERVAL 1
 
 using namespace Opal;
 
+static Ekiga::VideoRateSettings
+get_video_settings (const OpalMediaFormat & format)
+{
+  Ekiga::VideoRateSettings result;
+  unsigned frame_time = format.GetOptionInteger (OpalVideoFormat::FrameTimeOption ());
+
+  result.bitrate = format.GetOptionInteger (OpalVideoFormat::TargetBitRateOption ()) / 1000;
+  result.frame_rate = (frame_time > 0 ? format.GetClockRate () / frame_time : 0);
+  result.width = format.GetOptionInteger (OpalVideoFormat::FrameWidthOption ());
+  result.height = format.GetOptionInteger (OpalVideoFormat::FrameHeightOption ());
+
+  return result;
+}
+
 static void
 strip_special_chars (std::string& str, char* special_chars, bool start)
 {
@@ -87,7 +107,9 @@ Opal::Call::Call (Opal::EndPoint& _manager,
     Ekiga::Call (),
     remote_uri (_uri),
     call_setup (false),
-    outgoing (false)
+    call_id_traced (false),
+    outgoing (false),
+    bridge (_manager.GetAudioBridge ())
 {
   add_action (Ekiga::ActionPtr (new Ekiga::Action ("hangup", _("Hangup"),
                                                    boost::bind (&Call::hang_up, this))));
@@ -101,6 +123,8 @@ Opal::Call::Call (Opal::EndPoint& _manager,
     if (_no_answer_delay > 0)
       noAnswerTimer.SetInterval (0, _no_answer_delay);
   }
+
+  qualityTimer.SetNotifier (PCREATE_NOTIFIER (OnQualityTimeout));
 }
 
 
@@ -202,6 +226,30 @@ Opal::Call::toggle_hold ()
 }
 
 
+void
+Opal::Call::toggle_conference ()
+{
+  const std::string token = (const char *) GetToken ();
+
+  if (bridge.is_joined (token)) {
+
+    bridge.leave (token);
+    add_action (Ekiga::ActionPtr (new Ekiga::Action ("conference", _("Join Conference"),
+                                                     boost::bind (&Call::toggle_conference, this))));
+    return;
+  }
+
+  /* a call on hold comes back to join */
+  PSafePtr<OpalConnection> connection = GetConnection ();
+  if (connection != NULL && connection->IsOnHold (false))
+    connection->HoldRemote (false);
+
+  bridge.join (token);
+  add_action (Ekiga::ActionPtr (new Ekiga::Action ("conference", _("Leave Conference"),
+                                                   boost::bind (&Call::toggle_conference, this))));
+}
+
+
 void
 Opal::Call::toggle_stream_pause (StreamType type)
 {
@@ -310,60 +358,87 @@ Opal::Call::get_start_time () const
 
 const RTCPStatistics &
 Opal::Call::get_statistics ()
+{
+  collect_statistics (tr_a_statistics, re_a_statistics,
+                      tr_v_statistics, re_v_statistics,
+                      statistics);
+
+  return statistics;
+}
+
+
+Ekiga::CallQualitySummary
+Opal::Call::get_quality_summary ()
+{
+  PWaitAndSignal m(quality_mutex);
+
+  return quality.get_summary ();
+}
+
+
+bool
+Opal::Call::export_quality (const std::string & filename)
+{
+  PWaitAndSignal m(quality_mutex);
+
+  return quality.export_to (filename);
+}
+
+
+void
+Opal::Call::collect_statistics (OpalMediaStatistics & tr_a,
+                                OpalMediaStatistics & re_a,
+                                OpalMediaStatistics & tr_v,
+                                OpalMediaStatistics & re_v,
+                                RTCPStatistics & result)
 {
   PSafePtr<OpalConnection> connection = GetConnection ();
   if (connection == NULL)
-    return statistics;
+    return;
 
   OpalMediaStreamPtr stream;
   stream = connection->GetMediaStream (OpalMediaType::Audio (), false);  // transmission
   if (stream) {
-    tr_a_statistics.Update (*stream);
+    tr_a.Update (*stream);
     // GetBitRate is the average bit rate on the last second
-    statistics.transmitted_audio_bandwidth  = tr_a_statistics.GetBitRate () / 1024;
-    statistics.jitter = tr_a_statistics.m_averageJitter;
+    result.transmitted_audio_bandwidth  = tr_a.GetBitRate () / 1024;
+    result.jitter = tr_a.m_averageJitter;
+    result.round_trip_time = tr_a.m_roundTripTime;
   }
 
   stream = connection->GetMediaStream (OpalMediaType::Audio (), true);  // reception
   if (stream) {
-    re_a_statistics.Update (*stream);
-    statistics.received_audio_bandwidth  = re_a_statistics.GetBitRate () / 1024;
-    statistics.remote_jitter = re_a_statistics.m_averageJitter;
+    re_a.Update (*stream);
+    result.received_audio_bandwidth  = re_a.GetBitRate () / 1024;
+    result.remote_jitter = re_a.m_averageJitter;
   }
 
   stream = connection->GetMediaStream (OpalMediaType::Video (), false);  // transmission
   if (stream) {
-    tr_v_statistics.Update (*stream);
-    statistics.transmitted_video_bandwidth  = tr_v_statistics.GetBitRate () / 1024;
+    tr_v.Update (*stream);
+    result.transmitted_video_bandwidth  = tr_v.GetBitRate () / 1024;
     // GetFrameRate is the average frame rate on the last second
-    statistics.transmitted_fps = tr_v_statistics.GetFrameRate ();
+    result.transmitted_fps = tr_v.GetFrameRate ();
   }
 
   stream = connection->GetMediaStream (OpalMediaType::Video (), true);  // reception
   if (stream) {
-    re_v_statistics.Update (*stream);
-    statistics.received_video_bandwidth  = re_v_statistics.GetBitRate () / 1024;
-    statistics.received_fps = re_v_statistics.GetFrameRate ();
+    re_v.Update (*stream);
+    result.received_video_bandwidth  = re_v.GetBitRate () / 1024;
+    result.received_fps = re_v.GetFrameRate ();
   }
 
-  for (PINDEX i = 0 ; KnownCodecs[i][0] ; i++) {
-    if (tr_a_statistics.m_mediaFormat == KnownCodecs[i][0])
-      statistics.transmitted_audio_codec = gettext (KnownCodecs[i][1]);
-    if (re_a_statistics.m_mediaFormat == KnownCodecs[i][0])
-      statistics.received_audio_codec = gettext (KnownCodecs[i][1]);
-    if (tr_v_statistics.m_mediaFormat == KnownCodecs[i][0])
-      statistics.transmitted_video_codec = gettext (KnownCodecs[i][1]);
-    if (re_v_statistics.m_mediaFormat == KnownCodecs[i][0])
-      statistics.received_video_codec = gettext (KnownCodecs[i][1]);
-  }
+  const CodecCatalog & catalog = CodecCatalog::get ();
+  result.transmitted_audio_codec = catalog.get_known_name ((const char *) tr_a.m_mediaFormat);
+  result.received_audio_codec = catalog.get_known_name ((const char *) re_a.m_mediaFormat);
+  result.transmitted_video_codec = catalog.get_known_name ((const char *) tr_v.m_mediaFormat);
+  result.received_video_codec = catalog.get_known_name ((const char *) re_v.m_mediaFormat);
 
   // 100 * number of lost packets / by number of packets, on the last second
-  if (re_a_statistics.GetPacketRate () + re_v_statistics.GetPacketRate () != 0)
-    statistics.lost_packets = 100 * (re_a_statistics.GetLossRate () + re_v_statistics.GetLossRate ()) / (re_a_statistics.GetPacketRate () + re_v_statistics.GetPacketRate ());
-  if (tr_a_statistics.GetPacketRate () + tr_v_statistics.GetPacketRate () != 0)
-    statistics.remote_lost_packets = 100 * (tr_a_statistics.GetLossRate () + tr_v_statistics.GetLossRate ()) / (tr_a_statistics.GetPacketRate () + tr_v_statistics.GetPacketRate ());
-
-  return statistics;
+  if (re_a.GetPacketRate () + re_v.GetPacketRate () != 0)
+    result.lost_packets = 100 * (re_a.GetLossRate () + re_v.GetLossRate ()) / (re_a.GetPacketRate () + re_v.GetPacketRate ());
+  if (tr_a.GetPacketRate () + tr_v.GetPacketRate () != 0)
+    result.remote_lost_packets = 100 * (tr_a.GetLossRate () + tr_v.GetLossRate ()) / (tr_a.GetPacketRate () + tr_v.GetPacketRate ());
 }
 
 
@@ -454,16 +529,22 @@ Opal::Call::OnEstablished (OpalConnection & connection)
 
   noAnswerTimer.Stop (false);
 
+  EKIGA_TRACE (TraceCallEstablished, 0, (const char*) GetToken (), (const char*) connection.GetPrefixName ());
+  trace_call_id (connection);
+
   if (!PIsDescendant(&connection, OpalPCSSConnection)) {
 
     add_action (Ekiga::ActionPtr (new Ekiga::Action ("hold", _("Hold"),
                                                      boost::bind (&Call::toggle_hold, this))));
     add_action (Ekiga::ActionPtr (new Ekiga::Action ("transfer", _("Transfer"),
                                                      boost::bind (&Call::transfer, this))));
+    add_action (Ekiga::ActionPtr (new Ekiga::Action ("conference", _("Join Conference"),
+                                                     boost::bind (&Call::toggle_conference, this))));
     remove_action ("answer");
     remove_action ("reject");
 
     parse_info (connection);
+    qualityTimer.RunContinuous (PTimeInterval (0, QUALITY_SAMPLE_INTERVAL));
     Ekiga::Runtime::run_in_main (boost::bind (boost::ref (established), this->shared_from_this ()));
   }
 
@@ -486,6 +567,8 @@ Opal::Call::OnCleared ()
   std::string reason;
 
   noAnswerTimer.Stop (false);
+  qualityTimer.Stop (false);
+  bridge.leave ((const char *) GetToken ());
 
   OpalCall::OnCleared ();
 
@@ -557,6 +640,8 @@ Opal::Call::OnCleared ()
       reason = _("Call completed");
     }
 
+    EKIGA_TRACE (TraceCallCleared, GetCallEndReason (), (const char*) GetToken (), reason.c_str ());
+
     if (IsEstablished () || is_outgoing ())
       Ekiga::Runtime::run_in_main (boost::bind (boost::ref (cleared), this->shared_from_this (), reason));
     else
@@ -590,6 +675,9 @@ Opal::Call::OnSetUp (OpalConnection & connection)
 
   call_setup = true;
 
+  EKIGA_TRACE (TraceCallSetUp, outgoing, (const char*) GetToken (), remote_uri.c_str ());
+  trace_call_id (connection);
+
   OpalCall::OnSetUp (connection);
   Ekiga::Runtime::run_in_main (boost::bind (boost::ref (setup),
                                             this->shared_from_this ()));
@@ -601,6 +689,9 @@ Opal::Call::OnSetUp (OpalConnection & connection)
 PBoolean
 Opal::Call::OnAlerting (OpalConnection & connection)
 {
+  EKIGA_TRACE (TraceCallAlerting, 0, (const char*) GetToken (), (const char*) connection.GetPrefixName ());
+  trace_call_id (connection);
+
   if (!PIsDescendant(&connection, OpalPCSSConnection))
     Ekiga::Runtime::run_in_main (boost::bind (boost::ref (ringing), this->shared_from_this ()));
 
@@ -608,6 +699,21 @@ Opal::Call::OnAlerting (OpalConnection & connection)
 }
 
 
+/* The call events are traced under the call token, but the SIP messages
+ * under their Call-ID : this tells the analyser they go together
+ */
+void
+Opal::Call::trace_call_id (OpalConnection & connection)
+{
+  if (call_id_traced || !Ekiga::TraceRing::is_enabled () || !PIsDescendant (&connection, SIPConnection))
+    return;
+
+  call_id_traced = true;
+  EKIGA_TRACE (TraceCallIdMapped, 0, (const char*) GetToken (),
+               (const char*) dynamic_cast<SIPConnection &> (connection).GetDialog ().GetCallID ());
+}
+
+
 void
 Opal::Call::OnHold (OpalConnection & /*connection*/,
                     bool /*from_remote*/,
@@ -631,6 +737,8 @@ Opal::Call::OnOpenMediaStream (OpalMediaStream & stream)
   std::transform (stream_name.begin (), stream_name.end (), stream_name.begin (), (int (*) (int)) toupper);
   is_transmitting = !stream.IsSource ();
 
+  EKIGA_TRACE (TraceMediaOpened, is_transmitting, (const char*) GetToken (), stream_name.c_str ());
+
   Ekiga::Runtime::run_in_main (boost::bind (boost::ref (stream_opened), this->shared_from_this (), stream_name, type, is_transmitting));
 
   if (type == Ekiga::Call::Video)
@@ -650,6 +758,8 @@ Opal::Call::OnClosedMediaStream (OpalMediaStream & stream)
   std::transform (stream_name.begin (), stream_name.end (), stream_name.begin (), (int (*) (int)) toupper);
   is_transmitting = !stream.IsSource ();
 
+  EKIGA_TRACE (TraceMediaClosed, is_transmitting, (const char*) GetToken (), stream_name.c_str ());
+
   Ekiga::Runtime::run_in_main (boost::bind (boost::ref (stream_closed), this->shared_from_this (), stream_name, type, is_transmitting));
 }
 
@@ -674,3 +784,75 @@ Opal::Call::OnNoAnswerTimeout (PTimer &,
   else
     Clear (OpalConnection::EndedByNoAnswer);
 }
+
+
+void
+Opal::Call::OnQualityTimeout (PTimer &,
+                              INT)
+{
+  /* The quality statistics have their own OpalMediaStatistics, so the
+   * rates they compute over one interval are not disturbed by the call
+   * window polling get_statistics.
+   */
+  RTCPStatistics sample;
+  collect_statistics (q_tr_a_statistics, q_re_a_statistics,
+                      q_tr_v_statistics, q_re_v_statistics,
+                      sample);
+
+  unsigned offset = 0;
+  if (start_time.IsValid ())
+    offset = (PTime () - start_time).GetSeconds ();
+
+  {
+    PWaitAndSignal m(quality_mutex);
+    quality.record (offset, sample);
+  }
+
+  adapt_video (sample);
+}
+
+
+void
+Opal::Call::adapt_video (const RTCPStatistics & sample)
+{
+  PSafePtr<OpalRTPConnection> connection = GetConnectionAs<OpalRTPConnection> ();
+  if (connection == NULL)
+    return;
+
+  OpalMediaStreamPtr stream = connection->GetMediaStream (OpalMediaType::Video (), false);
+  if (stream == NULL)
+    return;
+
+  OpalMediaFormat format = stream->GetMediaFormat ();
+  Ekiga::VideoRateSettings current = get_video_settings (format);
+
+  /* What the stream does is not what we last asked: this is a new stream,
+   * or the user changed the video preferences, which are our new limits.
+   */
+  if (current.bitrate == 0 || current.frame_rate == 0)
+    return;
+  if (!video_rate.is_started () || current != video_applied) {
+
+    video_rate.reset (current);
+    video_applied = current;
+  }
+
+  if (!video_rate.update (sample))
+    return;
+
+  const Ekiga::VideoRateSettings & target = video_rate.get_target ();
+
+  format.SetOptionInteger (OpalVideoFormat::TargetBitRateOption (), target.bitrate * 1000);
+  format.SetOptionInteger (OpalVideoFormat::FrameTimeOption (), format.GetClockRate () / target.frame_rate);
+  format.SetOptionInteger (OpalVideoFormat::FrameWidthOption (), target.width);
+  format.SetOptionInteger (OpalVideoFormat::FrameHeightOption (), target.height);
+  format.ToNormalisedOptions ();
+  stream->UpdateMediaFormat (format);
+
+  /* read back, the options may have been normalised */
+  video_applied = get_video_settings (stream->GetMediaFormat ());
+
+  PTRACE (4, "Opal::Call	Video adapted to " << target.bitrate << " kbit/s, "
+          << target.frame_rate << " fps, " << target.width << "x" << target.height
+          << " (remote loss " << sample.remote_lost_packets << "%, rtt " << sample.round_trip_time << " ms)");
+}
@@ -42,6 +42,7 @@
 #include <ep/pcss.h>
 
 #include "call.h"
+#include "video-rate-controller.h"
 
 #include "notification-core.h"
 #include "form-request-simple.h"
@@ -56,6 +57,7 @@ class GMManager;
 namespace Opal {
 
   class EndPoint;
+  class AudioBridge;
   class Call
     : public OpalCall,
       public Ekiga::Call
@@ -118,6 +120,10 @@ public:
      */
     void toggle_hold ();
 
+    /** Make the call join the local conference, or leave it
+     */
+    void toggle_conference ();
+
     /** Toggle stream transmission (if any)
      * @param type the stream type
      */
@@ -187,6 +193,10 @@ public:
 
     const RTCPStatistics & get_statistics ();
 
+    Ekiga::CallQualitySummary get_quality_summary ();
+
+    bool export_quality (const std::string & filename);
+
 
     /*
      * Opal Callbacks
@@ -223,8 +233,17 @@ private:
 
     void parse_info (OpalConnection & connection);
 
+    void trace_call_id (OpalConnection & connection);
+
     PSafePtr<OpalConnection> GetConnection ();
 
+    void collect_statistics (OpalMediaStatistics & tr_a,
+                             OpalMediaStatistics & re_a,
+                             OpalMediaStatistics & tr_v,
+                             OpalMediaStatistics & re_v,
+                             RTCPStatistics & result);
+
+    void adapt_video (const RTCPStatistics & sample);
 
     /*
      * Variables
@@ -235,11 +254,14 @@ private:
     std::string remote_application;
 
     bool call_setup;
+    bool call_id_traced;
 
     std::string forward_uri;
 
     bool outgoing;
 
+    AudioBridge & bridge;
+
     PTime start_time;
     RTCPStatistics statistics;
     OpalMediaStatistics re_a_statistics;
@@ -251,6 +273,20 @@ private:
 
     PDECLARE_NOTIFIER(PTimer, Opal::Call, OnNoAnswerTimeout);
     PTimer noAnswerTimer;
+
+    /* media quality, sampled from the timer thread */
+    PDECLARE_NOTIFIER(PTimer, Opal::Call, OnQualityTimeout);
+    PTimer qualityTimer;
+    PMutex quality_mutex;
+    Ekiga::CallQualityRecorder quality;
+    OpalMediaStatistics q_re_a_statistics;
+    OpalMediaStatistics q_tr_a_statistics;
+    OpalMediaStatistics q_re_v_statistics;
+    OpalMediaStatistics q_tr_v_statistics;
+
+    /* the transmitted video follows the network, from the same thread */
+    Ekiga::VideoRateController video_rate;
+    Ekiga::VideoRateSettings video_applied;
   };
 };
 
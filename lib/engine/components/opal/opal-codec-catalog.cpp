@@ -0,0 +1,160 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         opal-codec-catalog.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the catalog of the media
+ *                          formats known to OPAL.
+ *
+ */
+
+#include <glib/gi18n.h>
+
+#include "opal-codec-catalog.h"
+#include "known-codecs.h"
+
+
+using namespace Opal;
+
+
+const CodecCatalog::Id CodecCatalog::Unknown;
+
+
+const CodecCatalog &
+CodecCatalog::get ()
+{
+  static CodecCatalog catalog;
+
+  return catalog;
+}
+
+
+CodecCatalog::CodecCatalog ()
+{
+  OpalMediaFormatList formats;
+  OpalMediaFormat::GetAllRegisteredMediaFormats (formats);
+
+  entries.resize (formats.GetSize ());
+  for (int i = 0 ; i < formats.GetSize () ; i++) {
+
+    Entry & entry = entries[i];
+    entry.name = (const char *) formats[i];
+    entry.format = formats[i];
+    entry.video = (formats[i].GetMediaType () == OpalMediaType::Video ());
+    for (PINDEX j = 0 ; KnownCodecs[j][0] ; j++) {
+      if (entry.name == KnownCodecs[j][0]) {
+        entry.known_name = gettext (KnownCodecs[j][1]);
+        entry.known_info = gettext (KnownCodecs[j][2]);
+        break;
+      }
+    }
+    ids[entry.name] = i;
+  }
+
+  /* What ekiga offers: the transportable audio and video formats, minus
+   * a few which don't work well */
+  formats.RemoveNonTransportable ();
+
+  OpalMediaFormatList black_list;
+
+  black_list += "Linear-16-Stereo-48kHz";
+  black_list += "LPC-10";
+  black_list += "Speex*";
+  black_list += "FECC*";
+  black_list += "RFC4175*";
+
+  // Blacklist NSE, since it is unused in ekiga and might create
+  // problems with some registrars (such as Eutelia)
+  black_list += "NamedSignalEvent";
+
+  // Only keep OPUS in mono mode (for VoIP chat)
+  // and with the maximum sample rate
+  black_list += "Opus-8*";
+  black_list += "Opus-12*";
+  black_list += "Opus-16*";
+  black_list += "Opus-24*";
+  black_list += "Opus-48S";
+
+  // Only include the VP8 RFC version of the capability
+  black_list += "VP8-OM";
+
+  // Purge blacklisted codecs
+  formats -= black_list;
+
+  for (int i = 0 ; i < formats.GetSize () ; i++) {
+
+    if (formats[i].GetMediaType () != OpalMediaType::Audio ()
+        && formats[i].GetMediaType () != OpalMediaType::Video ())
+      continue;
+
+    Id id = find ((const char *) formats[i]);
+    if (id != Unknown)
+      allowed.push_back (id);
+  }
+
+  PTRACE(4, "Ekiga\tAll available audio & video media formats: " << setfill (',') << formats);
+}
+
+
+CodecCatalog::Id
+CodecCatalog::find (const std::string & name) const
+{
+  boost::unordered_map<std::string, Id>::const_iterator iter = ids.find (name);
+
+  return (iter != ids.end ()) ? iter->second : Unknown;
+}
+
+
+const std::string &
+CodecCatalog::get_known_name (const std::string & name) const
+{
+  Id id = find (name);
+
+  return (id != Unknown) ? entries[id].known_name : empty;
+}
+
+
+PStringArray
+CodecCatalog::get_mask (const std::vector<Id> & order) const
+{
+  std::vector<bool> kept (entries.size (), false);
+  PStringArray mask;
+
+  for (std::vector<Id>::const_iterator iter = order.begin ();
+       iter != order.end ();
+       ++iter)
+    if (*iter >= 0 && *iter < (Id) entries.size ())
+      kept[*iter] = true;
+
+  for (size_t i = 0 ; i < entries.size () ; i++)
+    if (!kept[i])
+      mask += entries[i].name.c_str ();
+
+  return mask;
+}
@@ -0,0 +1,125 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         opal-codec-catalog.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the catalog of the media
+ *                          formats known to OPAL.
+ *
+ */
+
+#ifndef __OPAL_CODEC_CATALOG_H__
+#define __OPAL_CODEC_CATALOG_H__
+
+#include <ptlib.h>
+#include <opal/manager.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace Opal {
+
+  /* The media formats registered with OPAL don't change once the plugins
+   * are loaded, but looking one of them up means copying the whole
+   * registry, and matching names against KnownCodecs means string
+   * compares: the catalog does both once, numbers the formats, and then
+   * answers by id or by name in constant time.
+   *
+   * It only keeps what doesn't change: the options of the registered
+   * formats (sizes, bitrates...) have to be read from OPAL.
+   */
+  class CodecCatalog : boost::noncopyable
+    {
+  public:
+
+      /* An index in the catalog ; Unknown is for names which aren't */
+      typedef int Id;
+      static const Id Unknown = -1;
+
+      /* The catalog, built on the first call: the call manager does it
+       * when it starts, so that the calls don't have to */
+      static const CodecCatalog & get ();
+
+      Id find (const std::string & name) const;
+
+      size_t size () const
+      { return entries.size (); }
+
+      const std::string & get_name (Id id) const
+      { return entries[id].name; }
+
+      /* The format as it was registered when the catalog was built */
+      const OpalMediaFormat & get_format (Id id) const
+      { return entries[id].format; }
+
+      bool is_video (Id id) const
+      { return entries[id].video; }
+
+      /* The translated name and description from KnownCodecs, or empty
+       * strings for the formats it doesn't know */
+      const std::string & get_known_name (Id id) const
+      { return entries[id].known_name; }
+
+      const std::string & get_known_info (Id id) const
+      { return entries[id].known_info; }
+
+      /* Same as above, by name, empty if the format isn't in the catalog */
+      const std::string & get_known_name (const std::string & name) const;
+
+      /* The audio and video formats ekiga offers to the user, in the
+       * registry order */
+      const std::vector<Id> & get_allowed () const
+      { return allowed; }
+
+      /* The formats to disable so that only those in order are used, in
+       * the form OpalManager::SetMediaFormatMask wants */
+      PStringArray get_mask (const std::vector<Id> & order) const;
+
+  private:
+      CodecCatalog ();
+
+      struct Entry
+      {
+        std::string name;
+        OpalMediaFormat format;
+        bool video;
+        std::string known_name;
+        std::string known_info;
+      };
+
+      std::vector<Entry> entries;
+      boost::unordered_map<std::string, Id> ids;
+      std::vector<Id> allowed;
+      std::string empty;
+    };
+}
+#endif
@@ -37,7 +37,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "opal-codec-description.h"
-#include "known-codecs.h"
+#include "opal-codec-catalog.h"
 
 
 using namespace Opal;
@@ -58,12 +58,11 @@ CodecDescription::CodecDescription (const OpalMediaFormat & _format,
   if (_format.IsValidForProtocol ("H.323"))
     protocols.push_back ("H.323");
   protocols.sort ();
-  for (PINDEX i = 0 ; KnownCodecs[i][0] ; i++) {
-    if (name == KnownCodecs[i][0]) {
-      display_name = gettext (KnownCodecs[i][1]);
-      display_info = gettext (KnownCodecs[i][2]);
-      break;
-    }
+  const CodecCatalog & catalog = CodecCatalog::get ();
+  CodecCatalog::Id id = catalog.find (name);
+  if (id != CodecCatalog::Unknown) {
+    display_name = catalog.get_known_name (id);
+    display_info = catalog.get_known_info (id);
   }
   if (display_name.empty ())
     display_name = name;
@@ -76,12 +75,18 @@ CodecDescription::CodecDescription (const OpalMediaFormat & _format,
 void
 CodecList::load (const std::list<std::string> & codecs_config)
 {
-  OpalMediaFormatList formats;
-  GetAllowedFormats (formats);
+  const CodecCatalog & catalog = CodecCatalog::get ();
+  const std::vector<CodecCatalog::Id> & allowed = catalog.get_allowed ();
+  std::vector<bool> offered (catalog.size (), false);
+  std::vector<bool> added (catalog.size (), false);
 
   clear ();
 
-  // FIXME: This is not very efficient.
+  for (std::vector<CodecCatalog::Id>::const_iterator iter = allowed.begin ();
+       iter != allowed.end ();
+       ++iter)
+    offered[*iter] = true;
+
   // We add each codec of the string list to our own internal list
   for (std::list<std::string>::const_iterator iter = codecs_config.begin ();
        iter != codecs_config.end ();
@@ -90,65 +95,25 @@ CodecList::load (const std::list<std::string> & codecs_config)
     std::vector<std::string> strs;
     boost::split (strs, *iter, boost::is_any_of (":"));
 
-    for (int i = 0 ; i < formats.GetSize () ; i++) {
-      // Found our codec in the formats, add it to our
-      // internal lists
-      if (strs[0] == (const char *) formats[i]) {
-        CodecDescription d (formats[i], (strs[1] == "1"));
-        append (d);
-        formats -= formats[i];
-        break;
-      }
+    CodecCatalog::Id id = catalog.find (strs[0]);
+    if (id != CodecCatalog::Unknown && offered[id] && !added[id]) {
+
+      CodecDescription d (catalog.get_format (id), (strs.size () > 1 && strs[1] == "1"));
+      append (d);
+      added[id] = true;
     }
   }
 
   // We will now add codecs which were not part of the codecs_config
   // list but that we support (ie all codecs from "list").
-  for (int i = 0 ; i < formats.GetSize () ; i++) {
-    CodecDescription d (formats[i], false);
-    append (d);
-  }
-}
+  for (std::vector<CodecCatalog::Id>::const_iterator iter = allowed.begin ();
+       iter != allowed.end ();
+       ++iter) {
 
+    if (!added[*iter]) {
 
-void
-CodecList::GetAllowedFormats (OpalMediaFormatList & formats)
-{
-  OpalMediaFormat::GetAllRegisteredMediaFormats (formats);
-  formats.RemoveNonTransportable ();
-
-  OpalMediaFormatList black_list;
-
-  black_list += "Linear-16-Stereo-48kHz";
-  black_list += "LPC-10";
-  black_list += "Speex*";
-  black_list += "FECC*";
-  black_list += "RFC4175*";
-
-  // Blacklist NSE, since it is unused in ekiga and might create
-  // problems with some registrars (such as Eutelia)
-  black_list += "NamedSignalEvent";
-
-  // Only keep OPUS in mono mode (for VoIP chat)
-  // and with the maximum sample rate
-  black_list += "Opus-8*";
-  black_list += "Opus-12*";
-  black_list += "Opus-16*";
-  black_list += "Opus-24*";
-  black_list += "Opus-48S";
-
-  // Only include the VP8 RFC version of the capability
-  black_list += "VP8-OM";
-
-  // Purge blacklisted codecs
-  formats -= black_list;
-
-  // Only keep audio and video codecs
-  for (int i = 0 ; i < formats.GetSize () ; i++) {
-    if (formats[i].GetMediaType () != OpalMediaType::Audio ()
-        && formats[i].GetMediaType () != OpalMediaType::Video ())
-      formats -= formats[i];
+      CodecDescription d (catalog.get_format (*iter), false);
+      append (d);
+    }
   }
-
-  PTRACE(4, "Ekiga\tAll available audio & video media formats: " << setfill (',') << formats);
 }
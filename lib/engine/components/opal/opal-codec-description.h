@@ -71,9 +71,6 @@ namespace Opal {
        */
       void load (const std::list<std::string> & codecs_config);
 
-
-  private:
-      void GetAllowedFormats (OpalMediaFormatList & list);
     };
 }
 #endif
@@ -131,6 +131,21 @@ public:
   const std::string get_name () const
   { return "OPAL"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("contact-core");
+    result.push_back ("presence-core");
+    result.push_back ("call-core");
+    result.push_back ("account-core");
+    result.push_back ("audioinput-core");
+    result.push_back ("videoinput-core");
+    result.push_back ("audiooutput-core");
+    result.push_back ("videooutput-core");
+    result.push_back ("personal-details");
+    return result;
+  }
+
   bool result;
   bool bank_created;
 };
@@ -48,15 +48,18 @@ class PSoundChannel_EKIGA_PluginDeviceDescriptor : public PPluginDeviceDescripto
 {
 public:
 
-  PSoundChannel_EKIGA_PluginDeviceDescriptor ()
+  PSoundChannel_EKIGA_PluginDeviceDescriptor ():
+    audioinput_core(NULL),
+    audiooutput_core(NULL)
   {
     // FIXME: this is due to opal's PFactory design
     PAssertAlways("This constructor is not to be called");
   }
 
-  PSoundChannel_EKIGA_PluginDeviceDescriptor (Ekiga::ServiceCore& core):
-    audioinput_core(core.get<Ekiga::AudioInputCore> ("audioinput-core")),
-    audiooutput_core(core.get<Ekiga::AudioOutputCore> ("audiooutput-core"))
+  PSoundChannel_EKIGA_PluginDeviceDescriptor (const Ekiga::ServiceHandle<Ekiga::AudioInputCore>* audioinput_core_,
+                                              const Ekiga::ServiceHandle<Ekiga::AudioOutputCore>* audiooutput_core_):
+    audioinput_core(audioinput_core_),
+    audiooutput_core(audiooutput_core_)
   {}
 
   const char* GetServiceType () const
@@ -67,9 +70,8 @@ public:
 
   virtual PObject* CreateInstance (P_INT_PTR) const
   {
-    // FIXME: if that happens in a thread, that's bad...
-    boost::shared_ptr<Ekiga::AudioInputCore> input = audioinput_core.lock ();
-    boost::shared_ptr<Ekiga::AudioOutputCore> output = audiooutput_core.lock ();
+    boost::shared_ptr<Ekiga::AudioInputCore> input = audioinput_core->get ();
+    boost::shared_ptr<Ekiga::AudioOutputCore> output = audiooutput_core->get ();
     if (input && output)
       return new PSoundChannel_EKIGA (input, output);
     else
@@ -84,22 +86,23 @@ public:
   { return deviceName.Find ("EKIGA") == 0; }
 
 private:
-  boost::weak_ptr<Ekiga::AudioInputCore> audioinput_core;
-  boost::weak_ptr<Ekiga::AudioOutputCore> audiooutput_core;
+  const Ekiga::ServiceHandle<Ekiga::AudioInputCore>* audioinput_core;
+  const Ekiga::ServiceHandle<Ekiga::AudioOutputCore>* audiooutput_core;
 };
 
 class PVideoInputDevice_EKIGA_PluginDeviceDescriptor : public PPluginDeviceDescriptor
 {
 public:
 
-  PVideoInputDevice_EKIGA_PluginDeviceDescriptor ()
+  PVideoInputDevice_EKIGA_PluginDeviceDescriptor ():
+    videoinput_core(NULL)
   {
     // FIXME: this is due to opal's PFactory design
     PAssertAlways("This constructor is not to be called");
   }
 
-  PVideoInputDevice_EKIGA_PluginDeviceDescriptor (Ekiga::ServiceCore& core):
-    videoinput_core(core.get<Ekiga::VideoInputCore> ("videoinput-core"))
+  PVideoInputDevice_EKIGA_PluginDeviceDescriptor (const Ekiga::ServiceHandle<Ekiga::VideoInputCore>* videoinput_core_):
+    videoinput_core(videoinput_core_)
   {}
 
   const char* GetServiceType () const
@@ -110,8 +113,7 @@ public:
 
   virtual PObject* CreateInstance (P_INT_PTR) const
   {
-    // FIXME: if it happens in a thread, that's bad...
-    boost::shared_ptr<Ekiga::VideoInputCore> output = videoinput_core.lock ();
+    boost::shared_ptr<Ekiga::VideoInputCore> output = videoinput_core->get ();
     if (output)
       return new PVideoInputDevice_EKIGA (output);
     else
@@ -127,21 +129,22 @@ public:
 
 private:
 
-  boost::weak_ptr<Ekiga::VideoInputCore> videoinput_core;
+  const Ekiga::ServiceHandle<Ekiga::VideoInputCore>* videoinput_core;
 };
 
 class PVideoOutputDevice_EKIGA_PluginDeviceDescriptor : public PPluginDeviceDescriptor
 {
 public:
 
-  PVideoOutputDevice_EKIGA_PluginDeviceDescriptor ()
+  PVideoOutputDevice_EKIGA_PluginDeviceDescriptor ():
+    videooutput_core(NULL)
   {
     // FIXME: this is due to opal's PFactory design
     PAssertAlways("This constructor is not to be called");
   }
 
-  PVideoOutputDevice_EKIGA_PluginDeviceDescriptor (Ekiga::ServiceCore& core):
-    videooutput_core(core.get<Ekiga::VideoOutputCore> ("videooutput-core"))
+  PVideoOutputDevice_EKIGA_PluginDeviceDescriptor (const Ekiga::ServiceHandle<Ekiga::VideoOutputCore>* videooutput_core_):
+    videooutput_core(videooutput_core_)
   {}
 
   const char* GetServiceType () const
@@ -152,8 +155,7 @@ public:
 
   virtual PObject *CreateInstance (P_INT_PTR) const
   {
-    // FIXME: if it happens in a thread, that's bad...
-    boost::shared_ptr<Ekiga::VideoOutputCore> output = videooutput_core.lock ();
+    boost::shared_ptr<Ekiga::VideoOutputCore> output = videooutput_core->get ();
     if (output)
       return new PVideoOutputDevice_EKIGA (output);
     else
@@ -169,7 +171,7 @@ public:
 
 private:
 
-  boost::weak_ptr<Ekiga::VideoOutputCore> videooutput_core;
+  const Ekiga::ServiceHandle<Ekiga::VideoOutputCore>* videooutput_core;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -182,13 +184,15 @@ struct opal_audio_worker:
 {
   opal_audio_worker (Ekiga::ServiceCore& core_):
     PPluginFactory::Worker<PSoundChannel_EKIGA_PluginDeviceDescriptor> ("PSoundChannelEKIGA"),
-    core(core_)
+    audioinput_core(core_, Ekiga::audioinput_core_key),
+    audiooutput_core(core_, Ekiga::audiooutput_core_key)
   {}
 
   PPluginDeviceDescriptor* Create (PPluginFactory::Param_T) const
-  { return new PSoundChannel_EKIGA_PluginDeviceDescriptor (core); }
+  { return new PSoundChannel_EKIGA_PluginDeviceDescriptor (&audioinput_core, &audiooutput_core); }
 
-  Ekiga::ServiceCore& core;
+  Ekiga::ServiceHandle<Ekiga::AudioInputCore> audioinput_core;
+  Ekiga::ServiceHandle<Ekiga::AudioOutputCore> audiooutput_core;
 };
 
 struct opal_videoinput_worker:
@@ -196,13 +200,13 @@ struct opal_videoinput_worker:
 {
   opal_videoinput_worker (Ekiga::ServiceCore& core_):
     PPluginFactory::Worker<PVideoInputDevice_EKIGA_PluginDeviceDescriptor> ("PVideoInputDeviceEKIGA"),
-    core(core_)
+    videoinput_core(core_, Ekiga::videoinput_core_key)
   {}
 
   PPluginDeviceDescriptor* Create (PPluginFactory::Param_T) const
-  { return new PVideoInputDevice_EKIGA_PluginDeviceDescriptor (core); }
+  { return new PVideoInputDevice_EKIGA_PluginDeviceDescriptor (&videoinput_core); }
 
-  Ekiga::ServiceCore& core;
+  Ekiga::ServiceHandle<Ekiga::VideoInputCore> videoinput_core;
 };
 
 struct opal_videooutput_worker:
@@ -210,13 +214,13 @@ struct opal_videooutput_worker:
 {
   opal_videooutput_worker (Ekiga::ServiceCore& core_):
     PPluginFactory::Worker<PVideoOutputDevice_EKIGA_PluginDeviceDescriptor> ("PVideoOutputDeviceEKIGA"),
-    core(core_)
+    videooutput_core(core_, Ekiga::videooutput_core_key)
   {}
 
   PPluginDeviceDescriptor* Create (PPluginFactory::Param_T) const
-  { return new PVideoOutputDevice_EKIGA_PluginDeviceDescriptor (core); }
+  { return new PVideoOutputDevice_EKIGA_PluginDeviceDescriptor (&videooutput_core); }
 
-  Ekiga::ServiceCore& core;
+  Ekiga::ServiceHandle<Ekiga::VideoOutputCore> videooutput_core;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -238,12 +242,30 @@ struct opal_plugins_hook_workers
 
 static boost::shared_ptr<opal_plugins_hook_workers> workers;
 
+/* the EKIGA devices are only offered to PTLIB once the cores behind them
+ * are there : before, they couldn't be opened anyway */
+static void
+register_service (const char* service)
+{
+  PPluginManager::GetPluginManager().RegisterService (service);
+}
+
+static void
+on_audioinput_core (Ekiga::ServiceCore& core)
+{
+  core.when_available (Ekiga::audiooutput_core_key,
+                       boost::bind (&register_service, "PSoundChannelEKIGA"));
+}
+
 void
 hook_ekiga_plugins_to_opal (Ekiga::ServiceCore& core)
 {
   workers = boost::shared_ptr<opal_plugins_hook_workers> (new opal_plugins_hook_workers (core));
 
-  PPluginManager::GetPluginManager().RegisterService ("PSoundChannelEKIGA");
-  PPluginManager::GetPluginManager().RegisterService ("PVideoInputDeviceEKIGA");
-  PPluginManager::GetPluginManager().RegisterService ("PVideoOutputDeviceEKIGA");
+  core.when_available (Ekiga::audioinput_core_key,
+                       boost::bind (&on_audioinput_core, boost::ref (core)));
+  core.when_available (Ekiga::videoinput_core_key,
+                       boost::bind (&register_service, "PVideoInputDeviceEKIGA"));
+  core.when_available (Ekiga::videooutput_core_key,
+                       boost::bind (&register_service, "PVideoOutputDeviceEKIGA"));
 }
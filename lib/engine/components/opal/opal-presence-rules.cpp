@@ -0,0 +1,263 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+/*
+ *                         opal-presence-rules.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of how the presence notifications
+ *                          map to presentities and presence states.
+ *
+ */
+
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include <libxml/parser.h>
+
+#include "opal-presence-rules.h"
+
+std::string
+Opal::index_key (const std::string & uri)
+{
+  std::string result = uri.substr (0, uri.find (";"));
+  const size_t colon = result.find (":");
+  const size_t at = result.find ("@");
+
+  if (colon != std::string::npos)
+    for (size_t i = 0 ; i < colon ; i++)
+      result[i] = g_ascii_tolower (result[i]);
+  if (at != std::string::npos)
+    for (size_t i = at + 1 ; i < result.length () ; i++)
+      result[i] = g_ascii_tolower (result[i]);
+
+  if (!result.compare (0, 5, "pres:"))
+    result.replace (0, 5, "sip:");
+
+  return result;
+}
+
+const Opal::PresenceRule Opal::note_rules[] = {
+  { "dnd", 0, "busy", NULL },
+  { "meeting", 0, "busy", NULL },
+  { "do not disturb", 0, "busy", NULL },
+  { "busy", 0, "busy", NULL },
+  { "away", 1, "away", NULL },
+  { "out", 1, "away", NULL },
+  { "vacation", 1, "away", NULL },
+  { "holiday", 1, "away", NULL },
+  { "lunch", 1, "away", NULL },
+  { "phone", 2, "inacall", NULL },
+  { "ringing", 2, "inacall", NULL },
+  { "call", 2, "inacall", NULL }
+};
+
+const unsigned Opal::note_rules_size = G_N_ELEMENTS (Opal::note_rules);
+
+const Opal::PresenceRule Opal::activity_rules[] = {
+  { "busy", 0, "busy", NULL },
+  { "away", 1, "away", NULL },
+  { "appointment", 3, "away", N_("Appointment") },
+  { "breakfast", 4, "away", N_("Breakfast") },
+  { "dinner", 5, "away", N_("Dinner") },
+  { "vacation", 6, "away", N_("Holiday") },
+  { "holiday", 6, "away", N_("Holiday") },
+  { "in-transit", 7, "away", N_("In transit") },
+  { "looking-for-work", 8, "away", N_("Looking for work") },
+  { "lunch", 9, "away", N_("Lunch") },
+  { "meal", 10, "away", N_("Meal") },
+  { "meeting", 11, "away", N_("Meeting") },
+  { "on-the-phone", 12, "inacall", N_("On the phone") },
+  { "playing", 13, "away", N_("Playing") },
+  { "shopping", 14, "away", N_("Shopping") },
+  { "sleeping", 15, "away", N_("Sleeping") },
+  { "working", 16, "busy", N_("Working") },
+  { "other", 17, "away", "" },
+  { "performance", 18, "away", N_("Performance") },
+  { "permanent-absence", 19, "away", N_("Permanent Absence") },
+  { "presentation", 20, "away", N_("Presentation") },
+  { "spectator", 21, "away", N_("Spectator") },
+  { "steering", 22, "away", N_("Steering") },
+  { "travel", 23, "away", N_("Business or personal trip") },
+  { "tv", 24, "away", N_("Watching TV") },
+  { "worship", 25, "away", N_("Worship") }
+};
+
+const unsigned Opal::activity_rules_size = G_N_ELEMENTS (Opal::activity_rules);
+
+const Opal::PresenceRule*
+Opal::classify_presence (const PCaselessString & note,
+                         const PStringSet & activities)
+{
+  const PresenceRule* best = NULL;
+
+  for (unsigned i = 0 ; i < note_rules_size && best == NULL ; i++)
+    if (note.Find (note_rules[i].keyword) != P_MAX_INDEX)
+      best = &note_rules[i];
+
+  // the rules are sorted by rank, so the first match is the best
+  for (unsigned i = 0 ; i < activity_rules_size ; i++)
+    if (best != NULL && activity_rules[i].rank >= best->rank)
+      break;
+    else if (activities.Contains (activity_rules[i].keyword)) {
+      best = &activity_rules[i];
+      break;
+    }
+
+  return best;
+}
+
+/* looks for the basic status, the first note and the RPID activities
+ * anywhere in a PIDF document -- they can be in tuples or in persons
+ */
+static void
+collect_pidf (xmlNodePtr parent,
+              bool & open,
+              PString & note,
+              PStringSet & activities)
+{
+  for (xmlNodePtr child = parent->children; child != NULL; child = child->next) {
+
+    if (child->type != XML_ELEMENT_NODE || child->name == NULL)
+      continue;
+
+    if (xmlStrEqual (BAD_CAST "basic", child->name)) {
+
+      xmlChar* xml_str = xmlNodeGetContent (child);
+      if (xml_str != NULL) {
+
+        if (xmlStrEqual (BAD_CAST "open", xml_str))
+          open = true;
+        xmlFree (xml_str);
+      }
+    }
+    else if (xmlStrEqual (BAD_CAST "note", child->name)) {
+
+      xmlChar* xml_str = xmlNodeGetContent (child);
+      if (xml_str != NULL) {
+
+        if (note.IsEmpty ())
+          note = (const char*) xml_str;
+        xmlFree (xml_str);
+      }
+    }
+    else if (xmlStrEqual (BAD_CAST "activities", child->name)) {
+
+      for (xmlNodePtr activity = child->children; activity != NULL; activity = activity->next)
+        if (activity->type == XML_ELEMENT_NODE && activity->name != NULL
+            && !xmlStrEqual (BAD_CAST "note", activity->name))
+          activities.Include (PString ((const char*) activity->name));
+    }
+    else
+      collect_pidf (child, open, note, activities);
+  }
+}
+
+void
+Opal::parse_presence_notification (const std::string & body,
+                                   std::list<PresenceUpdate> & updates)
+{
+  xmlDocPtr doc = xmlReadMemory (body.c_str (), body.length (), NULL, NULL, XML_PARSE_NONET);
+  xmlNodePtr root = (doc != NULL) ? xmlDocGetRootElement (doc) : NULL;
+
+  if (root != NULL && root->name != NULL && xmlStrEqual (BAD_CAST "presence", root->name)) {
+
+    // the presence of one resource of the list (RFC 3863, with RFC 4480)
+    PresenceUpdate update;
+    bool open = false;
+    PString note;
+    PStringSet activities;
+    xmlChar* xml_str = xmlGetProp (root, BAD_CAST "entity");
+
+    if (xml_str != NULL) {
+
+      update.uri = (const char*) xml_str;
+      xmlFree (xml_str);
+    }
+    collect_pidf (root, open, note, activities);
+
+    if (!update.uri.empty ()) {
+
+      update.note = (const char*) note;
+      if (open) {
+
+        const PresenceRule* rule = classify_presence (note, activities);
+
+        update.presence = "available";
+        if (rule != NULL) {
+
+          update.presence = rule->presence;
+          if (rule->note != NULL)
+            update.note = (*rule->note ? gettext (rule->note) : "");
+        }
+      }
+      else
+        update.presence = "offline";
+      updates.push_back (update);
+    }
+  }
+  else if (root != NULL && root->name != NULL && xmlStrEqual (BAD_CAST "list", root->name)) {
+
+    // the list meta-information (RFC 4662) : we only care about the
+    // resources the server will not give us the presence of
+    for (xmlNodePtr resource = root->children; resource != NULL; resource = resource->next) {
+
+      if (resource->type != XML_ELEMENT_NODE || resource->name == NULL
+          || !xmlStrEqual (BAD_CAST "resource", resource->name))
+        continue;
+
+      bool terminated = false;
+      for (xmlNodePtr instance = resource->children; instance != NULL; instance = instance->next) {
+
+        if (instance->type == XML_ELEMENT_NODE && instance->name != NULL
+            && xmlStrEqual (BAD_CAST "instance", instance->name)) {
+
+          xmlChar* xml_str = xmlGetProp (instance, BAD_CAST "state");
+          if (xml_str != NULL) {
+
+            terminated = xmlStrEqual (BAD_CAST "terminated", xml_str);
+            xmlFree (xml_str);
+          }
+        }
+      }
+
+      xmlChar* xml_str = xmlGetProp (resource, BAD_CAST "uri");
+      if (xml_str != NULL) {
+
+        if (terminated) {
+
+          PresenceUpdate update;
+          update.uri = (const char*) xml_str;
+          update.presence = "unknown";
+          updates.push_back (update);
+        }
+        xmlFree (xml_str);
+      }
+    }
+  }
+
+  if (doc != NULL)
+    xmlFreeDoc (doc);
+}
@@ -0,0 +1,94 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         opal-presence-rules.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of how the presence notifications
+ *                          map to presentities and presence states.
+ *
+ */
+
+#ifndef __OPAL_PRESENCE_RULES_H__
+#define __OPAL_PRESENCE_RULES_H__
+
+#include <list>
+#include <string>
+
+#include <ptlib.h>
+
+namespace Opal
+{
+  /* the key used to index presentities: the scheme and host are not case
+   * sensitive, the uri parameters are not significant, and opal sometimes
+   * gives us "pres:" uris for "sip:" ones
+   */
+  std::string index_key (const std::string & uri);
+
+  /* How the note and the RFC 4480 activities of a presence notification
+   * map to our presence states.
+   *
+   * Some older PABX systems only give a custom note, so the note keywords
+   * come first, then the activities, in order of importance : when the
+   * user has several activities at once, the most important one wins.
+   */
+  struct PresenceRule
+  {
+    const char* keyword;
+    unsigned rank;
+    const char* presence;
+    const char* note;  // NULL to keep the note from the notification
+  };
+
+  extern const PresenceRule note_rules[];
+  extern const unsigned note_rules_size;
+
+  /* sorted by rank */
+  extern const PresenceRule activity_rules[];
+  extern const unsigned activity_rules_size;
+
+  /* returns the best matching rule, or NULL if none matched */
+  const PresenceRule* classify_presence (const PCaselessString & note,
+                                         const PStringSet & activities);
+
+  /* what a presence notification says of one uri */
+  struct PresenceUpdate
+  {
+    std::string uri;
+    std::string presence;
+    std::string note;
+  };
+
+  /* Parses one part of a presence list notification : the presence of a
+   * resource (RFC 3863, with RFC 4480), or the list meta-information
+   * (RFC 4662). The updates it gives are added at the end of the list.
+   */
+  void parse_presence_notification (const std::string & body,
+                                    std::list<PresenceUpdate> & updates);
+};
+
+#endif
@@ -333,6 +333,7 @@ Opal::Presentity::edit_presentity_form_submitted (bool submitted,
 
   if (uri != new_uri) {
     xmlSetProp (node, (const xmlChar*)"uri", (const xmlChar*)new_uri.c_str ());
+    account.index_presentity (this->shared_from_this ());
     account.unfetch (uri);
     account.fetch (new_uri);
     Ekiga::Runtime::run_in_main (boost::bind (&Opal::Account::presence_status_in_main, &account, new_uri, "unknown", ""));
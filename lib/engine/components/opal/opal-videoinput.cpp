@@ -40,7 +40,9 @@
 int PVideoInputDevice_EKIGA::devices_nbr = 0;
 
 PVideoInputDevice_EKIGA::PVideoInputDevice_EKIGA (boost::shared_ptr<Ekiga::VideoInputCore> _videoinput_core):
-  videoinput_core(_videoinput_core)
+  videoinput_core(_videoinput_core),
+  grab_timing("video grab interval"),
+  last_frame_time(0)
 {
   opened = false;
   is_active = false;
@@ -89,6 +91,7 @@ PVideoInputDevice_EKIGA::Close ()
     is_active = false;
   }
   opened = false;
+  last_frame_time = 0;
 
   return true;
 }
@@ -149,8 +152,14 @@ bool
 PVideoInputDevice_EKIGA::GetFrameData (BYTE *frame,
 				       PINDEX *i)
 {
+  if (Ekiga::StageTiming::is_enabled () && last_frame_time != 0)
+    grab_timing.add (g_get_monotonic_time () - last_frame_time);
+
   videoinput_core->get_frame_data((char*)frame);
 
+  if (Ekiga::StageTiming::is_enabled ())
+    last_frame_time = g_get_monotonic_time ();
+
   *i = frameWidth * frameHeight * 3 / 2;
 
   return true;
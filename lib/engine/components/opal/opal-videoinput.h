@@ -43,6 +43,7 @@
 #include <opal/manager.h>
 
 #include "videoinput-core.h"
+#include "stage-timing.h"
 
 class PVideoInputDevice_EKIGA : public PVideoInputDevice
 {
@@ -176,6 +177,13 @@ class PVideoInputDevice_EKIGA : public PVideoInputDevice
 protected:
   boost::shared_ptr<Ekiga::VideoInputCore> videoinput_core;
 
+  /* the time between two of our GetFrameData : what OPAL does with a
+   * frame (encoding, sending it) plus its pacing, so it isn't the encoding
+   * cost, but when it goes over the frame period, the encoder doesn't
+   * keep up with the capture */
+  Ekiga::StageTiming grab_timing;
+  gint64 last_frame_time;
+
   bool opened;
 };
 
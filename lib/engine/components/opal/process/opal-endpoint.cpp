@@ -37,6 +37,8 @@
 
 
 #include <algorithm>
+#include <set>
+#include <sstream>
 #include <glib/gi18n.h>
 
 #include "opal-call-manager.h"
@@ -48,6 +50,7 @@
 #include "videoinput-info.h"
 
 #include "call-manager.h"
+#include "runtime.h"
 
 #include "sip-endpoint.h"
 #ifdef HAVE_H323
@@ -66,6 +69,29 @@ struct null_deleter
 };
 
 
+/* how many seconds we wait for the STUN detection to finish */
+#define STUN_PATIENCE 20
+
+/* how many networks we remember the NAT type of */
+#define STUN_CACHE_SIZE 8
+
+/* UnknownNat is what we get when no server answered : it says nothing
+ * about the network, so it is neither usable nor worth remembering
+ */
+static bool
+is_usable_nat_type (PSTUNClient::NatTypes result)
+{
+  return (result != PSTUNClient::UnknownNat
+          && result != PSTUNClient::SymmetricNat
+          && result != PSTUNClient::BlockedNat
+          && result != PSTUNClient::PartiallyBlocked);
+}
+
+/* This thread either only probes a STUN server (when several are raced),
+ * or configures the manager with it. Its result comes back to the main loop
+ * with the generation of the detection it belongs to, so that a late one
+ * can be told apart.
+ */
 class StunDetector : public PThread
 {
   PCLASSINFO(StunDetector, PThread);
@@ -74,40 +100,63 @@ public:
 
   StunDetector (const std::string & _server,
                 Opal::EndPoint& _manager,
-                GAsyncQueue* _queue)
-    : PThread (1000, AutoDeleteThread),
+                unsigned int _generation,
+                bool _probe_only)
+    : PThread (1000, NoAutoDeleteThread),
     server (_server),
     manager (_manager),
-    queue (_queue)
+    generation (_generation),
+    probe_only (_probe_only)
   {
-    PTRACE (3, "Ekiga\tStarted STUN detector");
-    g_async_queue_ref (queue);
+    PTRACE (3, "Ekiga\tStarted STUN detector for " << server);
     this->Resume ();
   };
 
   ~StunDetector ()
     {
-      g_async_queue_unref (queue);
-      PTRACE (3, "Ekiga\tStopped STUN detector");
+      PTRACE (3, "Ekiga\tStopped STUN detector for " << server);
     }
 
   void Main ()
     {
-      PSTUNClient::NatTypes result = manager.SetSTUNServer (server);
-      g_async_queue_push (queue, GUINT_TO_POINTER ((guint)result + 1));
+      if (probe_only) {
+
+        PSTUNClient client;
+        PSTUNClient::NatTypes result = PSTUNClient::UnknownNat;
+        if (client.SetServer (server))
+          result = client.GetNatType (true);
+        Ekiga::Runtime::run_in_main (boost::bind (&Opal::EndPoint::OnSTUNProbeResult, &manager, generation, server, result));
+      }
+      else {
+
+        PSTUNClient::NatTypes result = manager.SetSTUNServer (server);
+        PNatMethod* method = manager.GetNatMethods ().GetMethodByName (PSTUNClient::MethodName ());
+        PIPSocket::Address mapped;
+        std::string address;
+        if (method != NULL && method->GetExternalAddress (mapped))
+          address = (const char*) mapped.AsString ();
+        Ekiga::Runtime::run_in_main (boost::bind (&Opal::EndPoint::OnSTUNResult, &manager, generation, server, result, address));
+      }
     };
 
 private:
   const std::string server;
   Opal::EndPoint & manager;
-  GAsyncQueue* queue;
+  unsigned int generation;
+  bool probe_only;
 };
 
 
 /* The class */
-Opal::EndPoint::EndPoint (Ekiga::ServiceCore& _core) : core(_core)
+Opal::EndPoint::EndPoint (Ekiga::ServiceCore& _core) : audio_bridge(_core), core(_core)
 {
-  stun_thread = 0;
+  stun_generation = 0;
+  stun_probes_pending = 0;
+  stun_probe_won = false;
+  stun_detecting = false;
+  stun_from_cache = false;
+  stun_cached_type = PSTUNClient::UnknownNat;
+  nat_settings = Ekiga::SettingsPtr (new Ekiga::Settings (NAT_SCHEMA));
 
   /* Initialise the endpoint parameters */
 #if P_HAS_IPV6
@@ -150,9 +199,6 @@ Opal::EndPoint::EndPoint (Ekiga::ServiceCore& _core) : core(_core)
   SetMediaFormatOrder (PStringArray ());
   SetMediaFormatMask (PStringArray ());
 
-  // used to communicate with the StunDetector
-  queue = g_async_queue_new ();
-
   PInterfaceMonitor::GetInstance().SetRefreshInterval (15000);
 
   // Create endpoints
@@ -165,16 +211,19 @@ Opal::EndPoint::EndPoint (Ekiga::ServiceCore& _core) : core(_core)
   h323_endpoint= new H323::EndPoint (*this, core);
 #endif
 
-  call_core = core.get<Ekiga::CallCore> ("call-core");
+  call_core = core.get (Ekiga::call_core_key);
 }
 
 
 Opal::EndPoint::~EndPoint ()
 {
-  if (stun_thread)
-    stun_thread->WaitForTermination ();
+  for (std::list<PThread*>::iterator iter = stun_threads.begin ();
+       iter != stun_threads.end ();
+       ++iter) {
 
-  g_async_queue_unref (queue);
+    (*iter)->WaitForTermination ();
+    delete *iter;
+  }
 
   for (PSafePtr<OpalCall> call = activeCalls; call != NULL; ++call)
     DestroyCall (call);
@@ -296,8 +345,12 @@ bool Opal::EndPoint::GetAutoAnswer (void) const
 
 void Opal::EndPoint::SetStunServer (const std::string & server)
 {
-  if (server == (const char*) GetNATServer ("STUN")) {
-    if (!isReady && !stun_thread) {
+  PStringArray servers = PString (server).Tokenise (", ", false);
+
+  // Nothing to do if the server we chose last time is still configured
+  if ((server.empty () && stun_chosen.empty ())
+      || (!stun_chosen.empty () && servers.GetValuesIndex (PString (stun_chosen)) != P_MAX_INDEX)) {
+    if (!isReady && !stun_detecting) {
       isReady = true;
       ready ();
     }
@@ -305,16 +358,53 @@ void Opal::EndPoint::SetStunServer (const std::string & server)
     return;
   }
 
-  if (!server.empty () && !stun_thread) {
+  ReapSTUNThreads ();
 
-    // Ready
-    stun_thread = new StunDetector (server, *this, queue);
-    patience = 20;
-    Ekiga::Runtime::run_in_main (boost::bind (&Opal::EndPoint::HandleSTUNResult, this), 1);
+  if (!server.empty () && !stun_detecting) {
+
+    stun_server = server;
+    stun_detecting = true;
+    stun_probe_won = false;
+    stun_generation++;
+    stun_network_key = GetNetworkKey ();
+
+    if (servers.GetSize () > 1) {
+
+      // Race them all, the winner will then be used
+      stun_probes_pending = servers.GetSize ();
+      for (PINDEX i = 0 ; i < servers.GetSize () ; i++)
+        stun_threads.push_back (new StunDetector ((const char*) servers[i], *this, stun_generation, true));
+    }
+    else {
+
+      stun_probe_won = true;
+      stun_threads.push_back (new StunDetector ((const char*) servers[0], *this, stun_generation, false));
+    }
+
+    Ekiga::Runtime::run_in_main (boost::bind (&Opal::EndPoint::HandleSTUNTimeout, this, stun_generation),
+                                 STUN_PATIENCE);
+
+    /* Ready, if we already know this network is fine : the address it
+     * mapped us to is applied right away, so that the accounts register
+     * with it, and OnSTUNResult has them register again if the detection
+     * finds out things changed
+     */
+    stun_from_cache = (!isReady
+                       && GetCachedNat (stun_cached_type, stun_cached_address)
+                       && is_usable_nat_type (stun_cached_type));
+    if (stun_from_cache) {
+
+      PTRACE (3, "Opal::EndPoint\tUsing cached NAT type " << PSTUNClient::GetNatTypeString (stun_cached_type)
+              << " and address " << stun_cached_address << ", revalidating in the background");
+      SetTranslationAddress (stun_cached_address);
+      isReady = true;
+      ready ();
+    }
   }
   else {
 
     SetSTUNServer (PString ());
+    stun_chosen.clear ();
     isReady = true;
     ready ();
   }
@@ -348,7 +438,7 @@ void Opal::EndPoint::SetVideoOptions (const Opal::EndPoint::VideoOptions & optio
   OpalMediaFormatList media_formats_list;
   OpalMediaFormat::GetAllRegisteredMediaFormats (media_formats_list);
 
-  int maximum_frame_rate = std::min (std::max ((signed) options.maximum_frame_rate, 1), 30);
+  int maximum_frame_rate = std::min (std::max ((signed) options.maximum_frame_rate, 1), 60);
   int maximum_bitrate = (options.maximum_bitrate > 0 ? options.maximum_bitrate : 16384);
   int maximum_transmitted_bitrate = (options.maximum_transmitted_bitrate > 0 ? options.maximum_transmitted_bitrate : 256);
   int temporal_spatial_tradeoff = (options.temporal_spatial_tradeoff > 0 ? options.temporal_spatial_tradeoff : 12);
@@ -481,6 +571,12 @@ void Opal::EndPoint::GetVideoOptions (Opal::EndPoint::VideoOptions & options) co
 }
 
 
+Opal::AudioBridge & Opal::EndPoint::GetAudioBridge ()
+{
+  return audio_bridge;
+}
+
+
 OpalCall *Opal::EndPoint::CreateCall (void *uri)
 {
   boost::shared_ptr<Opal::Call> call = Opal::Call::create (*this, uri ? (const char*) uri : std::string (), noAnswerDelay);
@@ -517,47 +613,205 @@ Opal::EndPoint::DestroyCall (boost::shared_ptr<Ekiga::Call> call)
 
 
 void
-Opal::EndPoint::HandleSTUNResult ()
+Opal::EndPoint::OnSTUNProbeResult (unsigned int generation,
+                                   const std::string server,
+                                   PSTUNClient::NatTypes result)
 {
-  gboolean error = false;
-  gboolean got_answer = false;
-
-  if (g_async_queue_length (queue) > 0) {
+  if (!stun_detecting || generation != stun_generation || stun_probe_won)
+    return;
 
-    PSTUNClient::NatTypes result
-      = (PSTUNClient::NatTypes)(GPOINTER_TO_UINT (g_async_queue_pop (queue))-1);
-    got_answer = true;
-    stun_thread = 0;
+  stun_probes_pending--;
 
-    if (result == PSTUNClient::SymmetricNat
-        || result == PSTUNClient::BlockedNat
-        || result == PSTUNClient::PartiallyBlocked) {
+  // The first server which answers wins, unless they all fail
+  if (result != PSTUNClient::UnknownNat) {
 
-      error = true;
-    }
-    else {
+    PTRACE (4, "Opal::EndPoint\tSTUN server " << server << " answered first");
+    stun_probe_won = true;
+    stun_threads.push_back (new StunDetector (server, *this, generation, false));
+  }
+  else if (stun_probes_pending == 0) {
 
-      isReady = true;
-      ready ();
-    }
+    OnSTUNResult (generation, std::string (), result, std::string ());
   }
-  else if (patience == 0) {
+}
+
 
-    error = true;
+void
+Opal::EndPoint::OnSTUNResult (unsigned int generation,
+                              const std::string server,
+                              PSTUNClient::NatTypes result,
+                              const std::string address)
+{
+  if (!stun_detecting || generation != stun_generation)
+    return;
+
+  stun_detecting = false;
+  ReapSTUNThreads ();
+
+  if (is_usable_nat_type (result) && !address.empty ())
+    SetCachedNat (result, address);
+  if (is_usable_nat_type (result))
+    stun_chosen = server;
+  else
+    stun_chosen.clear ();
+
+  // We got ready on the cached values : were they right?
+  if (stun_from_cache) {
+
+    stun_from_cache = false;
+    if (result != stun_cached_type || address != stun_cached_address) {
+
+      PTRACE (3, "Opal::EndPoint\tNAT changed since cached, to " << PSTUNClient::GetNatTypeString (result)
+              << " and address " << address);
+      SetTranslationAddress (is_usable_nat_type (result) ? address : std::string ());
+      nat_changed ();
+    }
   }
 
-  if (error) {
+  if (!is_usable_nat_type (result)) {
 
     ReportSTUNError (_("Ekiga did not manage to configure your network settings automatically. We suggest"
                        " you disable STUN support and relay on a SIP provider that supports NAT environments.\n\n"));
+  }
+
+  if (!isReady) {
+
     isReady = true;
     ready ();
   }
-  else if (!got_answer) {
+}
+
+
+void
+Opal::EndPoint::HandleSTUNTimeout (unsigned int generation)
+{
+  if (!stun_detecting || generation != stun_generation)
+    return;
 
-    patience--;
-    Ekiga::Runtime::run_in_main (boost::bind (&Opal::EndPoint::HandleSTUNResult, this), 1);
+  /* The threads will still finish on their own ; we just stop waiting for
+   * them, and ignore their results.
+   */
+  stun_detecting = false;
+  ReapSTUNThreads ();
+
+  // The cached values couldn't be confirmed : don't keep relying on them
+  if (stun_from_cache) {
+
+    stun_from_cache = false;
+    SetTranslationAddress (std::string ());
+    nat_changed ();
   }
+
+  ReportSTUNError (_("Ekiga did not manage to configure your network settings automatically. We suggest"
+                     " you disable STUN support and relay on a SIP provider that supports NAT environments.\n\n"));
+
+  if (!isReady) {
+
+    isReady = true;
+    ready ();
+  }
+}
+
+
+/* Only the threads which are over : the others may still be blocked in
+ * their STUN timeout, and we don't wait for them on the main loop
+ */
+void
+Opal::EndPoint::ReapSTUNThreads ()
+{
+  std::list<PThread*>::iterator iter = stun_threads.begin ();
+
+  while (iter != stun_threads.end ()) {
+
+    if ((*iter)->IsTerminated ()) {
+
+      delete *iter;
+      iter = stun_threads.erase (iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+
+const std::string
+Opal::EndPoint::GetNetworkKey () const
+{
+  std::set<std::string> addresses;
+  PIPSocket::InterfaceTable interfaces;
+  PIPSocket::Address gateway;
+  std::string result;
+
+  // The default route and our own addresses identify the network well enough
+  if (PIPSocket::GetGatewayAddress (gateway))
+    result = (const char*) gateway.AsString ();
+
+  if (PIPSocket::GetInterfaceTable (interfaces))
+    for (PINDEX i = 0 ; i < interfaces.GetSize () ; i++)
+      if (!interfaces[i].GetAddress ().IsLoopback ())
+        addresses.insert ((const char*) interfaces[i].GetAddress ().AsString ());
+
+  for (std::set<std::string>::const_iterator iter = addresses.begin ();
+       iter != addresses.end ();
+       ++iter)
+    result += " " + *iter;
+
+  return result;
+}
+
+
+/* The entries are "network|server|type|address" ; older ones had no
+ * address, and aren't enough to get ready on anymore.
+ */
+bool
+Opal::EndPoint::GetCachedNat (PSTUNClient::NatTypes & result,
+                              std::string & address) const
+{
+  const std::string prefix = stun_network_key + "|" + stun_server + "|";
+  const std::list<std::string> cache = nat_settings->get_string_list ("stun-cache");
+
+  for (std::list<std::string>::const_iterator iter = cache.begin ();
+       iter != cache.end ();
+       ++iter) {
+
+    if (iter->compare (0, prefix.length (), prefix) == 0) {
+
+      const std::string value = iter->substr (prefix.length ());
+      const std::string::size_type separator = value.find ('|');
+
+      if (separator == std::string::npos || separator + 1 == value.length ())
+        return false;
+
+      result = (PSTUNClient::NatTypes) atoi (value.substr (0, separator).c_str ());
+      address = value.substr (separator + 1);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+void
+Opal::EndPoint::SetCachedNat (PSTUNClient::NatTypes result,
+                              const std::string & address)
+{
+  const std::string prefix = stun_network_key + "|" + stun_server + "|";
+  std::list<std::string> cache = nat_settings->get_string_list ("stun-cache");
+  std::list<std::string> new_cache;
+  std::stringstream entry;
+
+  // Most recent network first, the oldest ones get forgotten
+  entry << prefix << (int) result << "|" << address;
+  new_cache.push_back (entry.str ());
+  for (std::list<std::string>::const_iterator iter = cache.begin ();
+       iter != cache.end () && new_cache.size () < STUN_CACHE_SIZE;
+       ++iter)
+    if (iter->compare (0, prefix.length (), prefix) != 0)
+      new_cache.push_back (*iter);
+
+  if (new_cache != cache)
+    nat_settings->set_string_list ("stun-cache", new_cache);
 }
 
 
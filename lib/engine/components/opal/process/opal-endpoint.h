@@ -51,11 +51,13 @@
 #include <sip/sip.h>
 
 #include "opal-call.h"
+#include "opal-audio-bridge.h"
 
 #include "call-manager.h"
 #include "contact-core.h"
 
 #include "actor.h"
+#include "ekiga-settings.h"
 
 class GMPCSSEndpoint;
 
@@ -99,6 +101,9 @@ public:
     void SetAutoAnswer (bool enabled);
     bool GetAutoAnswer () const;
 
+    /* Several servers can be given, separated by commas : they are probed
+     * in parallel and the first one to answer is used.
+     */
     void SetStunServer (const std::string & server);
 
     Sip::EndPoint& GetSipEndPoint ();
@@ -131,8 +136,17 @@ public:
     void SetVideoOptions (const VideoOptions & options);
     void GetVideoOptions (VideoOptions & options) const;
 
+    /* The local conference the calls can join */
+    AudioBridge & GetAudioBridge ();
+
     boost::signals2::signal<void(void)> ready;
 
+    /* Emitted when we got ready on the NAT settings cached for this network,
+     * and the detection then found out they changed : whatever registered
+     * with the old ones has to register again.
+     */
+    boost::signals2::signal<void(void)> nat_changed;
+
 private:
     OpalCall *CreateCall (void *uri);
 
@@ -140,10 +154,35 @@ private:
 
     void DestroyCall (boost::shared_ptr<Ekiga::Call> call);
 
-    void HandleSTUNResult ();
+    /* public for access from the STUN detector threads */
+public:
+    void OnSTUNProbeResult (unsigned int generation,
+                            const std::string server,
+                            PSTUNClient::NatTypes result);
+
+    void OnSTUNResult (unsigned int generation,
+                       const std::string server,
+                       PSTUNClient::NatTypes result,
+                       const std::string address);
+
+private:
+    void HandleSTUNTimeout (unsigned int generation);
+
+    void ReapSTUNThreads ();
 
     void ReportSTUNError (const std::string error);
 
+    /* The last NAT type and mapped address are cached per network, so that
+     * when we start on a network we already know, we can get ready without
+     * waiting for the STUN detection, which will then only confirm them in
+     * the background.
+     */
+    const std::string GetNetworkKey () const;
+    bool GetCachedNat (PSTUNClient::NatTypes & result,
+                       std::string & address) const;
+    void SetCachedNat (PSTUNClient::NatTypes result,
+                       const std::string & address);
+
     PBoolean CreateVideoOutputDevice (const OpalConnection & connection,
                                       const OpalMediaFormat & media_fmt,
                                       PBoolean preview,
@@ -154,12 +193,20 @@ private:
                                                      const PString & caller);
 
 
-    /* used to get the STUNDetector results */
-    PThread* stun_thread;
-    GAsyncQueue* queue;
-    unsigned int patience;
+    /* the STUNDetector threads, and where we are with their results */
+    std::list<PThread*> stun_threads;
+    unsigned int stun_generation;
+    unsigned int stun_probes_pending;
+    bool stun_probe_won;
+    bool stun_detecting;
+    std::string stun_network_key;
+    bool stun_from_cache; // we got ready on the cached values below
+    PSTUNClient::NatTypes stun_cached_type;
+    std::string stun_cached_address;
+    Ekiga::SettingsPtr nat_settings;
 
     std::string stun_server;
+    std::string stun_chosen; // the server in use, if the detection went well
     unsigned noAnswerDelay;
     bool autoAnswer;
     bool stun_enabled;
@@ -170,6 +217,8 @@ private:
 #ifdef HAVE_H323
     H323::EndPoint *h323_endpoint;
 #endif
+    AudioBridge audio_bridge;
+
     /* Make sure the CallCore is destroyed after the EndPoint */
     boost::shared_ptr<Ekiga::CallCore> call_core;
     Ekiga::ServiceCore& core;
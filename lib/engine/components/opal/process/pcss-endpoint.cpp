@@ -36,11 +36,13 @@
 
 #include "pcss-endpoint.h"
 #include "opal-endpoint.h"
+#include "opal-audio.h"
 
 
 GMPCSSEndpoint::GMPCSSEndpoint (Opal::EndPoint & ep,
                                 Ekiga::ServiceCore & _core)
 :   OpalPCSSEndPoint(ep),
+    endpoint(ep),
     core(_core)
 {
 #ifdef WIN32
@@ -61,3 +63,17 @@ bool GMPCSSEndpoint::OnShowOutgoing (const OpalPCSSConnection & /*connection*/)
 {
   return true;
 }
+
+
+PSoundChannel * GMPCSSEndpoint::CreateSoundChannel (const OpalPCSSConnection & connection,
+                                                    const OpalMediaFormat & media_format,
+                                                    PBoolean is_source)
+{
+  PSoundChannel *channel = OpalPCSSEndPoint::CreateSoundChannel (connection, media_format, is_source);
+
+  PSoundChannel_EKIGA *ekiga_channel = dynamic_cast<PSoundChannel_EKIGA *> (channel);
+  if (ekiga_channel)
+    ekiga_channel->SetBridge (&endpoint.GetAudioBridge (), (const char *) connection.GetCall ().GetToken ());
+
+  return channel;
+}
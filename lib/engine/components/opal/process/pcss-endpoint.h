@@ -58,7 +58,13 @@ public:
 
   bool OnShowOutgoing (const OpalPCSSConnection &connection);
 
+  /* The channels are told which call they belong to, for the bridge */
+  PSoundChannel * CreateSoundChannel (const OpalPCSSConnection & connection,
+                                      const OpalMediaFormat & media_format,
+                                      PBoolean is_source);
+
 private:
+  Opal::EndPoint & endpoint;
   Ekiga::ServiceCore & core;
 };
 
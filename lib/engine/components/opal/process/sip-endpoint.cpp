@@ -38,6 +38,7 @@
 #include <glib/gi18n.h>
 #include "config.h"
 #include "sip-endpoint.h"
+#include "trace-ring.h"
 
 namespace Opal {
 
@@ -80,9 +81,13 @@ namespace Opal {
 
           // Register the given aor to the given registrar
           ep.Register (params, _aor);
+          ep.TraceSentRegister (_aor, true);
         }
-        else
+        else {
+
+          ep.TraceSentRegister (account.get_full_uri (""), false);
           ep.Unregister (account.get_full_uri (""));
+        }
       }
 
   private:
@@ -96,8 +101,8 @@ namespace Opal {
 
 /* The class */
 Opal::Sip::EndPoint::EndPoint (Opal::EndPoint & _endpoint,
-                               const Ekiga::ServiceCore& _core): SIPEndPoint (_endpoint),
-                                                                 core (_core)
+                               Ekiga::ServiceCore& _core): SIPEndPoint (_endpoint),
+                                                           bank_handle (_core, Opal::bank_key)
 {
   /* Timeouts */
   SetRetryTimeouts (500, 4000);
@@ -127,7 +132,7 @@ bool
 Opal::Sip::EndPoint::SetUpCall (const std::string & uri)
 {
   PString token;
-  boost::shared_ptr<Opal::Bank> bank = core.get<Opal::Bank> ("opal-account-store");
+  boost::shared_ptr<Opal::Bank> bank = bank_handle.get ();
   if (bank) {
     Opal::AccountPtr account = bank->find_account (SIPURL (uri).GetHostPort ());
     if (account)
@@ -192,6 +197,89 @@ Opal::Sip::EndPoint::DisableAccount (Account & account)
 }
 
 
+bool
+Opal::Sip::EndPoint::SubscribeToPresenceList (const Account & account,
+                                              const PString & list_uri,
+                                              PString & token)
+{
+  SIPSubscribe::Params params (SIPSubscribe::Presence);
+
+  params.m_addressOfRecord = account.get_full_uri (account.get_aor ());
+  params.m_remoteAddress = list_uri;
+  params.m_authID = account.get_authentication_username ();
+  params.m_password = account.get_password ();
+  params.m_expire = account.get_timeout ();
+  params.m_eventList = true;  // Supported: eventlist, and opal splits the multipart NOTIFYs for us
+  params.m_onSubcribeStatus = PCREATE_NOTIFIER2 (OnPresenceListStatus, const SIPSubscribe::SubscriptionStatus &);
+  params.m_onNotify = PCREATE_NOTIFIER2 (OnPresenceListNotify, SIPSubscribe::NotifyCallbackInfo &);
+
+  PTRACE (4, "Opal::Sip::EndPoint\tSubscribing to presence list " << list_uri << " for " << account.get_aor ());
+
+  if (!Subscribe (params, token))
+    return false;
+
+  EKIGA_TRACE (TraceSipSent, 0, (const char*) token, "SUBSCRIBE");
+
+  return true;
+}
+
+
+/* OPAL sends the requests from its handlers, and gives us no hook on
+ * them : the ones we start are traced here, under the Call-ID of their
+ * handler, which the responses come back with.
+ */
+void
+Opal::Sip::EndPoint::TraceSentRegister (const PString & aor,
+                                        bool registering)
+{
+  if (!Ekiga::TraceRing::is_enabled ())
+    return;
+
+  PSafePtr<SIPHandler> handler = FindSIPHandlerByUrl (aor, SIP_PDU::Method_REGISTER, PSafeReadOnly);
+  if (handler != NULL)
+    EKIGA_TRACE (TraceSipSent, registering, (const char*) handler->GetCallID (),
+                 registering ? "REGISTER" : "REGISTER (unregistering)");
+}
+
+
+void
+Opal::Sip::EndPoint::OnPresenceListStatus (SIPSubscribeHandler & handler,
+                                           const SIPSubscribe::SubscriptionStatus & status)
+{
+  if (!status.m_wasSubscribing || status.m_reason / 100 <= 2)
+    return;
+
+  boost::shared_ptr<Opal::Bank> bank = bank_handle.get ();
+  if (!bank)
+    return;
+
+  Opal::AccountPtr account = bank->find_account (handler.GetAddressOfRecord ().AsString ());
+  if (!account)
+    return;
+
+  // the server does not know the list, or does not do RFC 4662
+  PTRACE (3, "Opal::Sip::EndPoint\tPresence list subscription failed for " << status.m_addressofRecord << ": " << status.m_reason);
+  Ekiga::Runtime::run_in_main (boost::bind (&Opal::Account::handle_presence_list_failure, account));
+}
+
+
+void
+Opal::Sip::EndPoint::OnPresenceListNotify (SIPSubscribeHandler & handler,
+                                           SIPSubscribe::NotifyCallbackInfo & info)
+{
+  boost::shared_ptr<Opal::Bank> bank = bank_handle.get ();
+  Opal::AccountPtr account;
+
+  if (bank)
+    account = bank->find_account (handler.GetAddressOfRecord ().AsString ());
+
+  if (account)
+    account->handle_presence_list_notification ((const char*) info.m_notify.GetEntityBody ());
+
+  info.SendResponse (SIP_PDU::Successful_OK);
+}
+
+
 void
 Opal::Sip::EndPoint::SetNoAnswerForwardTarget (const PString & _party)
 {
@@ -233,7 +321,7 @@ Opal::Sip::EndPoint::OnRegistrationStatus (const RegistrationStatus & status)
 {
   std::string info;
 
-  boost::shared_ptr<Opal::Bank> bank = core.get<Opal::Bank> ("opal-account-store");
+  boost::shared_ptr<Opal::Bank> bank = bank_handle.get ();
   if (!bank)
     return;
 
@@ -289,6 +377,7 @@ Opal::Sip::EndPoint::OnRegistrationStatus (const RegistrationStatus & status)
         activeSIPHandlers.Remove (status.m_handler); // Make sure the TCP handler is deleted
                                                      // or it will be retried indefinitely.
       SIPEndPoint::Register (params, _aor);
+      TraceSentRegister (_aor, true);
       return;
     }
 
@@ -536,6 +625,24 @@ Opal::Sip::EndPoint::OnRegistrationStatus (const RegistrationStatus & status)
 }
 
 
+PBoolean
+Opal::Sip::EndPoint::OnReceivedPDU (OpalTransport & transport,
+                                    SIP_PDU * pdu)
+{
+  if (pdu != NULL && Ekiga::TraceRing::is_enabled ()) {
+
+    int status = pdu->GetStatusCode ();
+    PString what = pdu->GetMIME ().GetCSeq ();
+    if (status != 0)
+      what = PString (status) + " " + what;
+
+    EKIGA_TRACE (TraceSipReceived, status, (const char*) pdu->GetMIME ().GetCallID (), (const char*) what);
+  }
+
+  return SIPEndPoint::OnReceivedPDU (transport, pdu);
+}
+
+
 void
 Opal::Sip::EndPoint::OnMWIReceived (const PString & party,
                                     OpalManager::MessageWaitingType /*type*/,
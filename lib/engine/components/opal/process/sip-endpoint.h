@@ -63,7 +63,7 @@ namespace Opal {
     public:
 
       EndPoint (Opal::EndPoint& ep,
-                const Ekiga::ServiceCore& core);
+                Ekiga::ServiceCore& core);
 
       ~EndPoint ();
 
@@ -86,6 +86,16 @@ namespace Opal {
 
       void DisableAccount (Account & account);
 
+      /* Subscribe to the presence of all the contacts of the account at
+       * once, through the given RFC 4662 resource list ; the notifications
+       * are given back to the account.
+       * Returns false if the subscription could not be started, in which
+       * case the account should subscribe to each contact.
+       */
+      bool SubscribeToPresenceList (const Account & account,
+                                    const PString & list_uri,
+                                    PString & token);
+
       void SetNoAnswerForwardTarget (const PString & party);
 
       void SetUnconditionalForwardTarget (const PString & party);
@@ -96,6 +106,10 @@ namespace Opal {
 
       PGloballyUniqueID & GetInstanceID ();
 
+      /* Records the (un)registration just started for aor to the trace ring */
+      void TraceSentRegister (const PString & aor,
+                              bool registering);
+
     private:
       /* OPAL Methods */
       void OnRegistrationStatus (const RegistrationStatus & status);
@@ -110,7 +124,15 @@ namespace Opal {
 
       void OnDialogInfoReceived (const SIPDialogNotification & info);
 
-      const Ekiga::ServiceCore & core;
+      PBoolean OnReceivedPDU (OpalTransport & transport,
+                              SIP_PDU * pdu);
+
+      PDECLARE_NOTIFIER2 (SIPSubscribeHandler, EndPoint, OnPresenceListStatus, const SIPSubscribe::SubscriptionStatus &);
+      PDECLARE_NOTIFIER2 (SIPSubscribeHandler, EndPoint, OnPresenceListNotify, SIPSubscribe::NotifyCallbackInfo &);
+
+      /* looked up from the OPAL threads on every registration and
+       * presence notification, so resolved once */
+      Ekiga::ServiceHandle<Opal::Bank> bank_handle;
 
       PString noAnswerForwardParty;
       PString unconditionalForwardParty;
@@ -55,6 +55,7 @@ struct PTLIBAUDIOINPUTSpark: public Ekiga::Spark
       GMAudioInputManager_ptlib *audioinput_manager = new GMAudioInputManager_ptlib(core);
 
       audioinput_core->add_manager (*audioinput_manager);
+      core_for_warm_up = audioinput_core;
       core.add (Ekiga::ServicePtr (new Ekiga::BasicService ("ptlib-audio-input",
 							    "\tComponent bringing PTLIB's audio input")));
       result = true;
@@ -69,7 +70,24 @@ struct PTLIBAUDIOINPUTSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "PTLIBAUDIOINPUT"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("audioinput-core");
+    return result;
+  }
+
+  /* PTLIB probes the sound servers to list the devices, which can take a
+   * while : the core caches the list, so it gets filled on the side
+   */
+  void warm_up ()
+  {
+    std::vector<Ekiga::AudioInputDevice> devices;
+    core_for_warm_up->get_devices (devices);
+  }
+
   bool result;
+  boost::shared_ptr<Ekiga::AudioInputCore> core_for_warm_up;
 };
 
 void
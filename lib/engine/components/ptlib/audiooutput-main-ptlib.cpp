@@ -55,6 +55,7 @@ struct PTLIBAUDIOOUTPUTSpark: public Ekiga::Spark
       GMAudioOutputManager_ptlib *audiooutput_manager = new GMAudioOutputManager_ptlib(core);
 
       audiooutput_core->add_manager (*audiooutput_manager);
+      core_for_warm_up = audiooutput_core;
       core.add (Ekiga::ServicePtr (new Ekiga::BasicService ("ptlib-audio-output",
 							    "\tComponent bringing PTLIB's audio output")));
       result = true;
@@ -69,7 +70,24 @@ struct PTLIBAUDIOOUTPUTSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "PTLIBAUDIOOUTPUT"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("audiooutput-core");
+    return result;
+  }
+
+  /* PTLIB probes the sound servers to list the devices, which can take a
+   * while : the core caches the list, so it gets filled on the side
+   */
+  void warm_up ()
+  {
+    std::vector<Ekiga::AudioOutputDevice> devices;
+    core_for_warm_up->get_devices (devices);
+  }
+
   bool result;
+  boost::shared_ptr<Ekiga::AudioOutputCore> core_for_warm_up;
 };
 
 void
@@ -69,6 +69,13 @@ struct PTLIBVIDEOINPUTSpark: public Ekiga::Spark
   const std::string get_name () const
   { return "PTLIBVIDEOINPUT"; }
 
+  const std::list<std::string> get_requirements () const
+  {
+    std::list<std::string> result;
+    result.push_back ("videoinput-core");
+    return result;
+  }
+
   bool result;
 };
 
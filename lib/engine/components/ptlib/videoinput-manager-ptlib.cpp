@@ -38,6 +38,7 @@
 #include <ptlib.h>
 
 #include "runtime.h"
+#include "video-kernels.h"
 
 #define DEVICE_TYPE "PTLIB"
 
@@ -183,14 +184,10 @@ bool GMVideoInputManager_ptlib::get_frame_data (char *data)
 
   if ((unsigned) I != expectedFrameSize) {
     PTRACE(1, "GMVideoInputManager_ptlib\tExpected a frame of " << expectedFrameSize << " bytes but got " << I << " bytes");
-    memset (data, 0, current_state.width*current_state.height); //ff
-    memset (data + (current_state.width * current_state.height),
-            0x7f,
-            (current_state.width*current_state.height) >> 2);
-    memset (data + (current_state.width * current_state.height) +
-            ((current_state.width * current_state.height) >> 2),
-            0x7f,
-            (current_state.width*current_state.height) >> 2);
+    Ekiga::VideoKernels::fill (Ekiga::VideoKernels::I420 (data,
+                                                         current_state.width,
+                                                         current_state.height),
+                               0, 0x7f, 0x7f);
   }
   return ret;
 }
@@ -58,6 +58,7 @@
 #include "glib-notify-main.h"
 #include "gtk-core-main.h"
 #include "gmconf-personal-details.h"
+#include "write-behind.h"
 
 #include "videooutput-main-clutter-gst.h"
 
@@ -76,19 +77,46 @@
 #include "opal-process.h"
 #include "opal-main.h"
 
+#include <iostream>
+#include <glib.h>
+
 #define DEBUG_STARTUP 0
 
-#if DEBUG_STARTUP
-#include <iostream>
-#endif
+/* Set EKIGA_STARTUP_TIMING to get the time taken by each startup step and
+ * by each spark
+ */
+struct StartupTiming
+{
+  StartupTiming (): enabled(g_getenv ("EKIGA_STARTUP_TIMING") != NULL),
+    start(g_get_monotonic_time ()), last(start)
+  {}
+
+  void step (const char* name)
+  {
+    gint64 now = g_get_monotonic_time ();
+
+    if (enabled)
+      std::cout << "Startup: " << name << " took " << (now - last) / 1000.0
+                << " ms (at " << (now - start) / 1000.0 << " ms)" << std::endl;
+    last = now;
+  }
+
+  bool enabled;
+  gint64 start;
+  gint64 last;
+};
 
 void
 engine_init (Ekiga::ServiceCore& core,
              int argc,
-             char *argv [])
+             char *argv [],
+             bool headless)
 {
+  StartupTiming timing;
+
   // AT THE VERY FIRST, create the PProcess
   GnomeMeeting & instance = opal_init_pprocess (argc, argv);
+  timing.step ("PProcess");
 
   // FIRST we add a few things by hand
   // (for speed and because that's less code)
@@ -126,12 +154,15 @@ engine_init (Ekiga::ServiceCore& core,
     return;
   }
 
-  if (!videooutput_clutter_gst_init (core, &argc, &argv)) {
+  if (!headless && !videooutput_clutter_gst_init (core, &argc, &argv)) {
     return;
   }
 
+  timing.step ("hand-made cores");
+
   //
   instance.Start (core);
+  timing.step ("OPAL process");
 
   // THEN we use the kickstart scheme
 
@@ -140,22 +171,26 @@ engine_init (Ekiga::ServiceCore& core,
   audioinput_null_init (kickstart);
   audiooutput_null_init (kickstart);
 
-  videoinput_ptlib_init (kickstart);
+  if (!headless) {
+
+    videoinput_ptlib_init (kickstart);
 
-  audioinput_ptlib_init (kickstart);
-  audiooutput_ptlib_init (kickstart);
+    audioinput_ptlib_init (kickstart);
+    audiooutput_ptlib_init (kickstart);
 
-  gnotify_init (kickstart);
+    gnotify_init (kickstart);
 
 #ifdef HAVE_GUDEV
-  hal_gudev_init (kickstart);
+    hal_gudev_init (kickstart);
 #endif
+  }
 
   opal_init (kickstart);
 
   history_init (kickstart);
 
-  plugin_init (kickstart);
+  if (!headless)
+    plugin_init (core, kickstart);
 
   // FIXME: Some parts in the kickstart need the gui.  The gui needs
   //  some parts in the kickstart.  So we will kick a first time to
@@ -166,10 +201,23 @@ engine_init (Ekiga::ServiceCore& core,
   //  this initialization, or put the gui in the kickstart too.
 
   kickstart.kick (core, &argc, &argv);
+  timing.step ("first kick");
 
-  gtk_core_init (core, &argc, &argv);
+  if (!headless) {
 
-  kickstart.kick (core, &argc, &argv);
+    gtk_core_init (core, &argc, &argv);
+    timing.step ("gtk core");
+
+    kickstart.kick (core, &argc, &argv);
+    timing.step ("second kick");
+  }
+
+  /* The sparks warm up on the kickstart's worker threads (enumerating the
+   * audio devices, for example) while the gui gets built : we only need
+   * them done before setting the devices up
+   */
+  kickstart.wait_warm_ups ();
+  timing.step ("warm ups");
 
   /* FIXME: everything that follows except the debug output shouldn't
      be there, as that means we're doing the work of initializing
@@ -180,6 +228,7 @@ engine_init (Ekiga::ServiceCore& core,
   videoinput_core->setup ("any");
   audioinput_core->setup ();
   audiooutput_core->setup ();
+  timing.step ("device setup");
 
 
   hal_core->videoinput_device_added.connect (boost::bind (&Ekiga::VideoInputCore::add_device, boost::ref (*videoinput_core), _1, _2, _3, _4));
@@ -192,6 +241,9 @@ engine_init (Ekiga::ServiceCore& core,
   /* FIXME: does it really belong here? */
   friend_or_foe->add_helper (foe_list);
 
+  if (timing.enabled)
+    kickstart.report (std::cout);
+
 #if DEBUG_STARTUP
   std::cout << "Here is what ekiga is made of for this run :" << std::endl;
   core.dump (std::cout);
@@ -201,5 +253,10 @@ engine_init (Ekiga::ServiceCore& core,
 
 void engine_close (Ekiga::ServiceCore& core)
 {
+  /* the settings documents still waiting to be saved */
+  Ekiga::WriteBehind::flush_all ();
+  PTRACE (4, "Ekiga\tSaved the settings " << Ekiga::WriteBehind::get_written ()
+          << " times for " << Ekiga::WriteBehind::get_scheduled () << " changes");
+
   opal_close (core);
 }
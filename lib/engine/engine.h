@@ -44,9 +44,14 @@
  * @{
  */
 
+/* In headless mode, neither the gui nor the real devices are brought
+ * up: the audio cores use the null devices and the video input core
+ * the moving logo. That is enough to place and receive calls.
+ */
 void engine_init (Ekiga::ServiceCore& core,
                   int argc,
-                  char *argv[]);
+                  char *argv[],
+                  bool headless = false);
 
 void engine_close (Ekiga::ServiceCore& core);
 
@@ -0,0 +1,337 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         audio-kernels.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the operations on 16 bits
+ *                          mono sound used to mix several calls together.
+ *
+ */
+
+#include <algorithm>
+
+#include "audio-kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__ ((target ("sse2")))
+#define TARGET_AVX2 __attribute__ ((target ("avx2")))
+#endif
+
+using namespace Ekiga::AudioKernels;
+
+namespace
+{
+  struct Kernels
+  {
+    void (*accumulate) (int* sum,
+                        const short* samples,
+                        unsigned n);
+
+    void (*minus_one) (const int* sum,
+                       const short* own,
+                       short* result,
+                       unsigned n);
+  };
+
+  /* the scalar reference */
+
+  void
+  accumulate_c (int* sum,
+                const short* samples,
+                unsigned n)
+  {
+    for (unsigned i = 0; i < n; i++)
+      sum[i] += samples[i];
+  }
+
+  void
+  minus_one_c (const int* sum,
+               const short* own,
+               short* result,
+               unsigned n)
+  {
+    for (unsigned i = 0; i < n; i++)
+      result[i] = (short) std::min (std::max (sum[i] - own[i], -32768), 32767);
+  }
+
+  const Kernels scalar_kernels = {
+    accumulate_c, minus_one_c
+  };
+
+#ifdef HAVE_X86_KERNELS
+
+  /* SSE2: 8 samples at a time ; the sums are 32 bits, so they can't
+   * overflow before 65536 calls, and packing them back saturates just
+   * like the reference */
+
+  TARGET_SSE2 inline __m128i
+  widen_lo_sse2 (__m128i x)
+  {
+    return _mm_srai_epi32 (_mm_unpacklo_epi16 (x, x), 16);
+  }
+
+  TARGET_SSE2 inline __m128i
+  widen_hi_sse2 (__m128i x)
+  {
+    return _mm_srai_epi32 (_mm_unpackhi_epi16 (x, x), 16);
+  }
+
+  TARGET_SSE2 void
+  accumulate_sse2 (int* sum,
+                   const short* samples,
+                   unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+
+      __m128i s = _mm_loadu_si128 ((const __m128i*) (samples + i));
+      __m128i a = _mm_loadu_si128 ((const __m128i*) (sum + i));
+      __m128i b = _mm_loadu_si128 ((const __m128i*) (sum + i + 4));
+      _mm_storeu_si128 ((__m128i*) (sum + i), _mm_add_epi32 (a, widen_lo_sse2 (s)));
+      _mm_storeu_si128 ((__m128i*) (sum + i + 4), _mm_add_epi32 (b, widen_hi_sse2 (s)));
+    }
+    accumulate_c (sum + i, samples + i, n - i);
+  }
+
+  TARGET_SSE2 void
+  minus_one_sse2 (const int* sum,
+                  const short* own,
+                  short* result,
+                  unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+
+      __m128i o = _mm_loadu_si128 ((const __m128i*) (own + i));
+      __m128i a = _mm_loadu_si128 ((const __m128i*) (sum + i));
+      __m128i b = _mm_loadu_si128 ((const __m128i*) (sum + i + 4));
+      a = _mm_sub_epi32 (a, widen_lo_sse2 (o));
+      b = _mm_sub_epi32 (b, widen_hi_sse2 (o));
+      _mm_storeu_si128 ((__m128i*) (result + i), _mm_packs_epi32 (a, b));
+    }
+    minus_one_c (sum + i, own + i, result + i, n - i);
+  }
+
+  const Kernels sse2_kernels = {
+    accumulate_sse2, minus_one_sse2
+  };
+
+  /* AVX2: 16 samples at a time ; the packing works within each 128-bit
+   * lane, so its result has to be put back in order */
+
+  TARGET_AVX2 void
+  accumulate_avx2 (int* sum,
+                   const short* samples,
+                   unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+
+      __m256i lo = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i*) (samples + i)));
+      __m256i hi = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i*) (samples + i + 8)));
+      __m256i a = _mm256_loadu_si256 ((const __m256i*) (sum + i));
+      __m256i b = _mm256_loadu_si256 ((const __m256i*) (sum + i + 8));
+      _mm256_storeu_si256 ((__m256i*) (sum + i), _mm256_add_epi32 (a, lo));
+      _mm256_storeu_si256 ((__m256i*) (sum + i + 8), _mm256_add_epi32 (b, hi));
+    }
+    _mm256_zeroupper ();
+    accumulate_sse2 (sum + i, samples + i, n - i);
+  }
+
+  TARGET_AVX2 void
+  minus_one_avx2 (const int* sum,
+                  const short* own,
+                  short* result,
+                  unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+
+      __m256i lo = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i*) (own + i)));
+      __m256i hi = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i*) (own + i + 8)));
+      __m256i a = _mm256_sub_epi32 (_mm256_loadu_si256 ((const __m256i*) (sum + i)), lo);
+      __m256i b = _mm256_sub_epi32 (_mm256_loadu_si256 ((const __m256i*) (sum + i + 8)), hi);
+      __m256i packed = _mm256_permute4x64_epi64 (_mm256_packs_epi32 (a, b), 0xd8);
+      _mm256_storeu_si256 ((__m256i*) (result + i), packed);
+    }
+    _mm256_zeroupper ();
+    minus_one_sse2 (sum + i, own + i, result + i, n - i);
+  }
+
+  const Kernels avx2_kernels = {
+    accumulate_avx2, minus_one_avx2
+  };
+
+#endif
+
+  Level current_level = (Level) -1;
+
+  const Kernels &
+  kernels ()
+  {
+    if (current_level == (Level) -1)
+      current_level = get_best_level ();
+
+    switch (current_level) {
+
+#ifdef HAVE_X86_KERNELS
+    case AVX2:
+      return avx2_kernels;
+    case SSE2:
+      return sse2_kernels;
+#endif
+    case Scalar:
+    default:
+      return scalar_kernels;
+    }
+  }
+};
+
+
+Level
+Ekiga::AudioKernels::get_best_level ()
+{
+#ifdef HAVE_X86_KERNELS
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    return AVX2;
+  if (__builtin_cpu_supports ("sse2"))
+    return SSE2;
+#endif
+
+  return Scalar;
+}
+
+Level
+Ekiga::AudioKernels::get_level ()
+{
+  kernels ();
+
+  return current_level;
+}
+
+void
+Ekiga::AudioKernels::set_level (Level level)
+{
+  current_level = std::min (level, get_best_level ());
+}
+
+void
+Ekiga::AudioKernels::accumulate (int* sum,
+                                 const short* samples,
+                                 unsigned n)
+{
+  kernels ().accumulate (sum, samples, n);
+}
+
+void
+Ekiga::AudioKernels::minus_one (const int* sum,
+                                const short* own,
+                                short* result,
+                                unsigned n)
+{
+  kernels ().minus_one (sum, own, result, n);
+}
+
+
+Resampler::Resampler (unsigned from_,
+                      unsigned to_)
+{
+  reset (from_, to_);
+}
+
+void
+Resampler::reset (unsigned from_,
+                  unsigned to_)
+{
+  from = std::max (from_, 1u);
+  to = std::max (to_, 1u);
+  step = ((unsigned long long) from << 32) / to;
+  position = 0;
+  last = 0;
+  sum = 0;
+  count = 0;
+}
+
+void
+Resampler::process (const short* samples,
+                    unsigned n,
+                    std::vector<short> & output)
+{
+  const unsigned long long one = 1ULL << 32;
+
+  if (n == 0)
+    return;
+
+  if (from == to) {
+
+    output.insert (output.end (), samples, samples + n);
+    return;
+  }
+
+  if (from < to) {
+
+    /* between last (or samples[index - 1]) and samples[index], with a
+     * 15-bit weight so that the products fit in an int */
+    const unsigned long long end = (unsigned long long) n << 32;
+
+    for (; position < end; position += step) {
+
+      unsigned index = position >> 32;
+      int weight = (position >> 17) & 0x7fff;
+      int s0 = (index == 0 ? last : samples[index - 1]);
+      int s1 = samples[index];
+      output.push_back ((short) ((s0 * (32768 - weight) + s1 * weight + 16384) >> 15));
+    }
+    position -= end;
+    last = samples[n - 1];
+  }
+  else {
+
+    for (unsigned i = 0; i < n; i++) {
+
+      sum += samples[i];
+      count++;
+      position += one;
+      if (position >= step) {
+
+        long half = (sum < 0 ? - (long) (count / 2) : (long) (count / 2));
+        output.push_back ((short) ((sum + half) / (long) count));
+        position -= step;
+        sum = 0;
+        count = 0;
+      }
+    }
+  }
+}
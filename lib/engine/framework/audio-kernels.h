@@ -0,0 +1,137 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         audio-kernels.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the operations on 16 bits mono
+ *                          sound used to mix several calls together.
+ *
+ */
+
+#ifndef __AUDIO_KERNELS_H__
+#define __AUDIO_KERNELS_H__
+
+#include <vector>
+
+/* The operations an audio mixer needs on 16 bits signed mono samples:
+ * summing several sounds, taking one of them out of the sum again (so
+ * that nobody hears their own voice back), and converting between
+ * sample rates.
+ *
+ * As for the video kernels, the sums have a plain C++ version, which is
+ * the reference, and SSE2 and AVX2 versions ; the fastest the processor
+ * supports is picked at run time, and all give exactly the same result.
+ */
+
+namespace Ekiga
+{
+
+  /**
+   * @addtogroup services
+   * @{
+   */
+
+  namespace AudioKernels
+  {
+    enum Level {
+
+      Scalar,
+      SSE2,
+      AVX2
+    };
+
+    /* The best level the processor supports */
+    Level get_best_level ();
+
+    /* The level in use ; it can be lowered, to compare or to debug */
+    Level get_level ();
+    void set_level (Level level);
+
+    /* sum[i] += samples[i] */
+    void accumulate (int* sum,
+                     const short* samples,
+                     unsigned n);
+
+    /* result[i] = sum[i] - own[i], saturated to 16 bits */
+    void minus_one (const int* sum,
+                    const short* own,
+                    short* result,
+                    unsigned n);
+
+    /* Converts a stream from one sample rate to another: going up, it
+     * interpolates linearly, going down, it averages the samples which
+     * fall into each output sample, which is enough against aliasing for
+     * the voice. It keeps what it needs of a block to continue with the
+     * next one, so a stream is converted by pieces of any size.
+     */
+    class Resampler
+    {
+    public:
+
+      Resampler (unsigned from = 8000,
+                 unsigned to = 8000);
+
+      unsigned get_from () const
+      { return from; }
+
+      unsigned get_to () const
+      { return to; }
+
+      /* Forget the stream, and possibly change the rates */
+      void reset (unsigned from,
+                  unsigned to);
+
+      /* Convert n samples, appending the result to output */
+      void process (const short* samples,
+                    unsigned n,
+                    std::vector<short> & output);
+
+    private:
+
+      unsigned from;
+      unsigned to;
+
+      /* in input samples as 32.32 fixed point: going up, where the next
+       * output sample is, counted from the last sample of the previous
+       * block ; going down, how far we are into the current output sample */
+      unsigned long long position;
+      unsigned long long step;
+      short last;
+
+      /* going down, the samples of the current output sample */
+      long sum;
+      unsigned count;
+    };
+  };
+
+  /**
+   * @}
+   */
+};
+
+#endif
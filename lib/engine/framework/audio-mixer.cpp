@@ -0,0 +1,237 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         audio-mixer.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the mixer bridging the sound
+ *                          of several calls together.
+ *
+ */
+
+#include <algorithm>
+
+#include "audio-mixer.h"
+
+/* how many periods a leg can have waiting, either way */
+#define MAX_QUEUED 3
+
+Ekiga::AudioMixer::AudioMixer (unsigned rate_,
+                               unsigned period_):
+  rate(rate_), period(period_), period_size(rate_ * period_ / 1000),
+  next_id(0), mixed(0), sum(period_size), timing("audio mix")
+{
+  g_mutex_init (&mutex);
+  g_cond_init (&mixed_cond);
+}
+
+Ekiga::AudioMixer::~AudioMixer ()
+{
+  g_cond_clear (&mixed_cond);
+  g_mutex_clear (&mutex);
+}
+
+Ekiga::AudioMixer::LegId
+Ekiga::AudioMixer::add_leg ()
+{
+  Leg leg;
+
+  leg.inbound.reset (rate, rate);
+  leg.outbound.reset (rate, rate);
+  leg.frame.resize (period_size);
+  leg.result.resize (period_size);
+
+  g_mutex_lock (&mutex);
+  leg.id = next_id++;
+  legs.push_back (leg);
+  g_mutex_unlock (&mutex);
+
+  return leg.id;
+}
+
+void
+Ekiga::AudioMixer::remove_leg (LegId id)
+{
+  g_mutex_lock (&mutex);
+
+  for (std::list<Leg>::iterator iter = legs.begin (); iter != legs.end (); ++iter) {
+
+    if (iter->id == id) {
+
+      legs.erase (iter);
+      break;
+    }
+  }
+  g_cond_broadcast (&mixed_cond);
+
+  g_mutex_unlock (&mutex);
+}
+
+unsigned
+Ekiga::AudioMixer::get_leg_count ()
+{
+  unsigned result;
+
+  g_mutex_lock (&mutex);
+  result = legs.size ();
+  g_mutex_unlock (&mutex);
+
+  return result;
+}
+
+void
+Ekiga::AudioMixer::put (LegId id,
+                        const short* samples,
+                        unsigned n,
+                        unsigned leg_rate,
+                        bool wait)
+{
+  const size_t most = MAX_QUEUED * period_size;
+  const gint64 deadline = g_get_monotonic_time () + 2 * period * G_TIME_SPAN_MILLISECOND;
+
+  g_mutex_lock (&mutex);
+
+  Leg* leg = find (id);
+  if (leg != NULL) {
+
+    if (leg->inbound.get_from () != leg_rate)
+      leg->inbound.reset (leg_rate, rate);
+    leg->inbound.process (samples, n, leg->said);
+  }
+
+  /* the leg can go while we wait */
+  bool waited = wait;
+  while (waited && leg != NULL && leg->said.size () > most) {
+
+    waited = g_cond_wait_until (&mixed_cond, &mutex, deadline);
+    leg = find (id);
+  }
+
+  if (leg != NULL && leg->said.size () > most)
+    leg->said.erase (leg->said.begin (), leg->said.end () - most);
+
+  g_mutex_unlock (&mutex);
+}
+
+void
+Ekiga::AudioMixer::get (LegId id,
+                        short* samples,
+                        unsigned n,
+                        unsigned leg_rate,
+                        bool wait)
+{
+  const gint64 deadline = g_get_monotonic_time () + 2 * period * G_TIME_SPAN_MILLISECOND;
+  unsigned available = 0;
+
+  g_mutex_lock (&mutex);
+
+  Leg* leg = find (id);
+  if (leg != NULL && leg->outbound.get_to () != leg_rate) {
+
+    leg->outbound.reset (rate, leg_rate);
+    leg->heard.clear ();
+  }
+
+  bool waited = wait;
+  while (waited && leg != NULL && leg->heard.size () < n) {
+
+    waited = g_cond_wait_until (&mixed_cond, &mutex, deadline);
+    leg = find (id);
+  }
+
+  if (leg != NULL) {
+
+    available = std::min ((size_t) n, leg->heard.size ());
+    std::copy (leg->heard.begin (), leg->heard.begin () + available, samples);
+    leg->heard.erase (leg->heard.begin (), leg->heard.begin () + available);
+  }
+
+  g_mutex_unlock (&mutex);
+
+  std::fill (samples + available, samples + n, 0);
+}
+
+void
+Ekiga::AudioMixer::mix ()
+{
+  StageTimer timer(timing);
+
+  g_mutex_lock (&mutex);
+
+  std::fill (sum.begin (), sum.end (), 0);
+
+  /* what everybody says... */
+  for (std::list<Leg>::iterator iter = legs.begin (); iter != legs.end (); ++iter) {
+
+    unsigned available = std::min ((size_t) period_size, iter->said.size ());
+
+    std::copy (iter->said.begin (), iter->said.begin () + available, iter->frame.begin ());
+    std::fill (iter->frame.begin () + available, iter->frame.end (), 0);
+    iter->said.erase (iter->said.begin (), iter->said.begin () + available);
+
+    AudioKernels::accumulate (&sum[0], &iter->frame[0], period_size);
+  }
+
+  /* ... and what each of them hears of it */
+  for (std::list<Leg>::iterator iter = legs.begin (); iter != legs.end (); ++iter) {
+
+    const size_t most = MAX_QUEUED * ((size_t) period_size * iter->outbound.get_to () / rate);
+
+    AudioKernels::minus_one (&sum[0], &iter->frame[0], &iter->result[0], period_size);
+    iter->outbound.process (&iter->result[0], period_size, iter->heard);
+
+    if (iter->heard.size () > most)
+      iter->heard.erase (iter->heard.begin (), iter->heard.end () - most);
+  }
+
+  mixed++;
+  g_cond_broadcast (&mixed_cond);
+
+  g_mutex_unlock (&mutex);
+}
+
+unsigned long
+Ekiga::AudioMixer::get_mixed ()
+{
+  unsigned long result;
+
+  g_mutex_lock (&mutex);
+  result = mixed;
+  g_mutex_unlock (&mutex);
+
+  return result;
+}
+
+Ekiga::AudioMixer::Leg*
+Ekiga::AudioMixer::find (LegId id)
+{
+  for (std::list<Leg>::iterator iter = legs.begin (); iter != legs.end (); ++iter)
+    if (iter->id == id)
+      return &*iter;
+
+  return NULL;
+}
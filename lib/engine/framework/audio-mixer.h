@@ -0,0 +1,163 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         audio-mixer.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the mixer bridging the sound of
+ *                          several calls together.
+ *
+ */
+
+#ifndef __AUDIO_MIXER_H__
+#define __AUDIO_MIXER_H__
+
+#include <list>
+#include <vector>
+#include <glib.h>
+#include <boost/noncopyable.hpp>
+
+#include "audio-kernels.h"
+#include "stage-timing.h"
+
+namespace Ekiga
+{
+
+  /**
+   * @addtogroup services
+   * @{
+   */
+
+  /* An N-way audio bridge: each leg is a party (a call, or the local user)
+   * which says something and hears everybody else -- the sum of all the
+   * legs minus its own ("minus one").
+   *
+   * The legs give and take their sound at the rate of their own codec or
+   * device, and the mixer converts it from and to its own rate. Whoever
+   * calls mix () is the clock of the whole bridge: the legs are paced by
+   * it, waiting in put () and get (), which are meant for the media
+   * threads. Everything is thread safe.
+   */
+  class AudioMixer: public boost::noncopyable
+  {
+  public:
+
+    typedef unsigned LegId;
+
+    /* Mixes at rate, period milliseconds at a time */
+    AudioMixer (unsigned rate = 48000,
+                unsigned period = 20);
+
+    ~AudioMixer ();
+
+    unsigned get_rate () const
+    { return rate; }
+
+    /* How long a period is, in milliseconds and in samples */
+    unsigned get_period () const
+    { return period; }
+
+    unsigned get_period_size () const
+    { return period_size; }
+
+    LegId add_leg ();
+
+    /* Whoever waits for the leg gets silence */
+    void remove_leg (LegId leg);
+
+    unsigned get_leg_count ();
+
+    /* Give n samples of what the party of the leg says, at its rate ;
+     * when more than a few periods are waiting to be mixed, wait for the
+     * mix to take them if wait is set (which paces the writer), then
+     * drop the oldest if they are still there.
+     */
+    void put (LegId leg,
+              const short* samples,
+              unsigned n,
+              unsigned leg_rate,
+              bool wait);
+
+    /* Take n samples of what the party of the leg hears, at its rate ;
+     * when they are not mixed yet, wait for them if wait is set, for
+     * at most two periods: what is still missing is silence.
+     */
+    void get (LegId leg,
+              short* samples,
+              unsigned n,
+              unsigned leg_rate,
+              bool wait);
+
+    /* Mix one period */
+    void mix ();
+
+    /* How many periods were mixed */
+    unsigned long get_mixed ();
+
+  private:
+
+    struct Leg
+    {
+      LegId id;
+
+      /* from the rate of the party to the one of the mix */
+      AudioKernels::Resampler inbound;
+      /* from the rate of the mix to the one of the party */
+      AudioKernels::Resampler outbound;
+
+      /* at the rate of the mix, what it said and was not mixed yet */
+      std::vector<short> said;
+      /* at the rate of the party, what it hears and was not taken yet */
+      std::vector<short> heard;
+
+      /* the period being mixed: what it says, and what it hears */
+      std::vector<short> frame;
+      std::vector<short> result;
+    };
+
+    Leg* find (LegId leg);
+
+    const unsigned rate;
+    const unsigned period;
+    const unsigned period_size;
+
+    GMutex mutex;
+    GCond mixed_cond;
+    std::list<Leg> legs;
+    LegId next_id;
+    unsigned long mixed;
+    std::vector<int> sum;
+
+    StageTiming timing;
+  };
+
+  /**
+   * @}
+   */
+};
+
+#endif
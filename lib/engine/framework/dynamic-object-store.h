@@ -38,25 +38,85 @@
 
 #include <boost/signals2.hpp>
 #include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/unordered_map.hpp>
 #include <iostream>
+#include <iterator>
+#include <vector>
 
 #include <boost/smart_ptr.hpp>
 #include <typeinfo>
 
-#include "map-key-iterator.h"
-#include "map-key-const-iterator.h"
 #include "scoped-connections.h"
 
+/* The objects are kept packed in a vector (removing one moves the last in
+ * its place, so the order is not meaningful), with their connections
+ * alongside. A hash table gives the position of each object, so adding,
+ * finding and removing one doesn't depend on the size of the store.
+ *
+ * A store can also be given a key function (typically giving an uri),
+ * and then keeps a secondary index on it : the objects with a given key
+ * are found without walking the whole store. The key of an object is
+ * computed when it is added ; if it can change, call update_key after.
+ */
+
 namespace Ekiga
 {
   template<typename ObjectType>
-  class DynamicObjectStore
+  class DynamicObjectStore: public boost::noncopyable
   {
+    struct Entry
+    {
+      boost::shared_ptr<ObjectType> object;
+      std::vector<boost::signals2::connection> connections;
+      std::string key;
+    };
+
+    typedef std::vector<Entry> entries_type;
+
   public:
 
-    typedef std::map<boost::shared_ptr<ObjectType>, boost::shared_ptr<scoped_connections> > container_type;
-    typedef Ekiga::map_key_iterator<container_type> iterator;
-    typedef Ekiga::map_key_const_iterator<container_type> const_iterator;
+    /* the iterators stay usable when objects are added, but removing one
+     * while iterating means skipping another */
+    class iterator
+    {
+    public:
+
+      typedef std::forward_iterator_tag iterator_category;
+      typedef boost::shared_ptr<ObjectType> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const boost::shared_ptr<ObjectType>* pointer;
+      typedef const boost::shared_ptr<ObjectType>& reference;
+
+      iterator (const entries_type* entries_, size_t pos_): entries(entries_), pos(pos_)
+      {}
+
+      bool operator== (const iterator& other) const
+      { return entries == other.entries && pos == other.pos; }
+
+      bool operator!= (const iterator& other) const
+      { return !(*this == other); }
+
+      iterator& operator++ ()
+      { ++pos; return *this; }
+
+      iterator operator++ (int)
+      { iterator tmp = *this; ++pos; return tmp; }
+
+      reference operator* () const
+      { return (*entries)[pos].object; }
+
+      pointer operator-> () const
+      { return &(*entries)[pos].object; }
+
+    private:
+      const entries_type* entries;
+      size_t pos;
+    };
+
+    typedef iterator const_iterator;
+
+    typedef boost::function1<std::string, boost::shared_ptr<ObjectType> > key_function;
 
     ~DynamicObjectStore ();
 
@@ -73,6 +133,23 @@ namespace Ekiga
 
     int size () const;
 
+    bool contains (boost::shared_ptr<ObjectType> obj) const;
+
+    /* secondary index: must be set while the store is still empty */
+    void set_key (key_function key_of);
+
+    void update_key (boost::shared_ptr<ObjectType> obj);
+
+    /* the key the object was indexed with, empty if it isn't stored */
+    const std::string get_key (boost::shared_ptr<ObjectType> obj) const;
+
+    boost::shared_ptr<ObjectType> find_by_key (const std::string key) const;
+
+    int count_by_key (const std::string key) const;
+
+    void visit_objects_by_key (const std::string key,
+                               boost::function1<bool, boost::shared_ptr<ObjectType> > visitor) const;
+
     iterator begin ();
     iterator end ();
 
@@ -84,7 +161,21 @@ namespace Ekiga
     boost::signals2::signal<void(boost::shared_ptr<ObjectType>)> object_updated;
 
   private:
-    container_type objects;
+
+    bool find_position (const ObjectType* obj,
+                        size_t& pos) const;
+
+    void index_key (size_t pos);
+    void unindex_key (size_t pos);
+
+    entries_type entries;
+
+    typedef boost::unordered_map<const ObjectType*, size_t> positions_type;
+    positions_type positions;
+
+    key_function key_of;
+    typedef boost::unordered_multimap<std::string, const ObjectType*> keys_type;
+    keys_type keys;
   };
 
 };
@@ -93,6 +184,13 @@ namespace Ekiga
 template<typename ObjectType>
 Ekiga::DynamicObjectStore<ObjectType>::~DynamicObjectStore ()
 {
+  for (typename entries_type::iterator iter = entries.begin ();
+       iter != entries.end ();
+       ++iter)
+    for (std::vector<boost::signals2::connection>::iterator conn = iter->connections.begin ();
+         conn != iter->connections.end ();
+         ++conn)
+      conn->disconnect ();
 }
 
 
@@ -101,27 +199,52 @@ void
 Ekiga::DynamicObjectStore<ObjectType>::visit_objects (boost::function1<bool, boost::shared_ptr<ObjectType> > visitor) const
 {
   bool go_on = true;
-  for (typename container_type::const_iterator iter = objects.begin ();
-       go_on && iter != objects.end ();
-       ++iter)
-    go_on = visitor (iter->first);
+  for (size_t pos = 0;
+       go_on && pos < entries.size ();
+       ++pos)
+    go_on = visitor (entries[pos].object);
+}
+
+template<typename ObjectType>
+bool
+Ekiga::DynamicObjectStore<ObjectType>::find_position (const ObjectType* obj,
+                                                      size_t& pos) const
+{
+  typename positions_type::const_iterator iter = positions.find (obj);
+
+  if (iter == positions.end ())
+    return false;
+
+  pos = iter->second;
+  return true;
 }
 
 template<typename ObjectType>
 void
 Ekiga::DynamicObjectStore<ObjectType>::add_object (boost::shared_ptr<ObjectType> obj)
 {
-  typename container_type::iterator iter = objects.find (obj);
-  if (iter == objects.end ()) {
-    objects[obj] = boost::shared_ptr<scoped_connections> (new scoped_connections);
-    object_added (obj);
+  size_t pos;
 
-    objects[obj]->add (obj->updated.connect (boost::bind (boost::ref (object_updated), _1)));
-    // this must be the last slot to execute
-    // the other slots connecting to removed signal must add at_front parameter
-    // in boost signals2 it is not possible to specify a slot to be executed last when the following slots are added without parameter
-    objects[obj]->add (obj->removed.connect (boost::bind (&Ekiga::DynamicObjectStore<ObjectType>::remove_object, this, _1)));
-  }
+  if (find_position (obj.get (), pos))
+    return;
+
+  pos = entries.size ();
+  entries.push_back (Entry ());
+  entries[pos].object = obj;
+  positions[obj.get ()] = pos;
+  index_key (pos);
+
+  object_added (obj);
+
+  // the slots may have changed the store
+  if ( !find_position (obj.get (), pos))
+    return;
+
+  entries[pos].connections.push_back (obj->updated.connect (boost::bind (boost::ref (object_updated), _1)));
+  // this must be the last slot to execute
+  // the other slots connecting to removed signal must add at_front parameter
+  // in boost signals2 it is not possible to specify a slot to be executed last when the following slots are added without parameter
+  entries[pos].connections.push_back (obj->removed.connect (boost::bind (&Ekiga::DynamicObjectStore<ObjectType>::remove_object, this, _1)));
 }
 
 template<typename ObjectType>
@@ -129,62 +252,215 @@ void
 Ekiga::DynamicObjectStore<ObjectType>::add_connection (boost::shared_ptr<ObjectType> obj,
                                                        boost::signals2::connection connection)
 {
-  typename container_type::iterator iter = objects.find (obj);
-  if (iter == objects.end ())
-    add_object (obj); // Add object
-  objects[obj]->add (connection);
+  size_t pos;
+
+  if ( !find_position (obj.get (), pos)) {
+
+    add_object (obj);
+    if ( !find_position (obj.get (), pos)) {
+
+      connection.disconnect ();
+      return;
+    }
+  }
+
+  entries[pos].connections.push_back (connection);
 }
 
 template<typename ObjectType>
 void
 Ekiga::DynamicObjectStore<ObjectType>::remove_object (boost::shared_ptr<ObjectType> obj)
 {
+  size_t pos;
+
+  if ( !find_position (obj.get (), pos))
+    return;
+
   object_removed (obj);
-  objects.erase (objects.find (obj));
+
+  // the slots may have changed the store
+  if ( !find_position (obj.get (), pos))
+    return;
+
+  for (std::vector<boost::signals2::connection>::iterator iter = entries[pos].connections.begin ();
+       iter != entries[pos].connections.end ();
+       ++iter)
+    iter->disconnect ();
+
+  unindex_key (pos);
+  positions.erase (obj.get ());
+
+  const size_t last = entries.size () - 1;
+  if (pos != last) {
+
+    entries[pos].object.swap (entries[last].object);
+    entries[pos].connections.swap (entries[last].connections);
+    entries[pos].key.swap (entries[last].key);
+    positions[entries[pos].object.get ()] = pos;
+  }
+  entries.pop_back ();
 }
 
 template<typename ObjectType>
 void
 Ekiga::DynamicObjectStore<ObjectType>::remove_all_objects ()
 {
-  /* iterators get invalidated as we go, hence the strange loop */
-  while ( !objects.empty ())
-    remove_object (objects.begin ()->first);
+  /* the slots may remove other objects as we go, hence the strange loop */
+  while ( !entries.empty ())
+    remove_object (entries.back ().object);
 }
 
 template<typename ObjectType>
 int
 Ekiga::DynamicObjectStore<ObjectType>::size () const
 {
-  return objects.size ();
+  return entries.size ();
+}
+
+template<typename ObjectType>
+bool
+Ekiga::DynamicObjectStore<ObjectType>::contains (boost::shared_ptr<ObjectType> obj) const
+{
+  return positions.find (obj.get ()) != positions.end ();
+}
+
+template<typename ObjectType>
+void
+Ekiga::DynamicObjectStore<ObjectType>::set_key (key_function key_of_)
+{
+  key_of = key_of_;
+
+  keys.clear ();
+  for (size_t pos = 0; pos < entries.size (); ++pos)
+    index_key (pos);
+}
+
+template<typename ObjectType>
+void
+Ekiga::DynamicObjectStore<ObjectType>::update_key (boost::shared_ptr<ObjectType> obj)
+{
+  size_t pos;
+
+  if ( !find_position (obj.get (), pos))
+    return;
+
+  unindex_key (pos);
+  index_key (pos);
+}
+
+template<typename ObjectType>
+void
+Ekiga::DynamicObjectStore<ObjectType>::index_key (size_t pos)
+{
+  if ( !key_of)
+    return;
+
+  entries[pos].key = key_of (entries[pos].object);
+  keys.insert (std::make_pair (entries[pos].key, entries[pos].object.get ()));
+}
+
+template<typename ObjectType>
+void
+Ekiga::DynamicObjectStore<ObjectType>::unindex_key (size_t pos)
+{
+  if ( !key_of)
+    return;
+
+  std::pair<typename keys_type::iterator, typename keys_type::iterator> range = keys.equal_range (entries[pos].key);
+  for (typename keys_type::iterator iter = range.first;
+       iter != range.second;
+       ++iter) {
+
+    if (iter->second == entries[pos].object.get ()) {
+
+      keys.erase (iter);
+      break;
+    }
+  }
+}
+
+template<typename ObjectType>
+const std::string
+Ekiga::DynamicObjectStore<ObjectType>::get_key (boost::shared_ptr<ObjectType> obj) const
+{
+  size_t pos;
+
+  if ( !find_position (obj.get (), pos))
+    return "";
+
+  return entries[pos].key;
+}
+
+template<typename ObjectType>
+boost::shared_ptr<ObjectType>
+Ekiga::DynamicObjectStore<ObjectType>::find_by_key (const std::string key) const
+{
+  typename keys_type::const_iterator iter = keys.find (key);
+  size_t pos;
+
+  if (iter == keys.end () || !find_position (iter->second, pos))
+    return boost::shared_ptr<ObjectType> ();
+
+  return entries[pos].object;
+}
+
+template<typename ObjectType>
+int
+Ekiga::DynamicObjectStore<ObjectType>::count_by_key (const std::string key) const
+{
+  return keys.count (key);
+}
+
+template<typename ObjectType>
+void
+Ekiga::DynamicObjectStore<ObjectType>::visit_objects_by_key (const std::string key,
+                                                             boost::function1<bool, boost::shared_ptr<ObjectType> > visitor) const
+{
+  /* the visitor may change the index, so work on a copy of the range */
+  std::vector<boost::shared_ptr<ObjectType> > matches;
+  std::pair<typename keys_type::const_iterator, typename keys_type::const_iterator> range = keys.equal_range (key);
+
+  size_t pos;
+
+  for (typename keys_type::const_iterator iter = range.first;
+       iter != range.second;
+       ++iter)
+    if (find_position (iter->second, pos))
+      matches.push_back (entries[pos].object);
+
+  bool go_on = true;
+  for (typename std::vector<boost::shared_ptr<ObjectType> >::const_iterator iter = matches.begin ();
+       go_on && iter != matches.end ();
+       ++iter)
+    go_on = visitor (*iter);
 }
 
 template<typename ObjectType>
 typename Ekiga::DynamicObjectStore<ObjectType>::iterator
 Ekiga::DynamicObjectStore<ObjectType>::begin ()
 {
-  return iterator (objects.begin ());
+  return iterator (&entries, 0);
 }
 
 template<typename ObjectType>
 typename Ekiga::DynamicObjectStore<ObjectType>::iterator
 Ekiga::DynamicObjectStore<ObjectType>::end ()
 {
-  return iterator (objects.end ());
+  return iterator (&entries, entries.size ());
 }
 
 template<typename ObjectType>
 typename Ekiga::DynamicObjectStore<ObjectType>::const_iterator
 Ekiga::DynamicObjectStore<ObjectType>::begin () const
 {
-  return const_iterator (objects.begin ());
+  return const_iterator (&entries, 0);
 }
 
 template<typename ObjectType>
 typename Ekiga::DynamicObjectStore<ObjectType>::const_iterator
 Ekiga::DynamicObjectStore<ObjectType>::end () const
 {
-  return const_iterator (objects.end ());
+  return const_iterator (&entries, entries.size ());
 }
 
 #endif
@@ -38,16 +38,78 @@
 
 #include <algorithm>
 
+#include <glib.h>
+
 #if KICKSTART_DEBUG
 #include <iostream>
 #endif
 
-Ekiga::KickStart::KickStart ()
+struct Ekiga::KickStart::WarmUps
+{
+  WarmUps (): pending(0)
+  {
+    g_mutex_init (&mutex);
+    g_cond_init (&cond);
+    pool = g_thread_pool_new (run, this, MAX (2, (gint) g_get_num_processors ()), FALSE, NULL);
+  }
+
+  ~WarmUps ()
+  {
+    g_thread_pool_free (pool, FALSE, TRUE);
+    g_cond_clear (&cond);
+    g_mutex_clear (&mutex);
+  }
+
+  void push (boost::shared_ptr<Spark> spark)
+  {
+    g_mutex_lock (&mutex);
+    pending++;
+    g_mutex_unlock (&mutex);
+    g_thread_pool_push (pool, new boost::shared_ptr<Spark> (spark), NULL);
+  }
+
+  void wait ()
+  {
+    g_mutex_lock (&mutex);
+    while (pending > 0)
+      g_cond_wait (&cond, &mutex);
+    g_mutex_unlock (&mutex);
+  }
+
+  static void run (gpointer data,
+		   gpointer user_data)
+  {
+    boost::shared_ptr<Spark>* spark = (boost::shared_ptr<Spark>*) data;
+    WarmUps* self = (WarmUps*) user_data;
+    long long start = g_get_monotonic_time ();
+
+    (*spark)->warm_up ();
+
+    g_mutex_lock (&self->mutex);
+    self->spent[(*spark)->get_name ()] = g_get_monotonic_time () - start;
+    self->pending--;
+    g_cond_broadcast (&self->cond);
+    g_mutex_unlock (&self->mutex);
+
+    delete spark;
+  }
+
+  GThreadPool* pool;
+  GMutex mutex;
+  GCond cond;
+  unsigned pending;
+  std::map<std::string, long long> spent; // us
+};
+
+Ekiga::KickStart::KickStart (): warm_ups(new WarmUps), started(-1)
 {
 }
 
 Ekiga::KickStart::~KickStart ()
 {
+  // the sparks are still in use by the workers until then
+  delete warm_ups;
+
 #if KICKSTART_DEBUG
   std::cout << "KickStart(final log):"
 	    << std::endl;
@@ -104,6 +166,9 @@ Ekiga::KickStart::kick (Ekiga::ServiceCore& core,
     }
   }
 
+  if (started < 0)
+    started = g_get_monotonic_time ();
+
   // this makes sure we loop only if something needs to be done
   went_on = !(blanks.empty () && partials.empty ());
 
@@ -130,7 +195,8 @@ Ekiga::KickStart::kick (Ekiga::ServiceCore& core,
 		       disabled.end (), (*iter)->get_name ())
 	    == disabled.end ()) {
 
-	  result = (*iter)->try_initialize_more (core, argc, argv);
+	  if (requirements_met (core, **iter))
+	    result = try_spark (core, *iter, argc, argv);
 	} else {
 
 #if KICKSTART_DEBUG
@@ -203,7 +269,7 @@ Ekiga::KickStart::kick (Ekiga::ServiceCore& core,
 	   iter != temp.end ();
 	   ++iter) {
 
-	bool result = (*iter)->try_initialize_more (core, argc, argv);
+	bool result = try_spark (core, *iter, argc, argv);
 
 	if (result) {
 
@@ -256,3 +322,99 @@ Ekiga::KickStart::kick (Ekiga::ServiceCore& core,
     }
   }
 }
+
+void
+Ekiga::KickStart::report (std::ostream& stream) const
+{
+  stream << "KickStart: spark, state, attempts, time spent (ms), promoted at (ms), warm up (ms)" << std::endl;
+
+  g_mutex_lock (&warm_ups->mutex);
+
+  for (std::map<std::string, Timing>::const_iterator iter = timings.begin ();
+       iter != timings.end ();
+       ++iter) {
+
+    const Timing& timing = iter->second;
+    const char* state = "FULL";
+
+    for (std::list<boost::shared_ptr<Spark> >::const_iterator spark = blanks.begin ();
+	 spark != blanks.end ();
+	 ++spark)
+      if ((*spark)->get_name () == iter->first)
+	state = "BLANK";
+    for (std::list<boost::shared_ptr<Spark> >::const_iterator spark = partials.begin ();
+	 spark != partials.end ();
+	 ++spark)
+      if ((*spark)->get_name () == iter->first)
+	state = "PARTIAL";
+
+    stream << "\t" << iter->first
+	   << ", " << state
+	   << ", " << timing.attempts
+	   << ", " << timing.spent / 1000.0;
+    if (timing.promoted >= 0)
+      stream << ", " << timing.promoted / 1000.0;
+    else
+      stream << ", -";
+    std::map<std::string, long long>::const_iterator warm_up = warm_ups->spent.find (iter->first);
+    if (warm_up != warm_ups->spent.end ())
+      stream << ", " << warm_up->second / 1000.0;
+    else
+      stream << ", -";
+    if ( !timing.waiting_for.empty () && timing.promoted < 0)
+      stream << " (waiting for " << timing.waiting_for << ")";
+    stream << std::endl;
+  }
+
+  g_mutex_unlock (&warm_ups->mutex);
+}
+
+bool
+Ekiga::KickStart::requirements_met (Ekiga::ServiceCore& core,
+				    const Spark& spark)
+{
+  const std::list<std::string> requirements = spark.get_requirements ();
+
+  for (std::list<std::string>::const_iterator iter = requirements.begin ();
+       iter != requirements.end ();
+       ++iter)
+    if ( !core.get (*iter)) {
+
+      timings[spark.get_name ()].waiting_for = *iter;
+#if KICKSTART_DEBUG
+      std::cout << "KickStart(kick): " << spark.get_name ()
+		<< " waits for " << *iter << std::endl;
+#endif
+      return false;
+    }
+
+  return true;
+}
+
+bool
+Ekiga::KickStart::try_spark (Ekiga::ServiceCore& core,
+			     boost::shared_ptr<Spark> spark,
+			     int* argc,
+			     char** argv[])
+{
+  Timing& timing = timings[spark->get_name ()];
+  long long start = g_get_monotonic_time ();
+  bool result = spark->try_initialize_more (core, argc, argv);
+  long long end = g_get_monotonic_time ();
+
+  timing.attempts++;
+  timing.spent += end - start;
+  if (result && timing.promoted < 0) {
+
+    timing.promoted = end - started;
+    warm_ups->push (spark);
+  }
+
+  return result;
+}
+
+void
+Ekiga::KickStart::wait_warm_ups ()
+{
+  warm_ups->wait ();
+}
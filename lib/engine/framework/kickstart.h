@@ -58,8 +58,18 @@
  * - try_initialize_more shouldn't return 'true' if no new service could be
  * registered ;
  * - states should always evolve as BLANK -> PARTIAL -> FULL : no coming back!
+ *
+ * The sparks are always tried on the main thread : they register services
+ * and connect signals, and neither the core nor the signals are
+ * thread-safe. What is slow and thread-safe in a spark (probing devices,
+ * for example) goes in its warm_up method instead, which the kickstart
+ * object runs on a pool of worker threads once the spark got promoted,
+ * while the main thread goes on with the other sparks and the gui.
  */
 
+#include <map>
+#include <ostream>
+
 #include "services.h"
 
 namespace Ekiga
@@ -79,6 +89,20 @@ namespace Ekiga
 
     // this method is useful for debugging purposes
     virtual const std::string get_name () const = 0;
+
+    /* the services which must be in the core before it's worth calling
+     * try_initialize_more ; by default there are none declared, and the
+     * spark is tried on each pass
+     */
+    virtual const std::list<std::string> get_requirements () const
+    { return std::list<std::string> (); }
+
+    /* called once, from a worker thread, after the first successful
+     * try_initialize_more ; it mustn't use the core, only what the spark
+     * kept of it, and only if it is thread-safe
+     */
+    virtual void warm_up ()
+    {}
   };
 
   class KickStart
@@ -96,9 +120,45 @@ namespace Ekiga
 	       int* argc,
 	       char** argv[]);
 
+    /* waits for the warm ups started so far to finish */
+    void wait_warm_ups ();
+
+    /* for each spark : its state, how many times it was tried, the time
+     * spent in it, when it was first promoted (since the first kick), the
+     * time its warm up took and what it is still waiting for
+     */
+    void report (std::ostream& stream) const;
+
   private:
+
+    struct Timing
+    {
+      Timing (): attempts(0), spent(0), promoted(-1) {}
+
+      unsigned attempts;
+      long long spent;    // us
+      long long promoted; // us since the first kick, -1 if never
+      std::string waiting_for;
+    };
+
+    bool requirements_met (Ekiga::ServiceCore& core,
+			   const Spark& spark);
+
+    bool try_spark (Ekiga::ServiceCore& core,
+		    boost::shared_ptr<Spark> spark,
+		    int* argc,
+		    char** argv[]);
+
+    /* the worker pool, kept out of this header, which is included where
+     * glib isn't available
+     */
+    struct WarmUps;
+    WarmUps* warm_ups;
+
     std::list<boost::shared_ptr<Spark> > blanks;
     std::list<boost::shared_ptr<Spark> > partials;
+    std::map<std::string, Timing> timings;
+    long long started; // us, monotonic
   };
 };
 
@@ -42,10 +42,19 @@
 #include <signal.h>
 #endif
 
+#include <glib.h>
+
 #include "services.h"
 
-Ekiga::ServiceCore::ServiceCore (): closed(false)
+/* set for the thread which made the core, which runs the main loop : the
+ * loop isn't running yet while the engine starts, so the main context
+ * can't tell
+ */
+static GPrivate main_thread = G_PRIVATE_INIT (NULL);
+
+Ekiga::ServiceCore::ServiceCore (): closed(false), in_fallback(0)
 {
+  g_private_set (&main_thread, GINT_TO_POINTER (1));
 }
 
 Ekiga::ServiceCore::~ServiceCore ()
@@ -59,6 +68,8 @@ Ekiga::ServiceCore::~ServiceCore ()
 #endif
 
   /* this is supposed to free everything */
+  fallback.clear ();
+  services_index.clear ();
   services.clear ();
 
 #if DEBUG
@@ -95,8 +106,9 @@ Ekiga::ServiceCore::add (ServicePtr service)
 {
   bool result = false;
 
-  if ( !get (service->get_name ())) {
+  if ( !find (service->get_name ())) {
     services.push_front (service);
+    services_index[service->get_name ()] = service;
     service_added (service);
     result = true;
   } else {
@@ -118,6 +130,10 @@ Ekiga::ServiceCore::remove (ServicePtr service)
 {
   service_removed (service);
   services.remove (service);
+
+  services_index_type::iterator iter = services_index.find (service->get_name ());
+  if (iter != services_index.end () && iter->second == service)
+    services_index.erase (iter);
 }
 
 void
@@ -145,16 +161,21 @@ Ekiga::ServiceCore::close ()
 Ekiga::ServicePtr
 Ekiga::ServiceCore::get (const std::string name) const
 {
-  ServicePtr result;
-
-  for (services_type::const_iterator iter = services.begin ();
-       iter != services.end () && !result;
-       iter++)
-    if (name == (*iter)->get_name ()) {
-
-      result = *iter;
-    }
-
+  ServicePtr result = find (name);
+
+  /* the fallback loads plugins and runs their sparks, so it only runs in
+   * the main thread : other threads only get what is already there. It
+   * isn't reentrant either : what it triggers will have to find its
+   * dependencies already there
+   */
+  if ( !result && fallback
+       && g_private_get (&main_thread) != NULL
+       && g_atomic_int_compare_and_exchange (&in_fallback, 0, 1)) {
+
+    fallback (name);
+    g_atomic_int_set (&in_fallback, 0);
+    result = find (name);
+  }
 
 #if DEBUG
 
@@ -166,7 +187,51 @@ Ekiga::ServiceCore::get (const std::string name) const
 #endif
 
   return result;
+}
+
+Ekiga::ServicePtr
+Ekiga::ServiceCore::find (const std::string & name) const
+{
+  services_index_type::const_iterator iter = services_index.find (name);
 
+  if (iter != services_index.end ())
+    return iter->second;
+
+  return ServicePtr ();
+}
+
+static void
+call_when_named (const boost::signals2::connection& connection,
+                 Ekiga::ServicePtr service,
+                 const std::string name,
+                 boost::function1<void, Ekiga::ServicePtr> callback)
+{
+  if (service->get_name () == name) {
+
+    connection.disconnect ();
+    callback (service);
+  }
+}
+
+boost::signals2::connection
+Ekiga::ServiceCore::when_available (const std::string name,
+                                    boost::function1<void, ServicePtr> callback)
+{
+  ServicePtr service = find (name);
+
+  if (service) {
+
+    callback (service);
+    return boost::signals2::connection ();
+  }
+
+  return service_added.connect_extended (boost::bind (&call_when_named, _1, _2, name, callback));
+}
+
+void
+Ekiga::ServiceCore::set_fallback (boost::function1<void, const std::string &> fallback_)
+{
+  fallback = fallback_;
 }
 
 void
@@ -41,11 +41,15 @@
 
 #include <boost/smart_ptr.hpp>
 #include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/noncopyable.hpp>
 
 #include <list>
 #include <string>
 #include <boost/signals2.hpp>
 #include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/signals2/mutex.hpp>
 
 namespace Ekiga
 {
@@ -67,6 +71,21 @@ namespace Ekiga
   };
   typedef boost::shared_ptr<Service> ServicePtr;
 
+  /* A typed key for a service : the registry is still indexed by name (the
+   * plugins register theirs that way), but a lookup through a key can't
+   * ask for the wrong type, nor misspell the name
+   */
+  template<typename T>
+  struct ServiceKey
+  {
+    typedef boost::function1<void, boost::shared_ptr<T> > callback_type;
+
+    explicit ServiceKey (const char* name_): name(name_)
+    {}
+
+    const char* name;
+  };
+
 
   class ServiceCore
   {
@@ -86,24 +105,137 @@ namespace Ekiga
     boost::shared_ptr<T> get (const std::string name) const
     { return boost::dynamic_pointer_cast<T> (get (name)); }
 
+    template<typename T>
+    boost::shared_ptr<T> get (const ServiceKey<T>& key) const
+    { return get<T> (key.name); }
+
+    /* Calls back with the service as soon as it is there : right away if
+     * it already is, else when it gets added (once, then the connection
+     * is dropped). Unlike get, it never triggers the fallback.
+     */
+    boost::signals2::connection when_available (const std::string name,
+                                                boost::function1<void, ServicePtr> callback);
+
+    template<typename T>
+    boost::signals2::connection when_available (const ServiceKey<T>& key,
+                                                typename ServiceKey<T>::callback_type callback)
+    { return when_available (key.name, boost::bind (&ServiceCore::call_typed<T>, _1, callback)); }
+
     void close ();
 
     void dump (std::ostream &stream) const;
 
+    /* When get doesn't find a service, it calls this function (if any),
+     * which may add it, then looks again : that is how plugins get loaded
+     * lazily. That only happens in the main thread.
+     */
+    void set_fallback (boost::function1<void, const std::string &> fallback);
+
     boost::signals2::signal<void(ServicePtr)> service_added;
     boost::signals2::signal<void(ServicePtr)> service_removed;
 
   private:
 
+    ServicePtr find (const std::string & name) const;
+
+    template<typename T>
+    static void call_typed (ServicePtr service,
+                            typename ServiceKey<T>::callback_type callback)
+    {
+      boost::shared_ptr<T> typed = boost::dynamic_pointer_cast<T> (service);
+      if (typed)
+        callback (typed);
+    }
+
     bool closed;
 
+    boost::function1<void, const std::string &> fallback;
+    mutable int in_fallback;
+
     typedef std::list<ServicePtr> services_type;
     services_type services;
 
+    /* the list keeps the order for dump, this is for the lookups ; the
+     * services are still known by name, as plugins register them
+     */
+    typedef boost::unordered_map<std::string, ServicePtr> services_index_type;
+    services_index_type services_index;
+
   };
 
   typedef boost::shared_ptr<ServiceCore> ServiceCorePtr;
 
+  /* A typed handle on a service, for code which needs it often (or from
+   * other threads) : it is resolved when the service is added and dropped
+   * when it is removed, so getting it is a weak pointer lock and not a
+   * lookup by name.
+   *
+   * The slot is written from the thread adding and removing services, and
+   * read from any thread, hence the mutex.
+   */
+  template<typename T>
+  class ServiceHandle: boost::noncopyable
+  {
+  public:
+
+    ServiceHandle (ServiceCore& core,
+                   const std::string name_):
+      name(name_), slot(core.get<T> (name_))
+    {
+      connect (core);
+    }
+
+    ServiceHandle (ServiceCore& core,
+                   const ServiceKey<T>& key):
+      name(key.name), slot(core.get (key))
+    {
+      connect (core);
+    }
+
+    boost::shared_ptr<T> get () const
+    {
+      mutex.lock ();
+      boost::shared_ptr<T> result = slot.lock ();
+      mutex.unlock ();
+
+      return result;
+    }
+
+  private:
+
+    void connect (ServiceCore& core)
+    {
+      added = core.service_added.connect (boost::bind (&ServiceHandle::on_added, this, _1));
+      removed = core.service_removed.connect (boost::bind (&ServiceHandle::on_removed, this, _1));
+    }
+
+    void on_added (ServicePtr service)
+    {
+      if (service->get_name () == name) {
+
+        mutex.lock ();
+        slot = boost::dynamic_pointer_cast<T> (service);
+        mutex.unlock ();
+      }
+    }
+
+    void on_removed (ServicePtr service)
+    {
+      if (service->get_name () == name) {
+
+        mutex.lock ();
+        slot.reset ();
+        mutex.unlock ();
+      }
+    }
+
+    std::string name;
+    mutable boost::signals2::mutex mutex;
+    boost::weak_ptr<T> slot;
+    boost::signals2::scoped_connection added;
+    boost::signals2::scoped_connection removed;
+  };
+
   class BasicService: public Service
   {
   public:
@@ -0,0 +1,99 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         stage-timing.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the timing of the stages of a
+ *                          media pipeline.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+
+#include "stage-timing.h"
+
+/* microseconds between two reports of a stage */
+#define REPORT_INTERVAL 5000000
+
+bool
+Ekiga::StageTiming::is_enabled ()
+{
+  static const bool enabled = (g_getenv ("EKIGA_STAGE_TIMING") != NULL);
+
+  return enabled;
+}
+
+Ekiga::StageTiming::StageTiming (const std::string name_):
+  name(name_), window_start(0), count(0), total(0), longest(0)
+{
+  g_mutex_init (&mutex);
+}
+
+Ekiga::StageTiming::~StageTiming ()
+{
+  g_mutex_clear (&mutex);
+}
+
+void
+Ekiga::StageTiming::add (gint64 elapsed)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  g_mutex_lock (&mutex);
+
+  if (window_start == 0)
+    window_start = now;
+
+  count++;
+  total += elapsed;
+  if (elapsed > longest)
+    longest = elapsed;
+
+  if (now - window_start >= REPORT_INTERVAL)
+    report (now);
+
+  g_mutex_unlock (&mutex);
+}
+
+void
+Ekiga::StageTiming::report (gint64 now)
+{
+  const double seconds = (now - window_start) / 1000000.0;
+
+  std::cout << "Stage timing: " << name << ": "
+            << std::fixed << std::setprecision (1)
+            << count / seconds << " per second, "
+            << "mean " << (double) total / count / 1000.0 << " ms, "
+            << "longest " << longest / 1000.0 << " ms" << std::endl;
+
+  window_start = now;
+  count = 0;
+  total = 0;
+  longest = 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         stage-timing.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the timing of the stages of a
+ *                          media pipeline.
+ *
+ */
+
+#ifndef __STAGE_TIMING_H__
+#define __STAGE_TIMING_H__
+
+#include <string>
+#include <glib.h>
+#include <boost/noncopyable.hpp>
+
+/* Setting EKIGA_STAGE_TIMING makes each timed stage (grabbing a video
+ * frame, displaying it, encoding it...) print, every few seconds, how many
+ * times it ran and how long it took: enough to check that a pipeline keeps
+ * up with its frame rate. When it isn't set, timing a stage costs a test.
+ */
+
+namespace Ekiga
+{
+
+  /**
+   * @addtogroup services
+   * @{
+   */
+
+  class StageTiming: public boost::noncopyable
+  {
+  public:
+
+    StageTiming (const std::string name_);
+
+    ~StageTiming ();
+
+    static bool is_enabled ();
+
+    /* Can be called from any thread */
+    void add (gint64 elapsed);  // in microseconds
+
+  private:
+
+    void report (gint64 now);
+
+    std::string name;
+    GMutex mutex;
+    gint64 window_start;
+    unsigned count;
+    gint64 total;
+    gint64 longest;
+  };
+
+  /* Times the stage for as long as it lives */
+  class StageTimer
+  {
+  public:
+
+    StageTimer (StageTiming & timing_): timing(timing_),
+      start(StageTiming::is_enabled () ? g_get_monotonic_time () : 0)
+    {}
+
+    ~StageTimer ()
+    {
+      if (start != 0)
+        timing.add (g_get_monotonic_time () - start);
+    }
+
+  private:
+
+    StageTiming & timing;
+    gint64 start;
+  };
+
+  /**
+   * @}
+   */
+};
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         trace-ring.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the binary trace ring
+ *
+ */
+
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "trace-ring.h"
+
+/* must be a power of two */
+#define TRACE_RING_SIZE 8192
+
+static Ekiga::TraceRecord* ring = NULL;
+static volatile gint head = 0;
+static char dump_path[4096];
+
+/* the threads are numbered as they first record something */
+static GPrivate thread_number = G_PRIVATE_INIT (NULL);
+static volatile gint thread_count = 0;
+
+static uint16_t
+get_thread_number ()
+{
+  gpointer number = g_private_get (&thread_number);
+
+  if (number == NULL) {
+
+    number = GINT_TO_POINTER (g_atomic_int_add (&thread_count, 1) + 1);
+    g_private_set (&thread_number, number);
+  }
+
+  return (uint16_t) GPOINTER_TO_UINT (number);
+}
+
+static void
+copy_field (char* dest,
+            const char* src,
+            size_t size)
+{
+  size_t ii = 0;
+
+  if (src != NULL)
+    for (; ii < size - 1 && src[ii] != '\0'; ii++)
+      dest[ii] = src[ii];
+  for (; ii < size; ii++)
+    dest[ii] = '\0';
+}
+
+#ifndef WIN32
+static const int crash_signals[] = { SIGSEGV, SIGBUS, SIGABRT, SIGFPE };
+static struct sigaction previous_actions[G_N_ELEMENTS (crash_signals)];
+
+static void
+on_dump_signal (G_GNUC_UNUSED int signum)
+{
+  Ekiga::TraceRing::dump ();
+}
+
+/* dumps, then gives the signal to whoever handled it before us */
+static void
+on_crash_signal (int signum)
+{
+  Ekiga::TraceRing::dump ();
+
+  for (unsigned ii = 0; ii < G_N_ELEMENTS (crash_signals); ii++)
+    if (crash_signals[ii] == signum)
+      sigaction (signum, &previous_actions[ii], NULL);
+  raise (signum);
+}
+
+static void
+install_handler (int signum,
+                 void (*handler) (int),
+                 struct sigaction* previous)
+{
+  struct sigaction action;
+
+  memset (&action, 0, sizeof (action));
+  action.sa_handler = handler;
+  sigemptyset (&action.sa_mask);
+  sigaction (signum, &action, previous);
+}
+#endif
+
+
+void
+Ekiga::TraceRing::init (const char* dump_file)
+{
+  if (ring != NULL || dump_file == NULL || *dump_file == '\0')
+    return;
+
+  copy_field (dump_path, dump_file, sizeof (dump_path));
+  ring = g_new0 (Ekiga::TraceRecord, TRACE_RING_SIZE);
+
+#ifndef WIN32
+  /* SIGUSR1 only if nobody uses it already */
+  struct sigaction current;
+  if (sigaction (SIGUSR1, NULL, &current) == 0
+      && !(current.sa_flags & SA_SIGINFO) && current.sa_handler == SIG_DFL)
+    install_handler (SIGUSR1, on_dump_signal, NULL);
+
+  for (unsigned ii = 0; ii < G_N_ELEMENTS (crash_signals); ii++)
+    install_handler (crash_signals[ii], on_crash_signal, &previous_actions[ii]);
+#endif
+}
+
+
+bool
+Ekiga::TraceRing::is_enabled ()
+{
+  return ring != NULL;
+}
+
+
+void
+Ekiga::TraceRing::record (TraceEvent event,
+                          int64_t value,
+                          const char* id,
+                          const char* text)
+{
+  if (ring == NULL)
+    return;
+
+  /* Each writer gets its own slot ; the sequence number tells the readers
+   * when the record is complete.
+   */
+  guint32 sequence = (guint32) g_atomic_int_add (&head, 1) + 1;
+  Ekiga::TraceRecord* rec = &ring[sequence & (TRACE_RING_SIZE - 1)];
+
+  g_atomic_int_set ((volatile gint*) &rec->sequence, 0);
+  rec->timestamp = g_get_monotonic_time ();
+  rec->event = event;
+  rec->thread = get_thread_number ();
+  rec->value = value;
+  copy_field (rec->id, id, sizeof (rec->id));
+  copy_field (rec->text, text, sizeof (rec->text));
+  g_atomic_int_set ((volatile gint*) &rec->sequence, sequence);
+}
+
+
+/* This is called from signal handlers : it must only use async-signal-safe
+ * functions, hence no stdio and no allocation.
+ */
+bool
+Ekiga::TraceRing::dump ()
+{
+  Ekiga::TraceHeader header;
+  guint32 last = (guint32) g_atomic_int_get (&head);
+  guint32 first = (last > TRACE_RING_SIZE) ? last - TRACE_RING_SIZE + 1 : 1;
+  bool result = true;
+  int fd = -1;
+
+  if (ring == NULL)
+    return false;
+
+  fd = open (dump_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    return false;
+
+  memcpy (header.magic, EKIGA_TRACE_MAGIC, sizeof (header.magic));
+  header.record_size = sizeof (Ekiga::TraceRecord);
+  header.count = 0;
+  result = (write (fd, &header, sizeof (header)) == sizeof (header));
+
+  /* The other threads keep recording meanwhile : a record is copied, then
+   * only written if its sequence number didn't change during the copy,
+   * since that would mean it was being (over)written.
+   */
+  for (guint32 sequence = first; result && sequence <= last && sequence != 0; sequence++) {
+
+    Ekiga::TraceRecord* slot = &ring[sequence & (TRACE_RING_SIZE - 1)];
+    Ekiga::TraceRecord rec;
+
+    if ((guint32) g_atomic_int_get ((volatile gint*) &slot->sequence) != sequence)
+      continue;
+    memcpy (&rec, slot, sizeof (rec));
+    if ((guint32) g_atomic_int_get ((volatile gint*) &slot->sequence) != sequence)
+      continue;
+
+    rec.sequence = sequence;
+    result = (write (fd, &rec, sizeof (rec)) == sizeof (rec));
+    header.count++;
+  }
+
+  // now that we know how many records made it
+  if (result)
+    result = (lseek (fd, 0, SEEK_SET) == 0
+              && write (fd, &header, sizeof (header)) == sizeof (header));
+
+  close (fd);
+
+  return result;
+}
@@ -0,0 +1,130 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         trace-ring.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : interface of the binary trace ring
+ *
+ */
+
+#ifndef __TRACE_RING_H__
+#define __TRACE_RING_H__
+
+#include <stdint.h>
+
+/* The trace ring keeps the last events of interest (call signalling, media
+ * streams, devices) as fixed-size binary records in memory, which is cheap
+ * enough to be left on, unlike PTRACE. It is dumped to a file on demand
+ * (SIGUSR1, unless something else handles it) or when ekiga crashes, and
+ * read back by ekiga-trace-analyser.
+ *
+ * It is enabled by giving a dump file in the EKIGA_TRACE_FILE environment
+ * variable.
+ */
+
+namespace Ekiga
+{
+
+  /**
+   * @addtogroup services
+   * @{
+   */
+
+  /* The event ids are stored in the dumps : only append to this list */
+  enum TraceEvent {
+
+    TraceCallSetUp = 1,
+    TraceCallAlerting,
+    TraceCallEstablished,
+    TraceCallCleared,
+    TraceMediaOpened,
+    TraceMediaClosed,
+    TraceSipReceived,
+    TraceDeviceOpened,
+    TraceDeviceClosed,
+    TraceDeviceError,
+    TraceSipSent,
+    TraceCallIdMapped,  // id is the call token, text its SIP Call-ID
+    TraceEventCount
+  };
+
+#define EKIGA_TRACE_MAGIC "EKTRACE1"
+#define EKIGA_TRACE_ID_SIZE 32
+#define EKIGA_TRACE_TEXT_SIZE 64
+
+  /* A dump is made of a TraceHeader, then of its records, oldest first */
+  struct TraceHeader
+  {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t count;
+  };
+
+  struct TraceRecord
+  {
+    uint64_t timestamp;  // microseconds, monotonic clock
+    uint32_t sequence;   // 0 while the record is being written
+    uint16_t event;
+    uint16_t thread;     // numbered in the order threads first record
+    int64_t value;
+    char id[EKIGA_TRACE_ID_SIZE];  // which call, which device...
+    char text[EKIGA_TRACE_TEXT_SIZE];
+  };
+
+  namespace TraceRing
+  {
+    /* Allocates the ring and installs the signal handlers ; until it is
+     * called, the traces are not recorded.
+     */
+    void init (const char* dump_file);
+
+    bool is_enabled ();
+
+    /* Can be called from any thread : this doesn't take any lock */
+    void record (TraceEvent event,
+                 int64_t value,
+                 const char* id,
+                 const char* text);
+
+    /* Writes the ring to the dump file ; returns false on failure */
+    bool dump ();
+  };
+
+  /**
+   * @}
+   */
+};
+
+#define EKIGA_TRACE(event, value, id, text)                             \
+  do {                                                                  \
+    if (Ekiga::TraceRing::is_enabled ())                                \
+      Ekiga::TraceRing::record (Ekiga::event, value, id, text);         \
+  } while (0)
+
+#endif
@@ -0,0 +1,781 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         video-kernels.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the I420 picture operations
+ *                          shared by the capture and display code.
+ *
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "video-kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__ ((target ("sse2")))
+#define TARGET_AVX2 __attribute__ ((target ("avx2")))
+#endif
+
+using namespace Ekiga::VideoKernels;
+
+/* The pictures are handled line by line, by those: the frame-level code
+ * below only computes where the lines are.
+ */
+namespace
+{
+  struct Kernels
+  {
+    /* d = (s * alpha + d * (256 - alpha) + 128) >> 8 */
+    void (*blend_row) (const unsigned char* s,
+                       unsigned char* d,
+                       unsigned n,
+                       unsigned alpha);
+
+    /* d[i] = s[n - 1 - i] */
+    void (*mirror_row) (const unsigned char* s,
+                        unsigned char* d,
+                        unsigned n);
+
+    /* d[i] = the rounded mean of s0[2i], s0[2i+1], s1[2i], s1[2i+1] */
+    void (*halve_row) (const unsigned char* s0,
+                       const unsigned char* s1,
+                       unsigned char* d,
+                       unsigned n);
+
+    /* d = (s0 * (256 - weight) + s1 * weight + 128) >> 8 */
+    void (*lerp_row) (const unsigned char* s0,
+                      const unsigned char* s1,
+                      unsigned char* d,
+                      unsigned n,
+                      unsigned weight);
+
+    /* n pixels of a line, its chroma being half as wide */
+    void (*rgba_row) (const unsigned char* y,
+                      const unsigned char* u,
+                      const unsigned char* v,
+                      unsigned char* d,
+                      unsigned n);
+  };
+
+  /* the scalar reference */
+
+  void
+  blend_row_c (const unsigned char* s,
+               unsigned char* d,
+               unsigned n,
+               unsigned alpha)
+  {
+    for (unsigned i = 0; i < n; i++)
+      d[i] = (s[i] * alpha + d[i] * (256 - alpha) + 128) >> 8;
+  }
+
+  void
+  mirror_row_c (const unsigned char* s,
+                unsigned char* d,
+                unsigned n)
+  {
+    for (unsigned i = 0; i < n; i++)
+      d[i] = s[n - 1 - i];
+  }
+
+  void
+  halve_row_c (const unsigned char* s0,
+               const unsigned char* s1,
+               unsigned char* d,
+               unsigned n)
+  {
+    for (unsigned i = 0; i < n; i++)
+      d[i] = (s0[2 * i] + s0[2 * i + 1] + s1[2 * i] + s1[2 * i + 1] + 2) >> 2;
+  }
+
+  void
+  lerp_row_c (const unsigned char* s0,
+              const unsigned char* s1,
+              unsigned char* d,
+              unsigned n,
+              unsigned weight)
+  {
+    for (unsigned i = 0; i < n; i++)
+      d[i] = (s0[i] * (256 - weight) + s1[i] * weight + 128) >> 8;
+  }
+
+  inline unsigned char
+  clamp_byte (int value)
+  {
+    return (unsigned char) std::min (std::max (value, 0), 255);
+  }
+
+  void
+  rgba_pixel (unsigned char y,
+              unsigned char u,
+              unsigned char v,
+              unsigned char* d)
+  {
+    const int c = y - 16;
+    const int e = v - 128;
+    const int f = u - 128;
+
+    d[0] = clamp_byte ((298 * c + 409 * e + 128) >> 8);
+    d[1] = clamp_byte ((298 * c - 100 * f - 208 * e + 128) >> 8);
+    d[2] = clamp_byte ((298 * c + 516 * f + 128) >> 8);
+    d[3] = 255;
+  }
+
+  void
+  rgba_row_c (const unsigned char* y,
+              const unsigned char* u,
+              const unsigned char* v,
+              unsigned char* d,
+              unsigned n)
+  {
+    for (unsigned i = 0; i < n; i++)
+      rgba_pixel (y[i], u[i / 2], v[i / 2], d + 4 * i);
+  }
+
+  const Kernels scalar_kernels = {
+    blend_row_c, mirror_row_c, halve_row_c, lerp_row_c, rgba_row_c
+  };
+
+#ifdef HAVE_X86_KERNELS
+
+  /* SSE2: 16 bytes at a time, 16-bit intermediates (which can't overflow:
+   * 255 * 256 + 128 < 65536) ; the tails are left to the reference */
+
+  TARGET_SSE2 inline __m128i
+  mix_sse2 (__m128i a,
+            __m128i b,
+            __m128i wa,
+            __m128i wb)
+  {
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i half = _mm_set1_epi16 (128);
+
+    __m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (a, zero), wa),
+                                _mm_mullo_epi16 (_mm_unpacklo_epi8 (b, zero), wb));
+    __m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (a, zero), wa),
+                                _mm_mullo_epi16 (_mm_unpackhi_epi8 (b, zero), wb));
+    lo = _mm_srli_epi16 (_mm_add_epi16 (lo, half), 8);
+    hi = _mm_srli_epi16 (_mm_add_epi16 (hi, half), 8);
+
+    return _mm_packus_epi16 (lo, hi);
+  }
+
+  TARGET_SSE2 void
+  blend_row_sse2 (const unsigned char* s,
+                  unsigned char* d,
+                  unsigned n,
+                  unsigned alpha)
+  {
+    const __m128i ws = _mm_set1_epi16 (alpha);
+    const __m128i wd = _mm_set1_epi16 (256 - alpha);
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+
+      __m128i a = _mm_loadu_si128 ((const __m128i*) (s + i));
+      __m128i b = _mm_loadu_si128 ((const __m128i*) (d + i));
+      _mm_storeu_si128 ((__m128i*) (d + i), mix_sse2 (a, b, ws, wd));
+    }
+    blend_row_c (s + i, d + i, n - i, alpha);
+  }
+
+  TARGET_SSE2 void
+  lerp_row_sse2 (const unsigned char* s0,
+                 const unsigned char* s1,
+                 unsigned char* d,
+                 unsigned n,
+                 unsigned weight)
+  {
+    const __m128i w0 = _mm_set1_epi16 (256 - weight);
+    const __m128i w1 = _mm_set1_epi16 (weight);
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+
+      __m128i a = _mm_loadu_si128 ((const __m128i*) (s0 + i));
+      __m128i b = _mm_loadu_si128 ((const __m128i*) (s1 + i));
+      _mm_storeu_si128 ((__m128i*) (d + i), mix_sse2 (a, b, w0, w1));
+    }
+    lerp_row_c (s0 + i, s1 + i, d + i, n - i, weight);
+  }
+
+  TARGET_SSE2 void
+  mirror_row_sse2 (const unsigned char* s,
+                   unsigned char* d,
+                   unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+
+      __m128i x = _mm_loadu_si128 ((const __m128i*) (s + n - 16 - i));
+      x = _mm_shuffle_epi32 (x, _MM_SHUFFLE (0, 1, 2, 3));
+      x = _mm_shufflelo_epi16 (x, _MM_SHUFFLE (2, 3, 0, 1));
+      x = _mm_shufflehi_epi16 (x, _MM_SHUFFLE (2, 3, 0, 1));
+      x = _mm_or_si128 (_mm_slli_epi16 (x, 8), _mm_srli_epi16 (x, 8));
+      _mm_storeu_si128 ((__m128i*) (d + i), x);
+    }
+    for (; i < n; i++)
+      d[i] = s[n - 1 - i];
+  }
+
+  /* the sums of the 8 pairs of bytes of a row, and of the row below */
+  TARGET_SSE2 inline __m128i
+  quad_sums_sse2 (const unsigned char* s0,
+                  const unsigned char* s1)
+  {
+    const __m128i mask = _mm_set1_epi16 (0xff);
+    __m128i a = _mm_loadu_si128 ((const __m128i*) s0);
+    __m128i b = _mm_loadu_si128 ((const __m128i*) s1);
+
+    __m128i sum = _mm_add_epi16 (_mm_and_si128 (a, mask), _mm_srli_epi16 (a, 8));
+    sum = _mm_add_epi16 (sum, _mm_and_si128 (b, mask));
+    sum = _mm_add_epi16 (sum, _mm_srli_epi16 (b, 8));
+
+    return _mm_srli_epi16 (_mm_add_epi16 (sum, _mm_set1_epi16 (2)), 2);
+  }
+
+  TARGET_SSE2 void
+  halve_row_sse2 (const unsigned char* s0,
+                  const unsigned char* s1,
+                  unsigned char* d,
+                  unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+
+      __m128i lo = quad_sums_sse2 (s0 + 2 * i, s1 + 2 * i);
+      __m128i hi = quad_sums_sse2 (s0 + 2 * i + 16, s1 + 2 * i + 16);
+      _mm_storeu_si128 ((__m128i*) (d + i), _mm_packus_epi16 (lo, hi));
+    }
+    halve_row_c (s0 + 2 * i, s1 + 2 * i, d + i, n - i);
+  }
+
+  TARGET_SSE2 inline __m128i
+  coefficients (short a,
+                short b)
+  {
+    return _mm_set_epi16 (b, a, b, a, b, a, b, a);
+  }
+
+  /* 8 pixels at a time, with _mm_madd_epi16 computing the sums of two
+   * products in 32 bits, exactly like the reference */
+  TARGET_SSE2 void
+  rgba_row_sse2 (const unsigned char* y,
+                 const unsigned char* u,
+                 const unsigned char* v,
+                 unsigned char* d,
+                 unsigned n)
+  {
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i one = _mm_set1_epi16 (1);
+    const __m128i half = _mm_set1_epi32 (128);
+    const __m128i alpha = _mm_set1_epi8 ((char) 0xff);
+    unsigned i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+
+      int chroma;
+      __m128i c = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*) (y + i)), zero);
+      memcpy (&chroma, u + i / 2, 4);
+      __m128i f = _mm_cvtsi32_si128 (chroma);
+      memcpy (&chroma, v + i / 2, 4);
+      __m128i e = _mm_cvtsi32_si128 (chroma);
+
+      f = _mm_unpacklo_epi8 (_mm_unpacklo_epi8 (f, f), zero);
+      e = _mm_unpacklo_epi8 (_mm_unpacklo_epi8 (e, e), zero);
+      c = _mm_sub_epi16 (c, _mm_set1_epi16 (16));
+      f = _mm_sub_epi16 (f, _mm_set1_epi16 (128));
+      e = _mm_sub_epi16 (e, _mm_set1_epi16 (128));
+
+      __m128i ce_lo = _mm_unpacklo_epi16 (c, e), ce_hi = _mm_unpackhi_epi16 (c, e);
+      __m128i cf_lo = _mm_unpacklo_epi16 (c, f), cf_hi = _mm_unpackhi_epi16 (c, f);
+      __m128i e1_lo = _mm_unpacklo_epi16 (e, one), e1_hi = _mm_unpackhi_epi16 (e, one);
+
+      __m128i r = _mm_packs_epi32 (_mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (ce_lo, coefficients (298, 409)), half), 8),
+                                   _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (ce_hi, coefficients (298, 409)), half), 8));
+      __m128i g = _mm_packs_epi32 (_mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (cf_lo, coefficients (298, -100)),
+                                                                  _mm_madd_epi16 (e1_lo, coefficients (-208, 128))), 8),
+                                   _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (cf_hi, coefficients (298, -100)),
+                                                                  _mm_madd_epi16 (e1_hi, coefficients (-208, 128))), 8));
+      __m128i b = _mm_packs_epi32 (_mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (cf_lo, coefficients (298, 516)), half), 8),
+                                   _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (cf_hi, coefficients (298, 516)), half), 8));
+
+      r = _mm_packus_epi16 (r, r);
+      g = _mm_packus_epi16 (g, g);
+      b = _mm_packus_epi16 (b, b);
+
+      __m128i rg = _mm_unpacklo_epi8 (r, g);
+      __m128i ba = _mm_unpacklo_epi8 (b, alpha);
+      _mm_storeu_si128 ((__m128i*) (d + 4 * i), _mm_unpacklo_epi16 (rg, ba));
+      _mm_storeu_si128 ((__m128i*) (d + 4 * i + 16), _mm_unpackhi_epi16 (rg, ba));
+    }
+    for (; i < n; i++)
+      rgba_pixel (y[i], u[i / 2], v[i / 2], d + 4 * i);
+  }
+
+  const Kernels sse2_kernels = {
+    blend_row_sse2, mirror_row_sse2, halve_row_sse2, lerp_row_sse2, rgba_row_sse2
+  };
+
+  /* AVX2: the same, 32 bytes at a time ; most instructions work on each
+   * 128-bit half separately, which the packing undoes. The tails go to
+   * the SSE2 versions, after clearing the upper halves of the registers:
+   * mixing both kinds of code without that is very slow. */
+
+  TARGET_AVX2 inline __m256i
+  mix_avx2 (__m256i a,
+            __m256i b,
+            __m256i wa,
+            __m256i wb)
+  {
+    const __m256i zero = _mm256_setzero_si256 ();
+    const __m256i half = _mm256_set1_epi16 (128);
+
+    __m256i lo = _mm256_add_epi16 (_mm256_mullo_epi16 (_mm256_unpacklo_epi8 (a, zero), wa),
+                                   _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (b, zero), wb));
+    __m256i hi = _mm256_add_epi16 (_mm256_mullo_epi16 (_mm256_unpackhi_epi8 (a, zero), wa),
+                                   _mm256_mullo_epi16 (_mm256_unpackhi_epi8 (b, zero), wb));
+    lo = _mm256_srli_epi16 (_mm256_add_epi16 (lo, half), 8);
+    hi = _mm256_srli_epi16 (_mm256_add_epi16 (hi, half), 8);
+
+    return _mm256_packus_epi16 (lo, hi);
+  }
+
+  TARGET_AVX2 void
+  blend_row_avx2 (const unsigned char* s,
+                  unsigned char* d,
+                  unsigned n,
+                  unsigned alpha)
+  {
+    const __m256i ws = _mm256_set1_epi16 (alpha);
+    const __m256i wd = _mm256_set1_epi16 (256 - alpha);
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+
+      __m256i a = _mm256_loadu_si256 ((const __m256i*) (s + i));
+      __m256i b = _mm256_loadu_si256 ((const __m256i*) (d + i));
+      _mm256_storeu_si256 ((__m256i*) (d + i), mix_avx2 (a, b, ws, wd));
+    }
+    _mm256_zeroupper ();
+    blend_row_sse2 (s + i, d + i, n - i, alpha);
+  }
+
+  TARGET_AVX2 void
+  lerp_row_avx2 (const unsigned char* s0,
+                 const unsigned char* s1,
+                 unsigned char* d,
+                 unsigned n,
+                 unsigned weight)
+  {
+    const __m256i w0 = _mm256_set1_epi16 (256 - weight);
+    const __m256i w1 = _mm256_set1_epi16 (weight);
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+
+      __m256i a = _mm256_loadu_si256 ((const __m256i*) (s0 + i));
+      __m256i b = _mm256_loadu_si256 ((const __m256i*) (s1 + i));
+      _mm256_storeu_si256 ((__m256i*) (d + i), mix_avx2 (a, b, w0, w1));
+    }
+    _mm256_zeroupper ();
+    lerp_row_sse2 (s0 + i, s1 + i, d + i, n - i, weight);
+  }
+
+  TARGET_AVX2 void
+  mirror_row_avx2 (const unsigned char* s,
+                   unsigned char* d,
+                   unsigned n)
+  {
+    const __m256i reverse = _mm256_set_epi8 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                             0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+
+      __m256i x = _mm256_loadu_si256 ((const __m256i*) (s + n - 32 - i));
+      x = _mm256_shuffle_epi8 (x, reverse);
+      x = _mm256_permute2x128_si256 (x, x, 0x01);
+      _mm256_storeu_si256 ((__m256i*) (d + i), x);
+    }
+    _mm256_zeroupper ();
+    mirror_row_sse2 (s, d + i, n - i);
+  }
+
+  TARGET_AVX2 inline __m256i
+  quad_sums_avx2 (const unsigned char* s0,
+                  const unsigned char* s1)
+  {
+    const __m256i mask = _mm256_set1_epi16 (0xff);
+    __m256i a = _mm256_loadu_si256 ((const __m256i*) s0);
+    __m256i b = _mm256_loadu_si256 ((const __m256i*) s1);
+
+    __m256i sum = _mm256_add_epi16 (_mm256_and_si256 (a, mask), _mm256_srli_epi16 (a, 8));
+    sum = _mm256_add_epi16 (sum, _mm256_and_si256 (b, mask));
+    sum = _mm256_add_epi16 (sum, _mm256_srli_epi16 (b, 8));
+
+    return _mm256_srli_epi16 (_mm256_add_epi16 (sum, _mm256_set1_epi16 (2)), 2);
+  }
+
+  TARGET_AVX2 void
+  halve_row_avx2 (const unsigned char* s0,
+                  const unsigned char* s1,
+                  unsigned char* d,
+                  unsigned n)
+  {
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+
+      __m256i lo = quad_sums_avx2 (s0 + 2 * i, s1 + 2 * i);
+      __m256i hi = quad_sums_avx2 (s0 + 2 * i + 32, s1 + 2 * i + 32);
+      __m256i x = _mm256_packus_epi16 (lo, hi);
+      _mm256_storeu_si256 ((__m256i*) (d + i), _mm256_permute4x64_epi64 (x, _MM_SHUFFLE (3, 1, 2, 0)));
+    }
+    _mm256_zeroupper ();
+    halve_row_sse2 (s0 + 2 * i, s1 + 2 * i, d + i, n - i);
+  }
+
+  const Kernels avx2_kernels = {
+    blend_row_avx2, mirror_row_avx2, halve_row_avx2, lerp_row_avx2, rgba_row_sse2
+  };
+
+#endif
+
+  Level current_level = (Level) -1;
+
+  const Kernels &
+  kernels ()
+  {
+    if (current_level == (Level) -1)
+      current_level = get_best_level ();
+
+    switch (current_level) {
+
+#ifdef HAVE_X86_KERNELS
+    case AVX2:
+      return avx2_kernels;
+    case SSE2:
+      return sse2_kernels;
+#endif
+    case Scalar:
+    default:
+      return scalar_kernels;
+    }
+  }
+
+  /* the size of plane p of the picture */
+  inline unsigned
+  plane_width (unsigned width,
+               unsigned p)
+  {
+    return p == 0 ? width : width / 2;
+  }
+
+  inline unsigned
+  plane_height (unsigned height,
+                unsigned p)
+  {
+    return p == 0 ? height : height / 2;
+  }
+
+  /* Where src lands on dst, for blit and blend: false if nowhere */
+  struct Placement
+  {
+    unsigned src_x, src_y;
+    unsigned dst_x, dst_y;
+    unsigned width, height;
+  };
+
+  bool
+  place (const ConstI420 & src,
+         const I420 & dst,
+         unsigned p,
+         int x,
+         int y,
+         Placement & result)
+  {
+    const int shift = (p == 0 ? 0 : 1);
+    const int px = (x & ~1) >> shift;
+    const int py = (y & ~1) >> shift;
+    const int src_w = plane_width (src.width, p), src_h = plane_height (src.height, p);
+    const int dst_w = plane_width (dst.width, p), dst_h = plane_height (dst.height, p);
+
+    result.src_x = std::max (0, -px);
+    result.src_y = std::max (0, -py);
+    result.dst_x = std::max (0, px);
+    result.dst_y = std::max (0, py);
+
+    const int width = std::min (src_w - (int) result.src_x, dst_w - (int) result.dst_x);
+    const int height = std::min (src_h - (int) result.src_y, dst_h - (int) result.dst_y);
+    if (width <= 0 || height <= 0)
+      return false;
+
+    result.width = width;
+    result.height = height;
+    return true;
+  }
+};
+
+Ekiga::VideoKernels::ConstI420::ConstI420 (const char* frame,
+                                           unsigned width_,
+                                           unsigned height_):
+  width(width_), height(height_)
+{
+  planes[0] = (const unsigned char*) frame;
+  planes[1] = planes[0] + width * height;
+  planes[2] = planes[1] + (width / 2) * (height / 2);
+  strides[0] = width;
+  strides[1] = strides[2] = width / 2;
+}
+
+Ekiga::VideoKernels::I420::I420 (char* frame,
+                                 unsigned width_,
+                                 unsigned height_):
+  width(width_), height(height_)
+{
+  planes[0] = (unsigned char*) frame;
+  planes[1] = planes[0] + width * height;
+  planes[2] = planes[1] + (width / 2) * (height / 2);
+  strides[0] = width;
+  strides[1] = strides[2] = width / 2;
+}
+
+Ekiga::VideoKernels::I420::operator ConstI420 () const
+{
+  ConstI420 result ((const char*) planes[0], width, height);
+
+  for (unsigned p = 0; p < 3; p++) {
+
+    result.planes[p] = planes[p];
+    result.strides[p] = strides[p];
+  }
+
+  return result;
+}
+
+Level
+Ekiga::VideoKernels::get_best_level ()
+{
+#ifdef HAVE_X86_KERNELS
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    return AVX2;
+  if (__builtin_cpu_supports ("sse2"))
+    return SSE2;
+#endif
+
+  return Scalar;
+}
+
+Level
+Ekiga::VideoKernels::get_level ()
+{
+  kernels ();
+
+  return current_level;
+}
+
+void
+Ekiga::VideoKernels::set_level (Level level)
+{
+  current_level = std::min (level, get_best_level ());
+}
+
+void
+Ekiga::VideoKernels::fill (const I420 & dst,
+                           unsigned char y,
+                           unsigned char u,
+                           unsigned char v)
+{
+  const unsigned char values[3] = { y, u, v };
+
+  for (unsigned p = 0; p < 3; p++)
+    for (unsigned row = 0; row < plane_height (dst.height, p); row++)
+      memset (dst.planes[p] + row * dst.strides[p], values[p], plane_width (dst.width, p));
+}
+
+void
+Ekiga::VideoKernels::blit (const ConstI420 & src,
+                           const I420 & dst,
+                           int x,
+                           int y)
+{
+  Placement at;
+
+  for (unsigned p = 0; p < 3; p++) {
+
+    if (!place (src, dst, p, x, y, at))
+      continue;
+
+    for (unsigned row = 0; row < at.height; row++)
+      memcpy (dst.planes[p] + (at.dst_y + row) * dst.strides[p] + at.dst_x,
+              src.planes[p] + (at.src_y + row) * src.strides[p] + at.src_x,
+              at.width);
+  }
+}
+
+void
+Ekiga::VideoKernels::blend (const ConstI420 & src,
+                            const I420 & dst,
+                            int x,
+                            int y,
+                            unsigned alpha)
+{
+  const Kernels & k = kernels ();
+  Placement at;
+
+  alpha = std::min (alpha, 256u);
+
+  for (unsigned p = 0; p < 3; p++) {
+
+    if (!place (src, dst, p, x, y, at))
+      continue;
+
+    for (unsigned row = 0; row < at.height; row++)
+      k.blend_row (src.planes[p] + (at.src_y + row) * src.strides[p] + at.src_x,
+                   dst.planes[p] + (at.dst_y + row) * dst.strides[p] + at.dst_x,
+                   at.width, alpha);
+  }
+}
+
+void
+Ekiga::VideoKernels::mirror (const ConstI420 & src,
+                             const I420 & dst)
+{
+  const Kernels & k = kernels ();
+
+  if (src.width != dst.width || src.height != dst.height)
+    return;
+
+  for (unsigned p = 0; p < 3; p++)
+    for (unsigned row = 0; row < plane_height (src.height, p); row++)
+      k.mirror_row (src.planes[p] + row * src.strides[p],
+                    dst.planes[p] + row * dst.strides[p],
+                    plane_width (src.width, p));
+}
+
+void
+Ekiga::VideoKernels::halve (const ConstI420 & src,
+                            const I420 & dst)
+{
+  const Kernels & k = kernels ();
+
+  if (dst.width != src.width / 2 || dst.height != src.height / 2)
+    return;
+
+  for (unsigned p = 0; p < 3; p++)
+    for (unsigned row = 0; row < plane_height (dst.height, p); row++)
+      k.halve_row (src.planes[p] + 2 * row * src.strides[p],
+                   src.planes[p] + (2 * row + 1) * src.strides[p],
+                   dst.planes[p] + row * dst.strides[p],
+                   plane_width (dst.width, p));
+}
+
+void
+Ekiga::VideoKernels::scale (const ConstI420 & src,
+                            const I420 & dst)
+{
+  const Kernels & k = kernels ();
+  std::vector<unsigned char> line;
+  std::vector<unsigned> columns;
+  std::vector<unsigned> weights;
+
+  for (unsigned p = 0; p < 3; p++) {
+
+    const unsigned src_w = plane_width (src.width, p), src_h = plane_height (src.height, p);
+    const unsigned dst_w = plane_width (dst.width, p), dst_h = plane_height (dst.height, p);
+
+    if (src_w == 0 || src_h == 0 || dst_w == 0 || dst_h == 0)
+      continue;
+
+    /* the corners of src and dst match, positions are in 1/65536 */
+    columns.resize (dst_w);
+    weights.resize (dst_w);
+    for (unsigned col = 0; col < dst_w; col++) {
+
+      unsigned long long pos = (unsigned long long) col * ((src_w - 1) << 16) / std::max (dst_w - 1, 1u);
+      columns[col] = pos >> 16;
+      weights[col] = (pos >> 8) & 0xff;
+    }
+
+    line.resize (src_w);
+    for (unsigned row = 0; row < dst_h; row++) {
+
+      unsigned long long pos = (unsigned long long) row * ((src_h - 1) << 16) / std::max (dst_h - 1, 1u);
+      const unsigned top = pos >> 16;
+      const unsigned bottom = std::min (top + 1, src_h - 1);
+      unsigned char* out = dst.planes[p] + row * dst.strides[p];
+
+      k.lerp_row (src.planes[p] + top * src.strides[p],
+                  src.planes[p] + bottom * src.strides[p],
+                  &line[0], src_w, (pos >> 8) & 0xff);
+
+      for (unsigned col = 0; col < dst_w; col++) {
+
+        const unsigned left = columns[col];
+        const unsigned right = std::min (left + 1, src_w - 1);
+        out[col] = (line[left] * (256 - weights[col]) + line[right] * weights[col] + 128) >> 8;
+      }
+    }
+  }
+}
+
+void
+Ekiga::VideoKernels::to_rgba (const ConstI420 & src,
+                              unsigned char* dst,
+                              unsigned stride)
+{
+  const Kernels & k = kernels ();
+
+  if (src.width < 2 || src.height < 2)
+    return;
+
+  /* an odd last pixel has no chroma of its own */
+  const unsigned even_width = src.width & ~1u;
+
+  for (unsigned row = 0; row < src.height; row++) {
+
+    const unsigned char* y = src.planes[0] + row * src.strides[0];
+    const unsigned char* u = src.planes[1] + std::min (row / 2, src.height / 2 - 1) * src.strides[1];
+    const unsigned char* v = src.planes[2] + std::min (row / 2, src.height / 2 - 1) * src.strides[2];
+    unsigned char* out = dst + row * stride;
+
+    k.rgba_row (y, u, v, out, even_width);
+    if (even_width != src.width)
+      rgba_pixel (y[even_width], u[even_width / 2 - 1], v[even_width / 2 - 1], out + 4 * even_width);
+  }
+}
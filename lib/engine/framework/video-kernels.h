@@ -0,0 +1,150 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         video-kernels.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the I420 picture operations shared
+ *                          by the capture and display code.
+ *
+ */
+
+#ifndef __VIDEO_KERNELS_H__
+#define __VIDEO_KERNELS_H__
+
+/* Small operations on I420 (YUV420P) pictures, which is what the whole
+ * video pipeline uses: filling, blitting and blending one picture into
+ * another (for picture-in-picture), mirroring, scaling down, and
+ * converting to RGBA.
+ *
+ * Each operation has a plain C++ version, which is the reference, and
+ * SSE2 and AVX2 versions where they pay off ; the fastest the processor
+ * supports is picked at run time, and all give exactly the same result.
+ */
+
+namespace Ekiga
+{
+
+  /**
+   * @addtogroup services
+   * @{
+   */
+
+  namespace VideoKernels
+  {
+    /* A read-only picture ; the usual ekiga frame is a packed one, with
+     * the planes one after the other and no padding */
+    struct ConstI420
+    {
+      ConstI420 (const char* frame,
+                 unsigned width_,
+                 unsigned height_);
+
+      const unsigned char* planes[3];
+      unsigned strides[3];
+      unsigned width;
+      unsigned height;
+    };
+
+    /* A picture which can be written to */
+    struct I420
+    {
+      I420 (char* frame,
+            unsigned width_,
+            unsigned height_);
+
+      operator ConstI420 () const;
+
+      unsigned char* planes[3];
+      unsigned strides[3];
+      unsigned width;
+      unsigned height;
+    };
+
+    enum Level {
+
+      Scalar,
+      SSE2,
+      AVX2
+    };
+
+    /* The best level the processor supports */
+    Level get_best_level ();
+
+    /* The level in use ; it can be lowered, to compare or to debug */
+    Level get_level ();
+    void set_level (Level level);
+
+    /* Fill the picture with a single colour */
+    void fill (const I420 & dst,
+               unsigned char y,
+               unsigned char u,
+               unsigned char v);
+
+    /* Copy src into dst, with its top left corner at (x, y) (rounded
+     * down to even coordinates) ; what falls outside dst is cut */
+    void blit (const ConstI420 & src,
+               const I420 & dst,
+               int x,
+               int y);
+
+    /* Same as blit, but mixing src over dst: alpha goes from 0 (only dst)
+     * to 256 (only src) */
+    void blend (const ConstI420 & src,
+                const I420 & dst,
+                int x,
+                int y,
+                unsigned alpha);
+
+    /* Mirror src left to right into dst, which must have the same size
+     * and be another picture */
+    void mirror (const ConstI420 & src,
+                 const I420 & dst);
+
+    /* Average each 2x2 block of src into a pixel of dst: dst must be half
+     * the size of src (rounded down) */
+    void halve (const ConstI420 & src,
+                const I420 & dst);
+
+    /* Scale src to the size of dst, interpolating bilinearly ; for large
+     * reductions, halve first or the result will alias */
+    void scale (const ConstI420 & src,
+                const I420 & dst);
+
+    /* Convert src to RGBA (BT.601 limited range, alpha 255) ; each line of
+     * dst is 4 * src.width bytes, lines are stride bytes apart */
+    void to_rgba (const ConstI420 & src,
+                  unsigned char* dst,
+                  unsigned stride);
+  };
+
+  /**
+   * @}
+   */
+};
+
+#endif
@@ -40,6 +40,7 @@
 #include "book-view-gtk.h"
 
 #include "gm-info-bar.h"
+#include "gm-pixbuf-cache.h"
 
 #include "filterable.h"
 
@@ -426,9 +427,8 @@ book_view_gtk_update_contact (BookViewGtk *self,
   GdkPixbuf *pixbuf = NULL;
 
   store = GTK_LIST_STORE (gtk_tree_view_get_model (self->priv->tree_view));
-  pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                     "avatar-default",
-                                     GTK_ICON_SIZE_MENU, (GtkIconLookupFlags) 0, NULL);
+  pixbuf = gm_pixbuf_cache_load_icon ("avatar-default",
+                                      GTK_ICON_SIZE_MENU, (GtkIconLookupFlags) 0);
   gtk_list_store_set (store, iter,
                       COLUMN_PIXBUF, pixbuf,
 		      COLUMN_NAME, contact->get_name ().c_str (),
@@ -325,6 +325,12 @@ static const char* win_menu =
   "    </section>"
   "    <section>"
   "      <item>"
+  "        <attribute name='label' translatable='yes'>_Conference</attribute>"
+  "        <attribute name='action'>win.conference</attribute>"
+  "      </item>"
+  "    </section>"
+  "    <section>"
+  "      <item>"
   "        <attribute name='label' translatable='yes'>_Picture-In-Picture Mode</attribute>"
   "        <attribute name='action'>win.enable-pip</attribute>"
   "      </item>"
@@ -415,7 +421,7 @@ on_videooutput_device_opened_cb (Ekiga::VideoOutputManager & /* manager */,
                                  Ekiga::VideoOutputManager::VideoView type,
                                  unsigned width,
                                  unsigned height,
-                                 G_GNUC_UNUSED bool both_streams,
+                                 bool both_streams,
                                  G_GNUC_UNUSED bool ext_stream,
                                  gpointer data)
 {
@@ -448,6 +454,17 @@ on_videooutput_device_opened_cb (Ekiga::VideoOutputManager & /* manager */,
       (type == Ekiga::VideoOutputManager::REMOTE) ? PRIMARY_STREAM : SECONDARY_STREAM;
 
     gtk_widget_show (GTK_WIDGET (self));
+
+    /* The local video is drawn into the remote one by the video output */
+    if (both_streams
+        && self->priv->video_display_settings->get_bool ("composite-pip")) {
+
+      gm_video_widget_set_stream_state (GM_VIDEO_WIDGET (self->priv->video_widget),
+                                        SECONDARY_STREAM, STREAM_STATE_STOPPED);
+      if (t == SECONDARY_STREAM)
+        return;
+    }
+
     gm_video_widget_set_stream_natural_size (GM_VIDEO_WIDGET (self->priv->video_widget),
                                              t, width, height);
     gm_video_widget_set_stream_state (GM_VIDEO_WIDGET (self->priv->video_widget),
@@ -63,6 +63,7 @@
 #include "call-core.h"
 #include "engine.h"
 #include "runtime.h"
+#include "trace-ring.h"
 #include "platform/platform.h"
 #include "gactor-menu.h"
 
@@ -379,6 +380,7 @@ ekiga_main (int argc,
   }
 
   Ekiga::Runtime::init ();
+  Ekiga::TraceRing::init (g_getenv ("EKIGA_TRACE_FILE"));
   engine_init (app->priv->core, argc, argv);
 
   // Connect signals
@@ -67,6 +67,9 @@
 
 enum CallingState {Standby, Calling, Connected, Called};
 
+/* how many contact uris we propose when completing the uri entry */
+#define MAX_CONTACT_COMPLETIONS 10
+
 G_DEFINE_TYPE (EkigaWindow, ekiga_window, GM_TYPE_WINDOW);
 
 
@@ -141,6 +144,10 @@ static bool account_completion_helper_cb (Ekiga::AccountPtr acc,
                                           const gchar* text,
                                           EkigaWindow* mw);
 
+static bool contact_completion_helper_cb (Ekiga::ContactPtr contact,
+                                          unsigned int* count,
+                                          EkigaWindow* mw);
+
 static void place_call_cb (GtkWidget * /*widget*/,
                            gpointer data);
 
@@ -224,6 +231,27 @@ account_completion_helper_cb (Ekiga::AccountPtr acc,
   return true;
 }
 
+static bool
+contact_completion_helper_cb (Ekiga::ContactPtr contact,
+                              unsigned int* count,
+                              EkigaWindow* mw)
+{
+  // propose autocompletion for the uris of matching contacts in all books
+  const std::set<std::string> uris = contact->get_uris ();
+
+  for (std::set<std::string>::const_iterator it = uris.begin ();
+       it != uris.end () && *count < MAX_CONTACT_COMPLETIONS;
+       ++it) {
+
+    GtkTreeIter iter;
+    gtk_list_store_append (mw->priv->completion, &iter);
+    gtk_list_store_set (mw->priv->completion, &iter, 0, it->c_str (), -1);
+    (*count)++;
+  }
+
+  return *count < MAX_CONTACT_COMPLETIONS;
+}
+
 static void
 place_call_cb (GtkWidget * /*widget*/,
                gpointer data)
@@ -268,12 +296,18 @@ url_changed_cb (GtkEditable *e,
 
   tip_text = gtk_entry_get_text (GTK_ENTRY (e));
 
+  gtk_list_store_clear (mw->priv->completion);
+
   if (g_strrstr (tip_text, "@") == NULL) {
     boost::shared_ptr<Opal::Bank> b = mw->priv->bank.lock ();
-    if (b) {
-      gtk_list_store_clear (mw->priv->completion);
+    if (b)
       b->visit_accounts (boost::bind (&account_completion_helper_cb, _1, tip_text, mw));
-    }
+  }
+
+  {
+    unsigned int count = 0;
+    mw->priv->contact_core->visit_matching_contacts (tip_text,
+                                                     boost::bind (&contact_completion_helper_cb, _1, &count, mw));
   }
 
   gtk_widget_set_tooltip_text (GTK_WIDGET (e), tip_text);
@@ -557,6 +557,10 @@ gm_pw_init_general_page (PreferencesWindow *self,
                     self->priv->video_display_settings, "enable-pip",
                     _("This allows the local video stream to be displayed incrusted in the remote video stream. This is only effective when sending and receiving video"), false);
 
+  gm_pw_toggle_new (container, _("_Draw the local video into the remote video"),
+                    self->priv->video_display_settings, "composite-pip",
+                    _("During calls, draw a small copy of the local video into the remote video before displaying it: this is lighter when the display is rendered in software"), false);
+
   /* Network Settings */
   gm_pw_subsection_new (container, _("Network Settings"));
   gm_pw_spin_new (container, _("Type of Service (TOS)"), NULL,
@@ -1413,6 +1417,9 @@ refresh_devices_list_cb (G_GNUC_UNUSED GtkWidget *widget,
   g_return_if_fail (data != NULL);
   PreferencesWindow *self = PREFERENCES_WINDOW (data);
 
+  /* The user asked for it: probe the devices again */
+  self->priv->audiooutput_core->refresh_devices ();
+  self->priv->audioinput_core->refresh_devices ();
   gm_prefs_window_update_devices_list (self);
 }
 
@@ -48,6 +48,7 @@
 
 #include "gm-cell-renderer-bitext.h"
 #include "gm-cell-renderer-expander.h"
+#include "gm-pixbuf-cache.h"
 #include "roster-view-gtk.h"
 #include "form-dialog-gtk.h"
 #include "scoped-connections.h"
@@ -1409,11 +1410,9 @@ roster_view_gtk_update_presentity (RosterViewGtk* self,
                                (presence != "available" && presence != "unknown")?GTK_STATE_FLAG_INSENSITIVE:GTK_STATE_FLAG_NORMAL,
                                &color);
 
-  pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                     "avatar-default-symbolic",
-                                     48,
-                                     GTK_ICON_LOOKUP_GENERIC_FALLBACK,
-                                     NULL);
+  pixbuf = gm_pixbuf_cache_load_icon ("avatar-default-symbolic",
+                                      48,
+                                      GTK_ICON_LOOKUP_GENERIC_FALLBACK);
 
   gtk_tree_store_set (self->priv->store, &iter,
                       COLUMN_TYPE, TYPE_PRESENTITY,
@@ -1507,11 +1506,9 @@ roster_view_gtk_update_account (RosterViewGtk *self,
   }
 
   if (icon_name) {
-    pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                       icon_name,
-                                       16,
-                                       GTK_ICON_LOOKUP_GENERIC_FALLBACK,
-                                       NULL);
+    pixbuf = gm_pixbuf_cache_load_icon (icon_name,
+                                        16,
+                                        GTK_ICON_LOOKUP_GENERIC_FALLBACK);
     gtk_tree_store_set (self->priv->store, &heap_iter,
                         COLUMN_ACCOUNT_STATUS_ICON, pixbuf,
                         COLUMN_ACCOUNT_STATUS_ICON_VISIBLE, TRUE,
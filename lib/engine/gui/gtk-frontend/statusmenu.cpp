@@ -39,6 +39,7 @@
 #include <glib/gi18n.h>
 
 #include "ekiga-settings.h"
+#include "gm-pixbuf-cache.h"
 
 #include "personal-details.h"
 
@@ -370,9 +371,8 @@ status_menu_populate (StatusMenu *self,
     statuses [i] = gettext (statuses [i]);
     custom_status = custom_status_array [i];
     liter = custom_status;
-    pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                       status_icon_name[i],
-                                       GTK_ICON_SIZE_MENU, (GtkIconLookupFlags) 0, NULL);
+    pixbuf = gm_pixbuf_cache_load_icon (status_icon_name[i],
+                                        GTK_ICON_SIZE_MENU, (GtkIconLookupFlags) 0);
 
     gtk_list_store_append (GTK_LIST_STORE (self->priv->list_store), &iter);
     gtk_list_store_set (GTK_LIST_STORE (self->priv->list_store), &iter,
@@ -418,9 +418,8 @@ status_menu_populate (StatusMenu *self,
   /* Clear message */
   if (has_custom_messages) {
 
-    pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                       "gtk-clear",
-                                       GTK_ICON_SIZE_MENU, (GtkIconLookupFlags) 0, NULL);
+    pixbuf = gm_pixbuf_cache_load_icon ("gtk-clear",
+                                        GTK_ICON_SIZE_MENU, (GtkIconLookupFlags) 0);
 
     gtk_list_store_append (GTK_LIST_STORE (self->priv->list_store), &iter);
     gtk_list_store_set (GTK_LIST_STORE (self->priv->list_store), &iter,
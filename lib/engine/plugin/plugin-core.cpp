@@ -36,7 +36,14 @@
 
 #include "plugin-core.h"
 
+#include <map>
+#include <list>
+#include <vector>
+#include <string.h>
+
 #include <gmodule.h>
+#include <gio/gio.h>
+#include <glib/gstdio.h>
 
 #if DEBUG
 #include <iostream>
@@ -56,20 +63,396 @@
 // which can be compiled with :
 // gcc -o hello.so hello.cpp -shared -export-dynamic -I$(PATH_TO_EKIGA_SOURCES)/lib/engine/framework -lboost_signals-mt
 //
+// A plugin can also describe itself, so it doesn't have to be loaded at
+// startup :
+//
+// extern "C" const char* const ekiga_plugin_provides[] = { "hello-core", NULL };
+// extern "C" const char* const ekiga_plugin_requires[] = { "contact-core", NULL };
+// extern "C" const int ekiga_plugin_lazy = 1;
+//
+// then it is only loaded when something asks the service core for one of
+// the services it provides, after what it requires. A lazy plugin which
+// provides nothing is loaded once the main loop is idle, after the first
+// window is shown, unless one of its settings says it is needed right away:
+//
+// extern "C" const char* const ekiga_plugin_startup_settings[] = {
+//   CONTACTS_SCHEMA, "hello-books", "<book", NULL };
+//
+// is a list of (schema, string key, text) triples, and the plugin is
+// loaded at startup if one of those keys contains its text. An eager
+// plugin which requires a lazy one is loaded when idle too, so that it
+// doesn't pull it in at startup.
+//
+// Those descriptions are kept in a manifest in the user cache directory, so
+// the plugins are only opened again when the plugin directories change.
+//
 // additionally, if you want to debug a plugin you're writing, then you should
 // set DEBUG to 1 at the start of that file, and put your plugin (and its
 // dependancies) in the ekiga_debug_plugins/ directory in your temporary
 // directory ("/tmp" on unix-like systems) : that way ekiga will only load that
 // and be verbose about it.
 
+#define MANIFEST_VERSION 3
+#define DIRECTORY_GROUP "directory "
+#define PLUGIN_GROUP "plugin "
+
+namespace
+{
+  struct PluginInfo
+  {
+    PluginInfo (): valid(false), lazy(false), loaded(false)
+    {}
+
+    std::string stamp;
+    bool valid;
+    bool lazy;
+    bool loaded;
+    std::list<std::string> provides;
+    std::list<std::string> requires;
+    std::list<std::string> startup_settings;
+  };
+
+  class PluginLoader: public Ekiga::Service
+  {
+  public:
+
+    PluginLoader (Ekiga::ServiceCore& core_);
+
+    ~PluginLoader ();
+
+    const std::string get_name () const
+    { return "plugin-loader"; }
+
+    const std::string get_description () const
+    { return "\tObject loading the plugins"; }
+
+    /* reads the manifest, or rebuilds it if the directories changed */
+    void scan (const gchar* path);
+
+    /* loads the plugins needed at startup, and schedules the load of
+     * those which can wait for the main loop to be idle
+     */
+    void load_eager (Ekiga::KickStart& kickstart);
+
+    /* the service core fallback */
+    void on_missing_service (const std::string & name);
+
+  private:
+
+    static gboolean on_idle (gpointer data);
+
+    void load (const std::string & filename,
+               Ekiga::KickStart& kickstart);
+
+    bool is_needed_at_startup (const PluginInfo& info) const;
+
+    bool requires_lazy (const PluginInfo& info) const;
+
+    bool manifest_is_fresh (GKeyFile* manifest,
+                            const gchar* path) const;
+
+    void read_manifest (GKeyFile* manifest);
+
+    void parse_directory (GKeyFile* old_manifest,
+                          GKeyFile* new_manifest,
+                          const gchar* path);
+
+    void parse_file (GKeyFile* old_manifest,
+                     GKeyFile* new_manifest,
+                     const gchar* filename);
+
+    Ekiga::ServiceCore& core;
+    Ekiga::KickStart lazy_kickstart;
+    std::map<std::string, PluginInfo> plugins; // by file name
+    std::map<std::string, std::string> providers; // service -> file name
+    std::list<std::string> deferred; // loaded when idle
+    guint idle_id;
+    gchar* manifest_file;
+  };
+};
+
+static gint64
+get_mtime (const gchar* path)
+{
+  GStatBuf buf;
+
+  if (g_stat (path, &buf) != 0)
+    return -1;
+
+  return buf.st_mtime;
+}
+
+/* what tells a plugin file changed, even when it was overwritten in place
+ * (which leaves the mtime of its directory alone)
+ */
+static std::string
+get_stamp (const gchar* path)
+{
+  GStatBuf buf;
+  gchar* stamp = NULL;
+  std::string result;
+
+  if (g_stat (path, &buf) != 0)
+    return result;
+
+  stamp = g_strdup_printf ("%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT ":%" G_GUINT64_FORMAT,
+                           (gint64) buf.st_mtime, (gint64) buf.st_size, (guint64) buf.st_ino);
+  result = stamp;
+  g_free (stamp);
+
+  return result;
+}
+
+static std::list<std::string>
+string_list (const char* const* strings)
+{
+  std::list<std::string> result;
+
+  for (int ii = 0; strings != NULL && strings[ii] != NULL; ii++)
+    result.push_back (strings[ii]);
+
+  return result;
+}
+
+static std::list<std::string>
+get_string_list (GKeyFile* key_file,
+                 const gchar* group,
+                 const gchar* key)
+{
+  gchar** strings = g_key_file_get_string_list (key_file, group, key, NULL, NULL);
+  std::list<std::string> result = string_list (strings);
+
+  g_strfreev (strings);
+
+  return result;
+}
+
 static void
-plugin_parse_file (Ekiga::KickStart& kickstart,
-                   const gchar* filename)
+set_string_list (GKeyFile* key_file,
+                 const gchar* group,
+                 const gchar* key,
+                 const std::list<std::string> & strings)
+{
+  std::vector<const gchar*> array;
+
+  for (std::list<std::string>::const_iterator iter = strings.begin ();
+       iter != strings.end ();
+       ++iter)
+    array.push_back (iter->c_str ());
+
+  if (array.empty ())
+    g_key_file_set_string (key_file, group, key, "");
+  else
+    g_key_file_set_string_list (key_file, group, key, &array[0], array.size ());
+}
+
+/* Whether the string key of the schema contains the text ; a schema or a
+ * key which isn't installed doesn't contain anything
+ */
+static bool
+setting_contains (const std::string & schema_id,
+                  const std::string & key,
+                  const std::string & text)
+{
+  bool result = false;
+  GSettingsSchemaSource* source = g_settings_schema_source_get_default ();
+  GSettingsSchema* schema = NULL;
+
+  if (source != NULL)
+    schema = g_settings_schema_source_lookup (source, schema_id.c_str (), TRUE);
+
+  if (schema != NULL && g_settings_schema_has_key (schema, key.c_str ())) {
+
+    GSettings* settings = g_settings_new_full (schema, NULL, NULL);
+    GVariant* value = g_settings_get_value (settings, key.c_str ());
+
+    if (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING))
+      result = (strstr (g_variant_get_string (value, NULL), text.c_str ()) != NULL);
+
+    g_variant_unref (value);
+    g_object_unref (settings);
+  }
+
+  if (schema != NULL)
+    g_settings_schema_unref (schema);
+
+  return result;
+}
+
+PluginLoader::PluginLoader (Ekiga::ServiceCore& core_):
+  core(core_), idle_id(0)
+{
+  manifest_file = g_build_filename (g_get_user_cache_dir (), "ekiga",
+                                    "plugins.manifest", NULL);
+}
+
+PluginLoader::~PluginLoader ()
+{
+  if (idle_id != 0)
+    g_source_remove (idle_id);
+  g_free (manifest_file);
+}
+
+void
+PluginLoader::scan (const gchar* path)
 {
+  g_return_if_fail (path != NULL);
+
+  GKeyFile* manifest = g_key_file_new ();
+  g_key_file_load_from_file (manifest, manifest_file, G_KEY_FILE_NONE, NULL);
+
+  if (manifest_is_fresh (manifest, path)) {
+
+#if DEBUG
+    std::cout << "Using the plugin manifest " << manifest_file << std::endl;
+#endif
+    read_manifest (manifest);
+  } else {
+
+    GKeyFile* new_manifest = g_key_file_new ();
+    gchar* dirname = g_path_get_dirname (manifest_file);
+    gchar* data = NULL;
+    gsize length = 0;
+
+    g_key_file_set_integer (new_manifest, "manifest", "version", MANIFEST_VERSION);
+    g_key_file_set_string (new_manifest, "manifest", "root", path);
+    parse_directory (manifest, new_manifest, path);
+
+    data = g_key_file_to_data (new_manifest, &length, NULL);
+    g_mkdir_with_parents (dirname, 0700);
+    g_file_set_contents (manifest_file, data, length, NULL);
+
+    g_free (data);
+    g_free (dirname);
+    g_key_file_free (new_manifest);
+  }
+
+  g_key_file_free (manifest);
+}
+
+void
+PluginLoader::load_eager (Ekiga::KickStart& kickstart)
+{
+  for (std::map<std::string, PluginInfo>::iterator iter = plugins.begin ();
+       iter != plugins.end ();
+       ++iter) {
+
+    const PluginInfo& info = iter->second;
+
+    if ( !info.valid || (info.lazy && !info.provides.empty ()))
+      continue;
+
+    if (is_needed_at_startup (info))
+      load (iter->first, kickstart);
+    else
+      deferred.push_back (iter->first);
+  }
+
+  if ( !deferred.empty ())
+    idle_id = g_idle_add_full (G_PRIORITY_LOW, on_idle, this, NULL);
+}
+
+gboolean
+PluginLoader::on_idle (gpointer data)
+{
+  PluginLoader* self = (PluginLoader*) data;
+  int argc = 0;
+  char** argv = NULL;
+
+  self->idle_id = 0;
+
+  for (std::list<std::string>::const_iterator iter = self->deferred.begin ();
+       iter != self->deferred.end ();
+       ++iter)
+    self->load (*iter, self->lazy_kickstart);
+  self->deferred.clear ();
+
+  self->lazy_kickstart.kick (self->core, &argc, &argv);
+
+  return FALSE;
+}
+
+/* An eager plugin is needed at startup unless it requires a lazy one, and
+ * a lazy plugin (which provides nothing) when its settings say so
+ */
+bool
+PluginLoader::is_needed_at_startup (const PluginInfo& info) const
+{
+  if ( !info.lazy)
+    return !requires_lazy (info);
+
+  std::list<std::string>::const_iterator iter = info.startup_settings.begin ();
+
+  while (iter != info.startup_settings.end ()) {
+
+    std::string schema = *iter++;
+    if (iter == info.startup_settings.end ())
+      break;
+    std::string key = *iter++;
+    if (iter == info.startup_settings.end ())
+      break;
+    std::string text = *iter++;
+
+    if (setting_contains (schema, key, text))
+      return true;
+  }
+
+  return false;
+}
+
+bool
+PluginLoader::requires_lazy (const PluginInfo& info) const
+{
+  for (std::list<std::string>::const_iterator iter = info.requires.begin ();
+       iter != info.requires.end ();
+       ++iter)
+    if (providers.find (*iter) != providers.end ())
+      return true;
+
+  return false;
+}
+
+void
+PluginLoader::on_missing_service (const std::string & name)
+{
+  std::map<std::string, std::string>::const_iterator iter = providers.find (name);
+
+  if (iter == providers.end () || plugins[iter->second].loaded)
+    return;
+
+  int argc = 0;
+  char** argv = NULL;
+
+  load (iter->second, lazy_kickstart);
+  lazy_kickstart.kick (core, &argc, &argv);
+}
+
+void
+PluginLoader::load (const std::string & filename,
+                    Ekiga::KickStart& kickstart)
+{
+  PluginInfo& info = plugins[filename];
+
+  if (info.loaded)
+    return;
+  info.loaded = true;
+
+  /* the service core fallback isn't reentrant, so the lazy plugins this
+   * one requires are loaded first by hand
+   */
+  for (std::list<std::string>::const_iterator iter = info.requires.begin ();
+       iter != info.requires.end ();
+       ++iter) {
+
+    std::map<std::string, std::string>::const_iterator provider = providers.find (*iter);
+    if (provider != providers.end ())
+      load (provider->second, kickstart);
+  }
+
 #if DEBUG
   std::cout << "Trying to load " << filename << "... ";
 #endif
-  GModule* plugin = g_module_open (filename, G_MODULE_BIND_LOCAL);
+  GModule* plugin = g_module_open (filename.c_str (), G_MODULE_BIND_LOCAL);
 
   if (plugin != 0) {
 
@@ -100,12 +483,79 @@ plugin_parse_file (Ekiga::KickStart& kickstart,
   }
 }
 
-static void
-plugin_parse_directory (Ekiga::KickStart& kickstart,
-                        const gchar* path)
+/* The manifest is fresh if it was made for the same root, and none of the
+ * directories it saw has changed : adding, removing or replacing a plugin
+ * (installers replace by renaming) changes the mtime of its directory.
+ * A plugin overwritten in place doesn't, so each plugin file is checked
+ * too ; a stat is cheap next to opening it.
+ */
+bool
+PluginLoader::manifest_is_fresh (GKeyFile* manifest,
+                                 const gchar* path) const
 {
-  g_return_if_fail (path != NULL);
+  bool result = false;
+  gsize length = 0;
+  gchar** groups = NULL;
+  gchar* root = g_key_file_get_string (manifest, "manifest", "root", NULL);
+
+  if (g_key_file_get_integer (manifest, "manifest", "version", NULL) == MANIFEST_VERSION
+      && root != NULL && g_strcmp0 (root, path) == 0) {
 
+    result = true;
+    groups = g_key_file_get_groups (manifest, &length);
+    for (gsize ii = 0; ii < length && result; ii++)
+      if (g_str_has_prefix (groups[ii], DIRECTORY_GROUP))
+        result = (get_mtime (groups[ii] + strlen (DIRECTORY_GROUP))
+                  == g_key_file_get_int64 (manifest, groups[ii], "mtime", NULL));
+      else if (g_str_has_prefix (groups[ii], PLUGIN_GROUP)) {
+
+        gchar* stamp = g_key_file_get_string (manifest, groups[ii], "stamp", NULL);
+        result = (stamp != NULL && get_stamp (groups[ii] + strlen (PLUGIN_GROUP)) == stamp);
+        g_free (stamp);
+      }
+    g_strfreev (groups);
+  }
+
+  g_free (root);
+
+  return result;
+}
+
+void
+PluginLoader::read_manifest (GKeyFile* manifest)
+{
+  gsize length = 0;
+  gchar** groups = g_key_file_get_groups (manifest, &length);
+
+  for (gsize ii = 0; ii < length; ii++) {
+
+    if ( !g_str_has_prefix (groups[ii], PLUGIN_GROUP))
+      continue;
+
+    std::string filename = groups[ii] + strlen (PLUGIN_GROUP);
+    PluginInfo& info = plugins[filename];
+
+    info.valid = g_key_file_get_boolean (manifest, groups[ii], "valid", NULL);
+    info.lazy = g_key_file_get_boolean (manifest, groups[ii], "lazy", NULL);
+    info.provides = get_string_list (manifest, groups[ii], "provides");
+    info.requires = get_string_list (manifest, groups[ii], "requires");
+    info.startup_settings = get_string_list (manifest, groups[ii], "startup-settings");
+
+    if (info.valid && info.lazy)
+      for (std::list<std::string>::const_iterator iter = info.provides.begin ();
+           iter != info.provides.end ();
+           ++iter)
+        providers[*iter] = filename;
+  }
+
+  g_strfreev (groups);
+}
+
+void
+PluginLoader::parse_directory (GKeyFile* old_manifest,
+                               GKeyFile* new_manifest,
+                               const gchar* path)
+{
   GError* error = NULL;
   GDir* directory = g_dir_open (path, 0, &error);
 
@@ -118,6 +568,10 @@ plugin_parse_directory (Ekiga::KickStart& kickstart,
 #if DEBUG
     std::cout << "open succeeded" << std::endl;
 #endif
+    gchar* group = g_strconcat (DIRECTORY_GROUP, path, NULL);
+    g_key_file_set_int64 (new_manifest, group, "mtime", get_mtime (path));
+    g_free (group);
+
     const gchar* name = g_dir_read_name (directory);
 
     while (name) {
@@ -131,9 +585,9 @@ plugin_parse_directory (Ekiga::KickStart& kickstart,
        */
 
       if (g_str_has_suffix (filename, G_MODULE_SUFFIX))
-        plugin_parse_file (kickstart, filename);
+        parse_file (old_manifest, new_manifest, filename);
       else
-        plugin_parse_directory (kickstart, filename);
+        parse_directory (old_manifest, new_manifest, filename);
 
       g_free (filename);
       name = g_dir_read_name (directory);
@@ -149,17 +603,88 @@ plugin_parse_directory (Ekiga::KickStart& kickstart,
   }
 }
 
+/* Describes a plugin, from the old manifest if it didn't change since, or
+ * by opening it (but not initializing it) otherwise.
+ */
 void
-plugin_init (Ekiga::KickStart& kickstart)
+PluginLoader::parse_file (GKeyFile* old_manifest,
+                          GKeyFile* new_manifest,
+                          const gchar* filename)
 {
+  PluginInfo& info = plugins[filename];
+  gchar* group = g_strconcat (PLUGIN_GROUP, filename, NULL);
+
+  gchar* old_stamp = g_key_file_get_string (old_manifest, group, "stamp", NULL);
+
+  info.stamp = get_stamp (filename);
+
+  if (old_stamp != NULL && info.stamp == old_stamp) {
+
+    info.valid = g_key_file_get_boolean (old_manifest, group, "valid", NULL);
+    info.lazy = g_key_file_get_boolean (old_manifest, group, "lazy", NULL);
+    info.provides = get_string_list (old_manifest, group, "provides");
+    info.requires = get_string_list (old_manifest, group, "requires");
+    info.startup_settings = get_string_list (old_manifest, group, "startup-settings");
+  } else {
+
+    GModule* plugin = g_module_open (filename, G_MODULE_BIND_LOCAL);
+
+    if (plugin != 0) {
+
+      gpointer symbol = NULL;
+
+      info.valid = g_module_symbol (plugin, "ekiga_plugin_init", &symbol);
+      if (g_module_symbol (plugin, "ekiga_plugin_lazy", &symbol))
+        info.lazy = *(const int*) symbol;
+      if (g_module_symbol (plugin, "ekiga_plugin_provides", &symbol))
+        info.provides = string_list ((const char* const*) symbol);
+      if (g_module_symbol (plugin, "ekiga_plugin_requires", &symbol))
+        info.requires = string_list ((const char* const*) symbol);
+      if (g_module_symbol (plugin, "ekiga_plugin_startup_settings", &symbol))
+        info.startup_settings = string_list ((const char* const*) symbol);
+      g_module_close (plugin);
+    }
+#if DEBUG
+    else
+      std::cout << "failed to describe " << filename << ": " << g_module_error () << std::endl;
+#endif
+  }
+
+  g_key_file_set_string (new_manifest, group, "stamp", info.stamp.c_str ());
+  g_key_file_set_boolean (new_manifest, group, "valid", info.valid);
+  g_key_file_set_boolean (new_manifest, group, "lazy", info.lazy);
+  set_string_list (new_manifest, group, "provides", info.provides);
+  set_string_list (new_manifest, group, "requires", info.requires);
+  set_string_list (new_manifest, group, "startup-settings", info.startup_settings);
+
+  if (info.valid && info.lazy)
+    for (std::list<std::string>::const_iterator iter = info.provides.begin ();
+         iter != info.provides.end ();
+         ++iter)
+      providers[*iter] = filename;
+
+  g_free (old_stamp);
+  g_free (group);
+}
+
+void
+plugin_init (Ekiga::ServiceCore& core,
+             Ekiga::KickStart& kickstart)
+{
+  boost::shared_ptr<PluginLoader> loader (new PluginLoader (core));
+
 #if DEBUG
   // should make it easier to test ekiga without installing
   gchar* path = g_build_path (G_DIR_SEPARATOR_S,
                               g_get_tmp_dir (), "ekiga_debug_plugins", NULL);
-  plugin_parse_directory (kickstart, path);
+  loader->scan (path);
   g_free (path);
 #else
-  plugin_parse_directory (kickstart,
-                          EKIGA_PLUGIN_DIR);
+  loader->scan (EKIGA_PLUGIN_DIR);
 #endif
+
+  loader->load_eager (kickstart);
+
+  core.add (loader);
+  core.set_fallback (boost::bind (&PluginLoader::on_missing_service, loader.get (), _1));
 }
@@ -39,6 +39,11 @@
 
 #include "kickstart.h"
 
-void plugin_init (Ekiga::KickStart& kickstart);
+/* The plugins needed at startup add their sparks to the given kickstart;
+ * lazy providers are loaded when the service core is asked for a service
+ * they provide, and the other plugins once the main loop is idle.
+ */
+void plugin_init (Ekiga::ServiceCore& core,
+                  Ekiga::KickStart& kickstart);
 
 #endif
@@ -202,6 +202,9 @@ namespace Ekiga
       DynamicObjectStore<Ekiga::CallManager> managers;
     };
 
+    /* the key to get it from the ServiceCore */
+    const ServiceKey<CallCore> call_core_key ("call-core");
+
 /**
  * @}
  */
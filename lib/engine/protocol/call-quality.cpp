@@ -0,0 +1,249 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         call-quality.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the per-call media quality recorder.
+ *
+ */
+
+#include <algorithm>
+#include <fstream>
+
+#include "call-quality.h"
+
+static unsigned
+clamp_to (unsigned value,
+	  unsigned max)
+{
+  return std::min (value, max);
+}
+
+Ekiga::CallQualitySummary::CallQualitySummary ():
+  samples(0), loss_bursts(0), longest_loss_burst(0), lossy_samples(0),
+  received_fps_mean(0), received_fps_variance(0),
+  transmitted_fps_mean(0), transmitted_fps_variance(0),
+  transmitted_audio_bandwidth(0), received_audio_bandwidth(0),
+  transmitted_video_bandwidth(0), received_video_bandwidth(0)
+{
+}
+
+Ekiga::CallQualityRecorder::CallQualityRecorder (unsigned capacity):
+  ring(std::max (capacity, 1u)),
+  jitter_histogram(JITTER_BUCKETS), remote_jitter_histogram(JITTER_BUCKETS)
+{
+  clear ();
+}
+
+void
+Ekiga::CallQualityRecorder::clear ()
+{
+  ring_head = 0;
+  ring_count = 0;
+  samples = 0;
+
+  std::fill (jitter_histogram.begin (), jitter_histogram.end (), 0);
+  jitter_count = 0;
+  std::fill (remote_jitter_histogram.begin (), remote_jitter_histogram.end (), 0);
+  remote_jitter_count = 0;
+
+  loss_bursts = 0;
+  current_loss_burst = 0;
+  longest_loss_burst = 0;
+  lossy_samples = 0;
+
+  received_fps_mean = 0;
+  received_fps_m2 = 0;
+  transmitted_fps_mean = 0;
+  transmitted_fps_m2 = 0;
+
+  transmitted_audio_bandwidth = 0;
+  received_audio_bandwidth = 0;
+  transmitted_video_bandwidth = 0;
+  received_video_bandwidth = 0;
+}
+
+void
+Ekiga::CallQualityRecorder::record (unsigned offset,
+				    const RTCPStatistics & stats)
+{
+  Sample& sample = ring[ring_head];
+
+  sample.offset = offset;
+  sample.jitter = std::max (-1, std::min (stats.jitter, 0x7fff));
+  sample.remote_jitter = std::max (-1, std::min (stats.remote_jitter, 0x7fff));
+  sample.transmitted_audio_bandwidth = clamp_to (stats.transmitted_audio_bandwidth, 0xffff);
+  sample.received_audio_bandwidth = clamp_to (stats.received_audio_bandwidth, 0xffff);
+  sample.transmitted_video_bandwidth = clamp_to (stats.transmitted_video_bandwidth, 0xffff);
+  sample.received_video_bandwidth = clamp_to (stats.received_video_bandwidth, 0xffff);
+  sample.transmitted_fps = clamp_to (stats.transmitted_fps, 0xff);
+  sample.received_fps = clamp_to (stats.received_fps, 0xff);
+  sample.lost_packets = clamp_to (stats.lost_packets, 100);
+  sample.remote_lost_packets = clamp_to (stats.remote_lost_packets, 100);
+  sample.round_trip_time = std::max (-1, std::min (stats.round_trip_time, 0x7fff));
+
+  ring_head = (ring_head + 1) % ring.size ();
+  if (ring_count < ring.size ())
+    ring_count++;
+
+  samples++;
+
+  add_to_histogram (jitter_histogram, jitter_count, stats.jitter);
+  add_to_histogram (remote_jitter_histogram, remote_jitter_count, stats.remote_jitter);
+
+  if (stats.lost_packets > 0) {
+
+    lossy_samples++;
+    if (current_loss_burst == 0)
+      loss_bursts++;
+    current_loss_burst++;
+    longest_loss_burst = std::max (longest_loss_burst, current_loss_burst);
+  }
+  else
+    current_loss_burst = 0;
+
+  double delta = stats.received_fps - received_fps_mean;
+  received_fps_mean += delta / samples;
+  received_fps_m2 += delta * (stats.received_fps - received_fps_mean);
+
+  delta = stats.transmitted_fps - transmitted_fps_mean;
+  transmitted_fps_mean += delta / samples;
+  transmitted_fps_m2 += delta * (stats.transmitted_fps - transmitted_fps_mean);
+
+  transmitted_audio_bandwidth += stats.transmitted_audio_bandwidth;
+  received_audio_bandwidth += stats.received_audio_bandwidth;
+  transmitted_video_bandwidth += stats.transmitted_video_bandwidth;
+  received_video_bandwidth += stats.received_video_bandwidth;
+}
+
+Ekiga::CallQualitySummary
+Ekiga::CallQualityRecorder::get_summary () const
+{
+  CallQualitySummary result;
+
+  result.samples = samples;
+  if (samples == 0)
+    return result;
+
+  result.jitter = percentiles (jitter_histogram, jitter_count);
+  result.remote_jitter = percentiles (remote_jitter_histogram, remote_jitter_count);
+
+  result.loss_bursts = loss_bursts;
+  result.longest_loss_burst = longest_loss_burst;
+  result.lossy_samples = lossy_samples;
+
+  result.received_fps_mean = received_fps_mean;
+  result.received_fps_variance = received_fps_m2 / samples;
+  result.transmitted_fps_mean = transmitted_fps_mean;
+  result.transmitted_fps_variance = transmitted_fps_m2 / samples;
+
+  result.transmitted_audio_bandwidth = transmitted_audio_bandwidth / samples;
+  result.received_audio_bandwidth = received_audio_bandwidth / samples;
+  result.transmitted_video_bandwidth = transmitted_video_bandwidth / samples;
+  result.received_video_bandwidth = received_video_bandwidth / samples;
+
+  return result;
+}
+
+bool
+Ekiga::CallQualityRecorder::export_to (const std::string & filename) const
+{
+  std::ofstream out (filename.c_str ());
+
+  if (!out)
+    return false;
+
+  out << "offset,jitter,remote_jitter,"
+      << "transmitted_audio_bandwidth,received_audio_bandwidth,"
+      << "transmitted_video_bandwidth,received_video_bandwidth,"
+      << "transmitted_fps,received_fps,lost_packets,remote_lost_packets,"
+      << "round_trip_time"
+      << std::endl;
+
+  /* oldest first */
+  unsigned idx = (ring_head + ring.size () - ring_count) % ring.size ();
+  for (unsigned ii = 0; ii < ring_count; ii++) {
+
+    const Sample& sample = ring[idx];
+    out << sample.offset << ','
+	<< sample.jitter << ','
+	<< sample.remote_jitter << ','
+	<< sample.transmitted_audio_bandwidth << ','
+	<< sample.received_audio_bandwidth << ','
+	<< sample.transmitted_video_bandwidth << ','
+	<< sample.received_video_bandwidth << ','
+	<< (unsigned) sample.transmitted_fps << ','
+	<< (unsigned) sample.received_fps << ','
+	<< (unsigned) sample.lost_packets << ','
+	<< (unsigned) sample.remote_lost_packets << ','
+	<< sample.round_trip_time << '\n';
+    idx = (idx + 1) % ring.size ();
+  }
+
+  out.flush ();
+  return out.good ();
+}
+
+void
+Ekiga::CallQualityRecorder::add_to_histogram (std::vector<unsigned> & histogram,
+					      unsigned & count,
+					      int value)
+{
+  if (value < 0) // N/A
+    return;
+
+  histogram[std::min (value, (int) JITTER_BUCKETS - 1)]++;
+  count++;
+}
+
+Ekiga::CallQualityPercentiles
+Ekiga::CallQualityRecorder::percentiles (const std::vector<unsigned> & histogram,
+					 unsigned count)
+{
+  CallQualityPercentiles result;
+  unsigned long long rank50 = ((unsigned long long) count * 50 + 99) / 100;
+  unsigned long long rank95 = ((unsigned long long) count * 95 + 99) / 100;
+  unsigned long long rank99 = ((unsigned long long) count * 99 + 99) / 100;
+  unsigned long long seen = 0;
+
+  if (count == 0)
+    return result;
+
+  for (unsigned ii = 0; ii < histogram.size () && result.p99 < 0; ii++) {
+
+    seen += histogram[ii];
+    if (result.p50 < 0 && seen >= rank50)
+      result.p50 = ii;
+    if (result.p95 < 0 && seen >= rank95)
+      result.p95 = ii;
+    if (result.p99 < 0 && seen >= rank99)
+      result.p99 = ii;
+  }
+
+  return result;
+}
@@ -0,0 +1,196 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         call-quality.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the per-call media quality recorder.
+ *
+ */
+
+#ifndef __CALL_QUALITY_H__
+#define __CALL_QUALITY_H__
+
+#include <string>
+#include <vector>
+
+#include "rtcp-statistics.h"
+
+namespace Ekiga
+{
+
+/**
+ * @addtogroup calls
+ * @{
+ */
+
+  /** A percentile triple, in ms (-1 if no value was ever sampled)
+   */
+  struct CallQualityPercentiles
+  {
+    CallQualityPercentiles () : p50 (-1), p95 (-1), p99 (-1) {}
+
+    int p50;
+    int p95;
+    int p99;
+  };
+
+  /** What is left of the quality of a call once it is over: small enough
+   * to be kept in the call history.
+   */
+  struct CallQualitySummary
+  {
+    CallQualitySummary ();
+
+    unsigned samples;                    // number of samples taken
+
+    CallQualityPercentiles jitter;        // of RTCPStatistics::jitter
+    CallQualityPercentiles remote_jitter; // of RTCPStatistics::remote_jitter
+
+    unsigned loss_bursts;                // runs of samples with reception loss
+    unsigned longest_loss_burst;         // in samples
+    unsigned lossy_samples;              // samples with reception loss
+
+    double received_fps_mean;
+    double received_fps_variance;
+    double transmitted_fps_mean;
+    double transmitted_fps_variance;
+
+    unsigned transmitted_audio_bandwidth; // mean, in kbits/s
+    unsigned received_audio_bandwidth;    // mean, in kbits/s
+    unsigned transmitted_video_bandwidth; // mean, in kbits/s
+    unsigned received_video_bandwidth;    // mean, in kbits/s
+  };
+
+  /** Samples the RTCP statistics of a call at a fixed cadence.
+   *
+   * Aggregates (jitter histograms, loss bursts, fps moments, bitrate sums)
+   * cover the whole call and are updated in O(1) per sample; the raw time
+   * series is kept in a fixed-size ring, so only the last samples of a
+   * very long call can be exported.
+   *
+   * The recorder does no locking of its own.
+   */
+  class CallQualityRecorder
+  {
+  public:
+
+    /** Create a recorder
+     * @param capacity is the number of raw samples kept for export
+     */
+    CallQualityRecorder (unsigned capacity = 3600);
+
+    /** Record a sample
+     * @param offset is the time of the sample in seconds since the call start
+     * @param stats are the statistics at that time
+     */
+    void record (unsigned offset,
+		 const RTCPStatistics & stats);
+
+    /** Forget everything recorded so far
+     */
+    void clear ();
+
+    /** Return the number of samples recorded since the last clear
+     */
+    unsigned get_samples () const
+    { return samples; }
+
+    /** Compute the summary of what was recorded so far
+     */
+    CallQualitySummary get_summary () const;
+
+    /** Write the time series kept in the ring as CSV
+     * @param filename is the file to (over)write
+     * @return true on success
+     */
+    bool export_to (const std::string & filename) const;
+
+  private:
+
+    /* one raw sample, packed: bandwidths in kbits/s, loss in % */
+    struct Sample
+    {
+      unsigned offset;
+      short jitter;
+      short remote_jitter;
+      unsigned short transmitted_audio_bandwidth;
+      unsigned short received_audio_bandwidth;
+      unsigned short transmitted_video_bandwidth;
+      unsigned short received_video_bandwidth;
+      unsigned char transmitted_fps;
+      unsigned char received_fps;
+      unsigned char lost_packets;
+      unsigned char remote_lost_packets;
+      short round_trip_time;
+    };
+
+    /* jitter histogram with one bucket per ms; the last one takes the rest */
+    enum { JITTER_BUCKETS = 1000 };
+
+    static void add_to_histogram (std::vector<unsigned> & histogram,
+				  unsigned & count,
+				  int value);
+
+    static CallQualityPercentiles percentiles (const std::vector<unsigned> & histogram,
+					       unsigned count);
+
+    std::vector<Sample> ring;
+    unsigned ring_head;
+    unsigned ring_count;
+
+    unsigned samples;
+
+    std::vector<unsigned> jitter_histogram;
+    unsigned jitter_count;
+    std::vector<unsigned> remote_jitter_histogram;
+    unsigned remote_jitter_count;
+
+    unsigned loss_bursts;
+    unsigned current_loss_burst;
+    unsigned longest_loss_burst;
+    unsigned lossy_samples;
+
+    /* Welford's running mean and sum of squared deviations */
+    double received_fps_mean;
+    double received_fps_m2;
+    double transmitted_fps_mean;
+    double transmitted_fps_m2;
+
+    unsigned long long transmitted_audio_bandwidth;
+    unsigned long long received_audio_bandwidth;
+    unsigned long long transmitted_video_bandwidth;
+    unsigned long long received_video_bandwidth;
+  };
+
+/**
+ * @}
+ */
+
+};
+
+#endif
@@ -44,6 +44,7 @@
 
 #include "actor.h"
 #include "rtcp-statistics.h"
+#include "call-quality.h"
 #include "dynamic-object.h"
 
 namespace Ekiga
@@ -149,6 +150,17 @@ namespace Ekiga
        */
       virtual const RTCPStatistics & get_statistics () = 0;
 
+      /** Return the summary of the media quality over the whole call
+       * @return CallQualitySummary
+       */
+      virtual CallQualitySummary get_quality_summary () = 0;
+
+      /** Write the media quality time series of the call as CSV
+       * @param filename is the file to write
+       * @return true on success
+       */
+      virtual bool export_quality (const std::string & filename) = 0;
+
       /*
        * Signals
        */
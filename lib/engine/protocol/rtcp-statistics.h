@@ -50,7 +50,8 @@ public:
         received_fps (0),
         transmitted_fps (0),
         lost_packets (0),
-        remote_lost_packets (0) {};
+        remote_lost_packets (0),
+        round_trip_time (-1) {};
 
     /* Audio */
     std::string transmitted_audio_codec;
@@ -71,6 +72,7 @@ public:
     /* Total */
     unsigned lost_packets;        // as a percentage
     unsigned remote_lost_packets; // as a percentage
+    int round_trip_time;          // in ms (-1 is N/A), from RTCP
 };
 
 #endif
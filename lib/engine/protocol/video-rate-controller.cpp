@@ -0,0 +1,169 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         video-rate-controller.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : implementation of the congestion controller of the
+ *                          transmitted video.
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "video-rate-controller.h"
+
+/* losses (in %) above which the rate is decreased, and by how much */
+#define LOSS_LIGHT 3
+#define LOSS_HEAVY 10
+#define DECREASE_LIGHT 0.85
+#define DECREASE_HEAVY 0.7
+
+/* losses (in %) below which the rate may increase */
+#define LOSS_CLEAN 1
+
+/* the round trip time is congested above MIN_RTT * 3 / 2 + RTT_SLACK */
+#define RTT_SLACK 40
+
+/* samples without increase after a decrease */
+#define HOLD_SAMPLES 4
+
+/* the bitrate never goes below the ceiling / MIN_FRACTION, nor MIN_BITRATE */
+#define MIN_FRACTION 8
+#define MIN_BITRATE 32
+
+/* the target bitrate is only changed when the rate moved that much (in %) */
+#define TARGET_HYSTERESIS 10
+
+/* the smallest picture worth halving */
+#define MIN_HALVED_WIDTH 352
+#define MIN_HALVED_HEIGHT 288
+
+Ekiga::VideoRateController::VideoRateController ():
+  rate(0), min_rtt(-1), hold(0), reduced_rate(false), reduced_size(false)
+{
+}
+
+void
+Ekiga::VideoRateController::reset (const VideoRateSettings & ceiling_)
+{
+  ceiling = ceiling_;
+  target = ceiling_;
+  rate = ceiling_.bitrate;
+  min_rtt = -1;
+  hold = 0;
+  reduced_rate = false;
+  reduced_size = false;
+}
+
+bool
+Ekiga::VideoRateController::update (const RTCPStatistics & stats)
+{
+  if ( !is_started ())
+    return false;
+
+  /* the lowest round trip time is the one of empty queues ; let it drift
+   * up slowly in case the route changed */
+  bool delayed = false;
+  if (stats.round_trip_time >= 0) {
+
+    if (min_rtt < 0 || stats.round_trip_time < min_rtt)
+      min_rtt = stats.round_trip_time;
+    else
+      min_rtt++;
+
+    delayed = stats.round_trip_time > min_rtt * 3 / 2 + RTT_SLACK;
+  }
+
+  const double floor = std::max (ceiling.bitrate / MIN_FRACTION, (unsigned) MIN_BITRATE);
+
+  if (stats.remote_lost_packets >= LOSS_HEAVY) {
+
+    rate *= DECREASE_HEAVY;
+    hold = HOLD_SAMPLES;
+  }
+  else if (stats.remote_lost_packets >= LOSS_LIGHT || (delayed && hold == 0)) {
+
+    /* the queues take a while to drain, so a lasting delay only
+     * decreases the rate once per hold period */
+    rate *= DECREASE_LIGHT;
+    hold = HOLD_SAMPLES;
+  }
+  else if (hold > 0)
+    hold--;
+  else if (stats.remote_lost_packets <= LOSS_CLEAN && !delayed)
+    rate += std::max (ceiling.bitrate / 20, 8u);
+  /* else the rate is about right */
+
+  rate = std::max (floor, std::min (rate, (double) ceiling.bitrate));
+
+  const VideoRateSettings previous = target;
+  update_target ();
+
+  return target != previous;
+}
+
+void
+Ekiga::VideoRateController::update_target ()
+{
+  const unsigned current = (unsigned) rate;
+
+  /* hitting either bound is always worth it */
+  if (current == ceiling.bitrate
+      || current <= std::max (ceiling.bitrate / MIN_FRACTION, (unsigned) MIN_BITRATE)
+      || (unsigned) std::abs ((int) current - (int) target.bitrate) * 100 > target.bitrate * TARGET_HYSTERESIS)
+    target.bitrate = current;
+
+  /* the thresholds going down and up differ, so a rate hovering around
+   * one of them doesn't change the picture at every sample */
+  const unsigned fraction = 100 * target.bitrate / ceiling.bitrate;
+
+  if (fraction < 40)
+    reduced_rate = true;
+  else if (fraction >= 55)
+    reduced_rate = false;
+
+  if (fraction < 20)
+    reduced_size = true;
+  else if (fraction >= 35)
+    reduced_size = false;
+
+  target.frame_rate = ceiling.frame_rate;
+  if (reduced_rate)
+    target.frame_rate = std::max (ceiling.frame_rate * 2 / 3, std::min (ceiling.frame_rate, 5u));
+
+  target.width = ceiling.width;
+  target.height = ceiling.height;
+  if (reduced_size
+      && ceiling.width >= MIN_HALVED_WIDTH
+      && ceiling.height >= MIN_HALVED_HEIGHT) {
+
+    target.width = ceiling.width / 2;
+    target.height = ceiling.height / 2;
+  }
+}
@@ -0,0 +1,142 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         video-rate-controller.h  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : declaration of the congestion controller of the
+ *                          transmitted video.
+ *
+ */
+
+#ifndef __VIDEO_RATE_CONTROLLER_H__
+#define __VIDEO_RATE_CONTROLLER_H__
+
+#include <string>
+
+#include "rtcp-statistics.h"
+
+namespace Ekiga
+{
+
+/**
+ * @addtogroup calls
+ * @{
+ */
+
+  /** What the video encoder of a call is asked to produce
+   */
+  struct VideoRateSettings
+  {
+    VideoRateSettings () : bitrate (0), frame_rate (0), width (0), height (0) {}
+
+    bool operator== (const VideoRateSettings & other) const
+    {
+      return bitrate == other.bitrate && frame_rate == other.frame_rate
+	&& width == other.width && height == other.height;
+    }
+
+    bool operator!= (const VideoRateSettings & other) const
+    { return !(*this == other); }
+
+    unsigned bitrate;    // target, in kbits/s
+    unsigned frame_rate; // in frames/s
+    unsigned width;
+    unsigned height;
+  };
+
+  /** Adapts the transmitted video of a call to the network.
+   *
+   * It is fed the RTCP statistics of the call at a fixed cadence, and
+   * works as an AIMD controller on the target bitrate : the remote losing
+   * packets, or the round trip time growing well above the lowest seen
+   * (the queues filling up before anything is lost), decreases the rate
+   * multiplicatively and holds it there for a while ; a clean network
+   * increases it additively, never above what the user configured.
+   *
+   * The frame rate, then the resolution, are lowered when the bitrate
+   * gets too low for them, and raised again only once it is comfortably
+   * above, so that the picture doesn't flap.
+   *
+   * The controller does no locking of its own.
+   */
+  class VideoRateController
+  {
+  public:
+
+    VideoRateController ();
+
+    /** Start over from the given settings, which are the most the
+     * controller will ever ask for.
+     * @param ceiling is what the user configured
+     */
+    void reset (const VideoRateSettings & ceiling);
+
+    /** Return true if reset was called
+     */
+    bool is_started () const
+    { return ceiling.bitrate != 0; }
+
+    /** Feed a new sample
+     * @param stats are the statistics of the call, over the last interval
+     * @return true if the target settings changed
+     */
+    bool update (const RTCPStatistics & stats);
+
+    const VideoRateSettings & get_ceiling () const
+    { return ceiling; }
+
+    const VideoRateSettings & get_target () const
+    { return target; }
+
+    /** Return the current rate estimate, in kbits/s ; the target bitrate
+     * only follows it when it moved enough.
+     */
+    unsigned get_rate () const
+    { return (unsigned) rate; }
+
+  private:
+
+    void update_target ();
+
+    VideoRateSettings ceiling;
+    VideoRateSettings target;
+
+    double rate;       // in kbits/s
+    int min_rtt;       // in ms, -1 until known
+    unsigned hold;     // samples left before increasing again
+    bool reduced_rate; // of frames
+    bool reduced_size;
+  };
+
+/**
+ * @}
+ */
+
+};
+
+#endif
@@ -38,6 +38,7 @@
 #include <iostream>
 #endif
 
+#include <algorithm>
 #include <glib/gi18n.h>
 
 #include "config.h"
@@ -55,10 +56,12 @@ VideoInputCore::VideoPreviewManager::VideoPreviewManager (VideoInputCore& _video
   videooutput_core (_videooutput_core)
 {
   width = 176;
-  height = 144;;
+  height = 144;
+  fps = 30;
   pause_thread = true;
   end_thread = false;
   frame = NULL;
+  frame_size = 0;
   // Since windows does not like to restart a thread that
   // was never started, we do so here
   this->Resume ();
@@ -68,6 +71,8 @@ VideoInputCore::VideoPreviewManager::~VideoPreviewManager ()
 {
   quit ();
 
+  free (frame);
+
 #if DEBUG
   std::cout << "Destroyed object of type " << typeid(*this).name () << std::endl;
 #endif
@@ -86,20 +91,28 @@ void VideoInputCore::VideoPreviewManager::quit ()
   }
 }
 
-void VideoInputCore::VideoPreviewManager::start (unsigned _width, unsigned _height)
+void VideoInputCore::VideoPreviewManager::start (unsigned _width, unsigned _height, unsigned _fps)
 {
   PTRACE(4, "PreviewManager\tStarting Preview");
 
+  {
+    /* the buffer is kept from one preview to the next: HD frames are big */
+    PWaitAndSignal c(frame_mutex);
+    unsigned size = _width * _height * 3 / 2;
+    if (size > frame_size) {
+
+      free (frame);
+      frame = (char*) malloc (size);
+      frame_size = size;
+    }
+  }
   {
     PWaitAndSignal c(capture_mutex);
     width = _width;
     height = _height;
+    fps = std::max (_fps, 1u);
     pause_thread = false;
   }
-  {
-    PWaitAndSignal c(frame_mutex);
-    frame = (char*) malloc (unsigned (width * height * 3 / 2));
-  }
 
   videooutput_core->start();
 }
@@ -116,12 +129,6 @@ void VideoInputCore::VideoPreviewManager::stop ()
       return;
     pause_thread = true;
   }
-
-  {
-    PWaitAndSignal c(frame_mutex);
-    if (frame)
-      free (frame);
-  }
 }
 
 void VideoInputCore::VideoPreviewManager::Main ()
@@ -129,19 +136,27 @@ void VideoInputCore::VideoPreviewManager::Main ()
   PWaitAndSignal m(thread_mutex);
   bool exit = end_thread;
   bool capture;
+  unsigned frame_width;
+  unsigned frame_height;
+  unsigned frame_interval;
 
   while (!exit) {
 
+    gint64 start = g_get_monotonic_time ();
+
     {
       PWaitAndSignal c(capture_mutex);
       capture = !pause_thread;
+      frame_width = width;
+      frame_height = height;
+      frame_interval = 1000 / fps;
     }
     if (capture) {
       {
         PWaitAndSignal c(frame_mutex);
         if (frame) {
           videoinput_core.get_frame_data(frame);
-          videooutput_core->set_frame_data(frame, width, height, VideoOutputManager::LOCAL, 1);
+          videooutput_core->set_frame_data(frame, frame_width, frame_height, VideoOutputManager::LOCAL, 1);
         }
       }
     }
@@ -149,7 +164,14 @@ void VideoInputCore::VideoPreviewManager::Main ()
        PWaitAndSignal q(exit_mutex);
        exit = end_thread;
     }
-    Current()->Sleep (50);
+
+    /* the device usually blocks until the next frame: only sleep what is
+     * left of the frame interval */
+    unsigned elapsed = (g_get_monotonic_time () - start) / 1000;
+    if (!capture)
+      Current()->Sleep (50);
+    else if (elapsed < frame_interval)
+      Current()->Sleep (frame_interval - elapsed);
   }
 }
 
@@ -161,7 +183,7 @@ void VideoInputCore::VideoPreviewManager::Terminate ()
 
 VideoInputCore::VideoInputCore (Ekiga::ServiceCore & _core,
                                 boost::shared_ptr<VideoOutputCore> _videooutput_core)
-  : core(_core)
+  : capture_timing("video capture"), core(_core)
 {
   PWaitAndSignal m_var(core_mutex);
   PWaitAndSignal m_set(settings_mutex);
@@ -408,7 +430,7 @@ void VideoInputCore::set_preview_config (unsigned width, unsigned height, unsign
 {
   PWaitAndSignal m(core_mutex);
 
-  if ( fps < 1 || fps > 30 ) {
+  if ( fps < 1 || fps > 60 ) {
     PTRACE(1, "VidInputCore\tmax-frame-rate out of range, ajusting to 30");
     fps = 30;
   }
@@ -425,7 +447,7 @@ void VideoInputCore::set_preview_config (unsigned width, unsigned height, unsign
     internal_close();
 
     internal_open(new_preview_config.width, new_preview_config.height, new_preview_config.fps);
-    preview_manager->start(new_preview_config.width, new_preview_config.height);
+    preview_manager->start(new_preview_config.width, new_preview_config.height, new_preview_config.fps);
   }
 
   preview_config = new_preview_config;
@@ -439,7 +461,7 @@ void VideoInputCore::start_preview ()
   PTRACE(4, "VidInputCore\tStarting preview " << preview_config);
   if (!preview_config.active && !stream_config.active) {
     internal_open(preview_config.width, preview_config.height, preview_config.fps);
-    preview_manager->start(preview_config.width, preview_config.height);
+    preview_manager->start(preview_config.width, preview_config.height, preview_config.fps);
   }
 
   preview_config.active = true;
@@ -506,7 +528,7 @@ void VideoInputCore::stop_stream ()
       internal_close();
       internal_open(preview_config.width, preview_config.height, preview_config.fps);
     }
-    preview_manager->start(preview_config.width, preview_config.height);
+    preview_manager->start(preview_config.width, preview_config.height, preview_config.fps);
   }
 
   if (!preview_config.active && stream_config.active) {
@@ -518,6 +540,8 @@ void VideoInputCore::stop_stream ()
 
 void VideoInputCore::get_frame_data (char *data)
 {
+  StageTimer timer(capture_timing);
+
   if (current_manager) {
     if (!current_manager->get_frame_data(data)) {
 
@@ -597,7 +621,7 @@ void VideoInputCore::internal_set_device(const VideoInputDevice & device, int ch
 
   if (preview_config.active && !stream_config.active) {
     internal_open(preview_config.width, preview_config.height, preview_config.fps);
-    preview_manager->start(preview_config.width,preview_config.height);
+    preview_manager->start(preview_config.width,preview_config.height,preview_config.fps);
   }
 
   if (stream_config.active)
@@ -42,6 +42,7 @@
 #include "hal-core.h"
 #include "notification-core.h"
 #include "videoinput-manager.h"
+#include "stage-timing.h"
 
 #include <boost/signals2.hpp>
 #include <boost/bind.hpp>
@@ -355,8 +356,9 @@ private:
         * In case the resolution is changed, the preview manager has to be stopped and restarted.
         * @param width the frame width in pixels of the preview video.
         * @param height the frame width in pixels of the preview video.
+        * @param fps the frame rate of the preview video.
         */
-        virtual void start(unsigned _width, unsigned _height);
+        virtual void start(unsigned _width, unsigned _height, unsigned _fps);
 
         /** Stop the preview thread.
         * Stop the thread represented by the Main() function. Blocks until the thread has terminated.
@@ -367,6 +369,7 @@ private:
         void Main ();
         void Terminate ();
         char* frame;
+        unsigned frame_size;
 
         bool end_thread;
         bool pause_thread;
@@ -380,6 +383,7 @@ private:
         boost::shared_ptr<VideoOutputCore> videooutput_core;
         unsigned width;
         unsigned height;
+        unsigned fps;
       };
 
       /** Class for storing the device configuration.
@@ -453,6 +457,8 @@ private:
       PMutex core_mutex;
       PMutex settings_mutex;
 
+      StageTiming capture_timing;
+
       Ekiga::ServiceCore & core;
       VideoPreviewManager* preview_manager;
       boost::shared_ptr<Ekiga::NotificationCore> notification_core;
@@ -460,6 +466,10 @@ private:
       Settings* device_settings;
       Settings* video_codecs_settings;
     };
+
+    /* the key to get it from the ServiceCore */
+    const ServiceKey<VideoInputCore> videoinput_core_key ("videoinput-core");
+
 /**
  * @}
  */
@@ -47,7 +47,10 @@
 
 using namespace Ekiga;
 
-VideoOutputCore::VideoOutputCore ()
+VideoOutputCore::VideoOutputCore ():
+  local_timing("video display (local)"),
+  remote_timing("video display (remote)"),
+  extended_timing("video display (extended)")
 {
   PWaitAndSignal m(core_mutex);
 
@@ -139,6 +142,9 @@ void VideoOutputCore::set_frame_data (const char *data,
                                       VideoOutputManager::VideoView type,
                                       int devices_nbr)
 {
+  StageTimer timer(type == VideoOutputManager::LOCAL ? local_timing
+                   : type == VideoOutputManager::REMOTE ? remote_timing
+                   : extended_timing);
   PWaitAndSignal m(core_mutex);
 
   for (std::set<VideoOutputManager *>::iterator iter = managers.begin ();
@@ -46,6 +46,7 @@
 #include <ptlib.h>
 
 #include "videooutput-manager.h"
+#include "stage-timing.h"
 
 namespace Ekiga
 {
@@ -170,8 +171,17 @@ namespace Ekiga
 
       int number_times_started;
 
+      /* of set_frame_data, for each view */
+      StageTiming local_timing;
+      StageTiming remote_timing;
+      StageTiming extended_timing;
+
       PMutex core_mutex;
     };
+
+    /* the key to get it from the ServiceCore */
+    const ServiceKey<VideoOutputCore> videooutput_core_key ("videooutput-core");
+
 /**
  * @}
  */
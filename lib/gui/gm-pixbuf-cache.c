@@ -0,0 +1,157 @@
+/* Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * Ekiga is licensed under the GPL license and as a special exception,
+ * you have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination,
+ * without applying the requirements of the GNU GPL to the OPAL, OpenH323
+ * and PWLIB programs, as long as you do follow the requirements of the
+ * GNU GPL for all the rest of the software thus combined.
+ */
+
+
+/*
+ *                        gm-pixbuf-cache.c  -  description
+ *                         --------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (C) 2026 by the Ekiga developers
+ *   description          : Implementation of the shared icon cache
+ *
+ */
+
+#include "gm-pixbuf-cache.h"
+
+#define DEFAULT_CAPACITY 64
+
+typedef struct {
+  gchar *key;
+  GdkPixbuf *pixbuf;
+} CacheEntry;
+
+/* The entries are in a queue, most recently used first ; the table gives
+ * the link of each of them in the queue, by key */
+static GQueue entries = G_QUEUE_INIT;
+static GHashTable *links = NULL;
+static guint capacity = DEFAULT_CAPACITY;
+
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+  g_object_unref (entry->pixbuf);
+  g_free (entry->key);
+  g_slice_free (CacheEntry, entry);
+}
+
+
+static void
+cache_trim (guint size)
+{
+  CacheEntry *entry = NULL;
+
+  while (g_queue_get_length (&entries) > size) {
+
+    entry = (CacheEntry *) g_queue_pop_tail (&entries);
+    g_hash_table_remove (links, entry->key);
+    cache_entry_free (entry);
+  }
+}
+
+
+static void
+on_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *theme,
+                       G_GNUC_UNUSED gpointer data)
+{
+  gm_pixbuf_cache_clear ();
+}
+
+
+static void
+cache_init (void)
+{
+  if (links != NULL)
+    return;
+
+  /* the keys belong to the entries */
+  links = g_hash_table_new (g_str_hash, g_str_equal);
+  g_signal_connect (gtk_icon_theme_get_default (), "changed",
+                    G_CALLBACK (on_icon_theme_changed), NULL);
+}
+
+
+GdkPixbuf *
+gm_pixbuf_cache_load_icon (const gchar *icon_name,
+                           gint size,
+                           GtkIconLookupFlags flags)
+{
+  gchar *key = NULL;
+  GList *link = NULL;
+  CacheEntry *entry = NULL;
+  GdkPixbuf *pixbuf = NULL;
+
+  g_return_val_if_fail (icon_name != NULL, NULL);
+
+  cache_init ();
+
+  key = g_strdup_printf ("%s/%d/%d", icon_name, size, (int) flags);
+  link = (GList *) g_hash_table_lookup (links, key);
+
+  if (link != NULL) {
+
+    g_queue_unlink (&entries, link);
+    g_queue_push_head_link (&entries, link);
+    g_free (key);
+    return g_object_ref (((CacheEntry *) link->data)->pixbuf);
+  }
+
+  pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
+                                     icon_name, size, flags, NULL);
+  if (pixbuf == NULL || capacity == 0) {
+
+    g_free (key);
+    return pixbuf;
+  }
+
+  entry = g_slice_new (CacheEntry);
+  entry->key = key;
+  entry->pixbuf = g_object_ref (pixbuf);
+  g_queue_push_head (&entries, entry);
+  g_hash_table_insert (links, entry->key, entries.head);
+
+  cache_trim (capacity);
+
+  return pixbuf;
+}
+
+
+void
+gm_pixbuf_cache_set_capacity (guint new_capacity)
+{
+  capacity = new_capacity;
+
+  if (links != NULL)
+    cache_trim (capacity);
+}
+
+
+void
+gm_pixbuf_cache_clear (void)
+{
+  if (links != NULL)
+    cache_trim (0);
+}
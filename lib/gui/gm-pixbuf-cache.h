@@ -0,0 +1,71 @@
+/* Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * Ekiga is licensed under the GPL license and as a special exception,
+ * you have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination,
+ * without applying the requirements of the GNU GPL to the OPAL, OpenH323
+ * and PWLIB programs, as long as you do follow the requirements of the
+ * GNU GPL for all the rest of the software thus combined.
+ */
+
+
+/*
+ *                        gm-pixbuf-cache.h  -  description
+ *                         --------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (C) 2026 by the Ekiga developers
+ *   description          : Declaration of the shared icon cache
+ *
+ */
+
+#ifndef __GM_PIXBUF_CACHE_H__
+#define __GM_PIXBUF_CACHE_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* The smileys, avatars and status icons are the same few images over and
+ * over: rather than loading them from the icon theme for each chat line
+ * or roster row, the GUI gets them from this cache.
+ *
+ * It keeps the most recently used icons of the default icon theme, keyed
+ * by name, size and lookup flags, and drops the least recently used ones
+ * beyond its capacity ; it is emptied when the icon theme changes.
+ *
+ * It is meant to be used from the main loop only.
+ */
+
+/* Returns a new reference to the icon, which the caller must unref, or
+ * NULL if the icon theme doesn't have it: this is a drop-in replacement
+ * for gtk_icon_theme_load_icon on the default icon theme.
+ */
+GdkPixbuf *gm_pixbuf_cache_load_icon (const gchar *icon_name,
+                                      gint size,
+                                      GtkIconLookupFlags flags);
+
+/* How many icons the cache keeps (64 by default) */
+void gm_pixbuf_cache_set_capacity (guint capacity);
+
+/* Forgets all the icons ; those still used elsewhere stay alive */
+void gm_pixbuf_cache_clear (void);
+
+G_END_DECLS
+
+#endif
@@ -47,6 +47,7 @@
 
 #include "gm-smiley-chooser-button.h"
 #include "gm-smileys.h"
+#include "gm-pixbuf-cache.h"
 
 #include <math.h>
 
@@ -616,10 +617,11 @@ gm_smiley_chooser_build_view (GmSmileyChooserButton* self)
          iter_x++) {
       button = gtk_button_new ();
       gtk_button_set_relief (GTK_BUTTON (button), GTK_RELIEF_NONE);
-      pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                         self->priv->smiley_set[smiley + 1], 16,
-                                         (GtkIconLookupFlags)0, NULL);
+      pixbuf = gm_pixbuf_cache_load_icon (self->priv->smiley_set[smiley + 1], 16,
+                                          (GtkIconLookupFlags)0);
       image = gtk_image_new_from_pixbuf (pixbuf);
+      if (pixbuf)
+        g_object_unref (pixbuf);
       gtk_container_add (GTK_CONTAINER (button), image);
       g_object_set_data_full (G_OBJECT (button),
                               "smiley_characters",
@@ -37,6 +37,7 @@
 #include "gm-text-smiley.h"
 
 #include "gm-smileys.h"
+#include "gm-pixbuf-cache.h"
 
 #include <string.h>
 
@@ -140,8 +141,7 @@ enhancer_helper_enhance (G_GNUC_UNUSED GmTextBufferEnhancerHelper* self,
 
   if (pixbuf_name != NULL) {
 
-    pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-				       pixbuf_name, 16, 0, NULL);
+    pixbuf = gm_pixbuf_cache_load_icon (pixbuf_name, 16, 0);
     gtk_text_buffer_insert_pixbuf (buffer, iter, pixbuf);
     g_object_unref (pixbuf);
     *start = *start + length;
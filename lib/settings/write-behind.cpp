@@ -0,0 +1,142 @@
+/* Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2013 Damien Sandras <dsandras@seconix.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * Ekiga is licensed under the GPL license and as a special exception,
+ * you have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination,
+ * without applying the requirements of the GNU GPL to the OPAL, OpenH323
+ * and PWLIB programs, as long as you do follow the requirements of the
+ * GNU GPL for all the rest of the software thus combined.
+ */
+
+
+/*
+ *                         write-behind.cpp  -  description
+ *                         --------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : This file implements a helper to save settings
+ *                          documents lazily
+ *
+ */
+
+#include <set>
+
+#include "write-behind.h"
+
+namespace
+{
+  std::set<Ekiga::WriteBehind*> pending;
+  unsigned scheduled = 0;
+  unsigned written = 0;
+};
+
+
+Ekiga::WriteBehind::WriteBehind (boost::function0<void> save_,
+                                 unsigned delay_):
+  save(save_), delay(delay_), timeout(0)
+{
+}
+
+
+Ekiga::WriteBehind::~WriteBehind ()
+{
+  cancel ();
+}
+
+
+void
+Ekiga::WriteBehind::schedule ()
+{
+  scheduled++;
+
+  /* the window starts with the first change: later ones don't push the
+   * save further away */
+  if (timeout != 0)
+    return;
+
+  timeout = g_timeout_add (delay, &WriteBehind::on_timeout, this);
+  pending.insert (this);
+}
+
+
+void
+Ekiga::WriteBehind::flush ()
+{
+  if (timeout == 0)
+    return;
+
+  cancel ();
+  written++;
+  save ();
+}
+
+
+bool
+Ekiga::WriteBehind::is_pending () const
+{
+  return timeout != 0;
+}
+
+
+void
+Ekiga::WriteBehind::flush_all ()
+{
+  /* saving may schedule again, so don't walk the set */
+  while (!pending.empty ())
+    (*pending.begin ())->flush ();
+}
+
+
+unsigned
+Ekiga::WriteBehind::get_scheduled ()
+{
+  return scheduled;
+}
+
+
+unsigned
+Ekiga::WriteBehind::get_written ()
+{
+  return written;
+}
+
+
+gboolean
+Ekiga::WriteBehind::on_timeout (gpointer data)
+{
+  WriteBehind* self = (WriteBehind*) data;
+
+  /* the source goes away with this FALSE */
+  self->timeout = 0;
+  pending.erase (self);
+  written++;
+  self->save ();
+
+  return FALSE;
+}
+
+
+void
+Ekiga::WriteBehind::cancel ()
+{
+  if (timeout != 0)
+    g_source_remove (timeout);
+  timeout = 0;
+  pending.erase (this);
+}
@@ -0,0 +1,100 @@
+/* Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2013 Damien Sandras <dsandras@seconix.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * Ekiga is licensed under the GPL license and as a special exception,
+ * you have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination,
+ * without applying the requirements of the GNU GPL to the OPAL, OpenH323
+ * and PWLIB programs, as long as you do follow the requirements of the
+ * GNU GPL for all the rest of the software thus combined.
+ */
+
+
+/*
+ *                         write-behind.h  -  description
+ *                         -------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : This file declares a helper to save settings
+ *                          documents lazily
+ *
+ */
+
+
+#ifndef EKIGA_WRITE_BEHIND_H_
+#define EKIGA_WRITE_BEHIND_H_
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <glib.h>
+
+namespace Ekiga {
+
+  /*
+   * The accounts, the call history and the address books keep their data
+   * as a whole XML document in a single key: saving it means dumping the
+   * full document and writing it through dconf, which wakes up every
+   * listener. Some of them change several times in a row (registering
+   * accounts, ending a call), so instead of saving right away they
+   * schedule the save with a WriteBehind, which runs it once, at the end
+   * of a short window, however many changes happened in it.
+   *
+   * The owner must flush () in its destructor, while it can still save:
+   * the WriteBehind itself only forgets about a pending save when it is
+   * destroyed. flush_all () saves everything pending, for when the engine
+   * stops.
+   *
+   * It is meant to be used from the main loop only.
+   */
+  class WriteBehind : boost::noncopyable {
+
+public:
+
+    WriteBehind (boost::function0<void> save_,
+                 unsigned delay_ = 1000 /* ms */);
+
+    ~WriteBehind ();
+
+    /* The document changed: save it at the end of the window */
+    void schedule ();
+
+    /* Save it now if a save is pending */
+    void flush ();
+
+    bool is_pending () const;
+
+    static void flush_all ();
+
+    /* How many saves were scheduled, and how many were actually done */
+    static unsigned get_scheduled ();
+    static unsigned get_written ();
+
+private:
+
+    static gboolean on_timeout (gpointer data);
+
+    void cancel ();
+
+    boost::function0<void> save;
+    unsigned delay;
+    guint timeout;
+  };
+};
+
+#endif /* EKIGA_WRITE_BEHIND_H_ */
@@ -79,6 +79,9 @@ struct AVAHISpark: public Ekiga::Spark
   bool result;
 };
 
+/* nothing is configured for it: the neighbours show up when idle */
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
@@ -118,6 +118,23 @@ Evolution::Contact::has_uri (const std::string uri) const
 	  || get_attribute_value (ATTR_VIDEO) == uri);
 }
 
+const std::set<std::string>
+Evolution::Contact::get_uris () const
+{
+  std::set<std::string> result;
+
+  for (unsigned int ii = 0;
+       ii < ATTR_NUMBER;
+       ii++) {
+
+    std::string value = get_attribute_value (ii);
+    if ( !value.empty ())
+      result.insert (value);
+  }
+
+  return result;
+}
+
 void
 Evolution::Contact::update_econtact (EContact *_econtact)
 {
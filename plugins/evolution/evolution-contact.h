@@ -76,6 +76,8 @@ namespace Evolution
 
     bool has_uri (const std::string uri) const;
 
+    const std::set<std::string> get_uris () const;
+
     void update_econtact (EContact *econtact);
 
     void remove ();
@@ -73,6 +73,9 @@ struct EVOSpark: public Ekiga::Spark
   bool result;
 };
 
+/* nothing is configured for it: the address books show up when idle */
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
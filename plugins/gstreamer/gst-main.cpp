@@ -41,6 +41,7 @@
 #include "videoinput-core.h"
 #include "audioinput-core.h"
 #include "audiooutput-core.h"
+#include "ekiga-settings.h"
 
 #include "gst-videoinput.h"
 #include "gst-audioinput.h"
@@ -108,6 +109,15 @@ struct GSTSpark: public Ekiga::Spark
   bool result;
 };
 
+/* loaded at startup when a GStreamer device is chosen, when idle otherwise */
+extern "C" const char* const ekiga_plugin_startup_settings[] = {
+  AUDIO_DEVICES_SCHEMA, "input-device", "(GStreamer/",
+  AUDIO_DEVICES_SCHEMA, "output-device", "(GStreamer/",
+  SOUND_EVENTS_SCHEMA, "output-device", "(GStreamer/",
+  VIDEO_DEVICES_SCHEMA, "input-device", "(GStreamer/",
+  NULL };
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
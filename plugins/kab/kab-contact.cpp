@@ -79,6 +79,21 @@ KAB::Contact::has_uri (const std::string uri) const
   return result;
 }
 
+const std::set<std::string>
+KAB::Contact::get_uris () const
+{
+  std::set<std::string> result;
+  KABC::PhoneNumber::List phoneNumbers = addressee.phoneNumbers ();
+  for (KABC::PhoneNumber::List::const_iterator iter = phoneNumbers.begin ();
+       iter != phoneNumbers.end ();
+       iter++) {
+
+    result.insert ((*iter).number ().toUtf8 ().constData ());
+  }
+
+  return result;
+}
+
 bool
 KAB::Contact::populate_menu (Ekiga::MenuBuilder &builder)
 {
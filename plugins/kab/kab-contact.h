@@ -64,6 +64,8 @@ namespace KAB
 
     bool has_uri (const std::string uri) const;
 
+    const std::set<std::string> get_uris () const;
+
     bool populate_menu (Ekiga::MenuBuilder &builder);
 
   private:
@@ -71,6 +71,8 @@ struct KABSpark: public Ekiga::Spark
 
 };
 
+extern "C" const char* const ekiga_plugin_requires[] = { "kde-core", "contact-core", NULL };
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
@@ -82,6 +82,10 @@ struct KDESpark: public Ekiga::Spark
 
 };
 
+/* only the KDE address book needs it */
+extern "C" const char* const ekiga_plugin_provides[] = { "kde-core", NULL };
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
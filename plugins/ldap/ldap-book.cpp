@@ -51,6 +51,12 @@
 
 #define EKIGA_NET_URI "ldap://ekiga.net"
 
+/* how many entries we ask the server for at once */
+#define LDAP_PAGE_SIZE 100
+
+/* how long (in seconds) we wait for the server before giving up */
+#define LDAP_TIMEOUT 30
+
 /* little helper function... can probably be made more complete */
 static const std::string
 fix_to_utf8 (const std::string str)
@@ -188,7 +194,9 @@ OPENLDAP::Book::Book (Ekiga::ServiceCore &_core,
 		      xmlNodePtr _node):
   saslform(NULL), core(_core), doc(_doc), node(_node),
   name_node(NULL), uri_node(NULL), authcID_node(NULL), password_node(NULL),
-  ldap_context(NULL), patience(0)
+  ldap_context(NULL), connecting(false), generation(0),
+  io_watch(0), timeout_id(0), search_msgid(-1), page_cookie(NULL),
+  nbr_found(0)
 {
   xmlChar *xml_str;
   bool upgrade_config = false;
@@ -368,7 +376,9 @@ OPENLDAP::Book::Book (Ekiga::ServiceCore &_core,
 		      OPENLDAP::BookInfo _bookinfo):
   saslform(NULL), core(_core), doc(_doc), name_node(NULL),
   uri_node(NULL), authcID_node(NULL), password_node(NULL),
-  ldap_context(NULL), patience(0)
+  ldap_context(NULL), connecting(false), generation(0),
+  io_watch(0), timeout_id(0), search_msgid(-1), page_cookie(NULL),
+  nbr_found(0)
 {
   node = xmlNewNode (NULL, BAD_CAST "server");
 
@@ -402,6 +412,7 @@ OPENLDAP::Book::Book (Ekiga::ServiceCore &_core,
 
 OPENLDAP::Book::~Book ()
 {
+  disconnect ();
 }
 
 bool
@@ -469,7 +480,11 @@ OPENLDAP::Book::refresh ()
   /* we flush */
   contacts.remove_all_objects ();
 
-  if (ldap_context == NULL)
+  /* the bound connection is kept between searches, and a search still
+   * running is abandoned in favour of the new one */
+  if (ldap_context != NULL)
+    refresh_bound ();
+  else if ( !connecting)
     refresh_start ();
 }
 
@@ -681,74 +696,197 @@ extern "C" {
 
 } /* extern "C" */
 
-void
-OPENLDAP::Book::refresh_start ()
+/* the connection (and the StartTLS negotiation and simple bind which come
+ * with it) is done in a thread, since those are blocking calls : we put all
+ * needed data in this structure, let everything happen elsewhere, then push
+ * back into the main thread
+ */
+struct ConnectData
 {
-  int msgid = -1;
-  int result = LDAP_SUCCESS;
+  ConnectData (boost::shared_ptr<OPENLDAP::Book> _book,
+	       unsigned int _generation,
+	       const OPENLDAP::BookInfo& _info):
+    book(_book), generation(_generation), info(_info),
+    ldap_context(NULL), initialized(false), result(LDAP_SUCCESS)
+  {
+  }
+
+  boost::weak_ptr<OPENLDAP::Book> book;
+  unsigned int generation;
+  OPENLDAP::BookInfo info;
+
+  /* result data */
+  LDAP* ldap_context;
+  bool initialized;
+  int result;
+};
+
+static void
+ldap_connect_done (ConnectData* data)
+{
+  boost::shared_ptr<OPENLDAP::Book> book = data->book.lock ();
+
+  if (book)
+    book->on_connected (data->generation, data->ldap_context,
+			data->initialized, data->result);
+  else if (data->ldap_context != NULL)
+    ldap_unbind_ext (data->ldap_context, NULL, NULL);
+
+  delete data;
+}
+
+static gpointer
+ldap_connect_thread (gpointer user_data)
+{
+  ConnectData* data = (ConnectData*)user_data;
   int ldap_version = LDAP_VERSION3;
+  struct timeval network_timeout = { LDAP_TIMEOUT, 0 };
 
-  status = std::string (_("Refreshing"));
-  updated (this->shared_from_this ());
+  data->result = ldap_initialize (&data->ldap_context,
+				  data->info.uri_host.c_str ());
+  if (data->result == LDAP_SUCCESS) {
 
-  result = ldap_initialize (&ldap_context, bookinfo.uri_host.c_str());
-  if (result != LDAP_SUCCESS) {
+    data->initialized = true;
 
-    status = std::string (_("Could not initialize server"));
-    updated (this->shared_from_this ());
-    return;
-  }
+    /* the openldap code shows I don't have to check the result of this
+     * (see for example tests/prog/slapd-search.c)
+     */
+    (void)ldap_set_option (data->ldap_context,
+			   LDAP_OPT_PROTOCOL_VERSION, &ldap_version);
+    (void)ldap_set_option (data->ldap_context,
+			   LDAP_OPT_NETWORK_TIMEOUT, &network_timeout);
 
-  /* the openldap code shows I don't have to check the result of this
-   * (see for example tests/prog/slapd-search.c)
-   */
-  (void)ldap_set_option (ldap_context,
-			 LDAP_OPT_PROTOCOL_VERSION, &ldap_version);
-
-  if (bookinfo.starttls) {
-    result = ldap_start_tls_s (ldap_context, NULL, NULL);
-    if (result != LDAP_SUCCESS) {
-      status = std::string (_("LDAP Error: ")) +
-        std::string (ldap_err2string (result));
-      updated (this->shared_from_this ());
-      ldap_unbind_ext (ldap_context, NULL, NULL);
-      ldap_context = NULL;
-      return;
+    if (data->info.starttls)
+      data->result = ldap_start_tls_s (data->ldap_context, NULL, NULL);
+
+    if (data->result == LDAP_SUCCESS) {
+
+      /* Simple Bind */
+      struct berval passwd = { 0, NULL };
+      const char* who = NULL;
+
+      if ( !data->info.password.empty ()) {
+
+	passwd.bv_val = g_strdup (data->info.password.c_str ());
+	passwd.bv_len = data->info.password.length ();
+	who = data->info.authcID.c_str ();
+      }
+
+      data->result = ldap_sasl_bind_s (data->ldap_context, who,
+				       LDAP_SASL_SIMPLE, &passwd,
+				       NULL, NULL, NULL);
+      g_free (passwd.bv_val);
+    }
+
+    if (data->result != LDAP_SUCCESS) {
+
+      ldap_unbind_ext (data->ldap_context, NULL, NULL);
+      data->ldap_context = NULL;
     }
+  } else {
+
+    data->ldap_context = NULL;
   }
 
-  if (bookinfo.sasl) {
-    interctx ctx;
+  Ekiga::Runtime::run_in_main (boost::bind (&ldap_connect_done, data));
+
+  return NULL;
+}
+
+static gboolean
+ldap_readable_cb (GIOChannel* /*channel*/,
+		  GIOCondition /*condition*/,
+		  gpointer data)
+{
+  ((OPENLDAP::Book*)data)->on_readable ();
 
-    ctx.book = this;
-    ctx.authcID = bookinfo.authcID;
-    ctx.password = bookinfo.password;
-    result = ldap_sasl_interactive_bind_s (ldap_context, NULL,
-					   bookinfo.saslMech.c_str(), NULL, NULL, LDAP_SASL_QUIET,
-					   book_saslinter, &ctx);
+  return TRUE;
+}
 
+static gboolean
+ldap_timeout_cb (gpointer data)
+{
+  ((OPENLDAP::Book*)data)->on_timeout ();
+
+  return FALSE;
+}
+
+void
+OPENLDAP::Book::refresh_start ()
+{
+  status = std::string (_("Refreshing"));
+  updated (this->shared_from_this ());
+
+  connecting = true;
+  generation++;
+
+  if ( !bookinfo.sasl) {
+
+    GThread* thread = g_thread_new ("ldap-connect", ldap_connect_thread,
+				    new ConnectData (this->shared_from_this (),
+						     generation, bookinfo));
+    g_thread_unref (thread);
   } else {
-    /* Simple Bind */
-    if (bookinfo.password.empty ()) {
-      struct berval bv={0,NULL};
-
-      result = ldap_sasl_bind (ldap_context, NULL,
-			       LDAP_SASL_SIMPLE, &bv,
-			       NULL, NULL,
-			       &msgid);
-    } else {
 
-      struct berval passwd = { 0, NULL };
-      passwd.bv_val = g_strdup (bookinfo.password.c_str ());
-      passwd.bv_len = bookinfo.password.length();
+    /* the SASL interaction may need to ask the user, so it can't happen
+     * in a thread
+     */
+    LDAP* ld = NULL;
+    int ldap_version = LDAP_VERSION3;
+    int result = ldap_initialize (&ld, bookinfo.uri_host.c_str());
+    bool initialized = (result == LDAP_SUCCESS);
 
-      result = ldap_sasl_bind (ldap_context, bookinfo.authcID.c_str(),
-			       LDAP_SASL_SIMPLE, &passwd,
-			       NULL, NULL,
-			       &msgid);
+    if (initialized) {
 
-      g_free (passwd.bv_val);
+      (void)ldap_set_option (ld, LDAP_OPT_PROTOCOL_VERSION, &ldap_version);
+
+      if (bookinfo.starttls)
+	result = ldap_start_tls_s (ld, NULL, NULL);
+
+      if (result == LDAP_SUCCESS) {
+
+	interctx ctx;
+
+	ctx.book = this;
+	ctx.authcID = bookinfo.authcID;
+	ctx.password = bookinfo.password;
+	result = ldap_sasl_interactive_bind_s (ld, NULL,
+					       bookinfo.saslMech.c_str(), NULL, NULL, LDAP_SASL_QUIET,
+					       book_saslinter, &ctx);
+      }
+
+      if (result != LDAP_SUCCESS) {
+
+	ldap_unbind_ext (ld, NULL, NULL);
+	ld = NULL;
+      }
     }
+
+    on_connected (generation, ld, initialized, result);
+  }
+}
+
+void
+OPENLDAP::Book::on_connected (unsigned int generation_,
+			      LDAP* ld,
+			      bool initialized,
+			      int result)
+{
+  if (generation_ != generation) {
+
+    /* we were cancelled or restarted in the mean time */
+    if (ld != NULL)
+      ldap_unbind_ext (ld, NULL, NULL);
+    return;
+  }
+
+  connecting = false;
+
+  if ( !initialized) {
+
+    status = std::string (_("Could not initialize server"));
+    updated (this->shared_from_this ());
+    return;
   }
 
   if (result != LDAP_SUCCESS) {
@@ -756,70 +894,43 @@ OPENLDAP::Book::refresh_start ()
     status = std::string (_("LDAP Error: ")) +
       std::string (ldap_err2string (result));
     updated (this->shared_from_this ());
-
-    ldap_unbind_ext (ldap_context, NULL, NULL);
-    ldap_context = NULL;
     return;
   }
 
+  ldap_context = ld;
+
+  {
+    int fd = -1;
+
+    if (ldap_get_option (ldap_context, LDAP_OPT_DESC, &fd) == LDAP_OPT_SUCCESS
+	&& fd >= 0) {
+
+      GIOChannel* channel = g_io_channel_unix_new (fd);
+      io_watch = g_io_add_watch (channel,
+				 (GIOCondition)(G_IO_IN | G_IO_ERR | G_IO_HUP),
+				 ldap_readable_cb, this);
+      g_io_channel_unref (channel);
+    }
+  }
+
   status = std::string (_("Contacted server"));
   updated (this->shared_from_this ());
 
-  patience = 3;
   refresh_bound ();
 }
 
 void
 OPENLDAP::Book::refresh_bound ()
 {
-  int result = LDAP_SUCCESS;
-  struct timeval timeout = { 1, 0}; /* block 1s */
-  LDAPMessage *msg_entry = NULL;
-  int msgid;
   std::string filter, fterm;
-  const char *fstr;
   size_t pos;
 
-  if (bookinfo.sasl)
-    goto sasl_bound;
-
-  result = ldap_result (ldap_context, LDAP_RES_ANY, LDAP_MSG_ALL,
-			&timeout, &msg_entry);
-
-  if (result <= 0) {
-
-    if (patience == 3) {
-      patience--;
-      Ekiga::Runtime::run_in_main (boost::bind (&OPENLDAP::Book::refresh_bound, this), 12);
-    } else if (patience == 2) {
-
-      patience--;
-      Ekiga::Runtime::run_in_main (boost::bind (&OPENLDAP::Book::refresh_bound, this), 21);
-    } else if (patience == 1) {
-
-      patience--;
-      Ekiga::Runtime::run_in_main (boost::bind (&OPENLDAP::Book::refresh_bound, this), 30);
-    } else { // patience == 0
-
-      status = std::string (_("Could not connect to server"));
-      updated (this->shared_from_this ());
-
-      ldap_unbind_ext (ldap_context, NULL, NULL);
-      ldap_context = NULL;
-    }
-
-    if (msg_entry != NULL)
-      ldap_msgfree (msg_entry);
-
-    return;
-  }
-  (void) ldap_msgfree (msg_entry);
+  cancel_search ();
 
- sasl_bound:
   if (!search_filter.empty ()) {
     if (search_filter[0] == '(' &&
         search_filter[search_filter.length()-1] == ')') {
-      fstr = search_filter.c_str();
+      current_filter = search_filter;
       goto do_search;
     }
     fterm = "*" + search_filter + "*";
@@ -835,110 +946,228 @@ OPENLDAP::Book::refresh_bound ()
     filter.replace (pos, 1, fterm);
     pos += fterm.length();
   }
-  fstr = filter.c_str();
+  current_filter = filter;
 
  do_search:
-  msgid = ldap_search_ext (ldap_context,
-			   bookinfo.urld->lud_dn,
-			   bookinfo.urld->lud_scope,
-			   fstr,
-			   bookinfo.urld->lud_attrs,
-			   0, /* attrsonly */
-			   NULL, NULL,
-			   NULL, 0, &msgid);
+  nbr_found = 0;
+  search_page ();
+}
+
+void
+OPENLDAP::Book::search_page ()
+{
+  int result = LDAP_SUCCESS;
+  LDAPControl* page_control = NULL;
+  LDAPControl* server_controls[2] = { NULL, NULL };
+
+  /* RFC 2696 paged results : not critical, so servers which don't know
+   * about it will just send everything in one go
+   */
+  if (ldap_create_page_control (ldap_context, LDAP_PAGE_SIZE,
+				page_cookie, 0, &page_control) == LDAP_SUCCESS)
+    server_controls[0] = page_control;
+
+  result = ldap_search_ext (ldap_context,
+			    bookinfo.urld->lud_dn,
+			    bookinfo.urld->lud_scope,
+			    current_filter.c_str (),
+			    bookinfo.urld->lud_attrs,
+			    0, /* attrsonly */
+			    server_controls, NULL,
+			    NULL, 0, &search_msgid);
+
+  if (page_control != NULL)
+    ldap_control_free (page_control);
 
-  if (msgid == -1) {
+  if (result != LDAP_SUCCESS) {
 
     status = std::string (_("Could not search"));
     updated (this->shared_from_this ());
 
-    ldap_unbind_ext (ldap_context, NULL, NULL);
-    ldap_context = NULL;
+    disconnect ();
     return;
-  } else {
+  } else if (nbr_found == 0) {
 
     status = std::string (_("Waiting for search results"));
     updated (this->shared_from_this ());
   }
 
-  patience = 3;
-  refresh_result ();
+  if (timeout_id != 0)
+    g_source_remove (timeout_id);
+  timeout_id = g_timeout_add_seconds (LDAP_TIMEOUT, ldap_timeout_cb, this);
 }
 
 void
-OPENLDAP::Book::refresh_result ()
+OPENLDAP::Book::on_readable ()
 {
-  int result = LDAP_SUCCESS;
-  int nbr = 0;
-  struct timeval timeout = { 1, 0}; /* block 1s */
+  int result = 0;
+  struct timeval timeout = { 0, 0 }; /* don't block */
   LDAPMessage *msg_entry = NULL;
-  LDAPMessage *msg_result = NULL;
-  gchar* c_status = NULL;
 
-  result = ldap_result (ldap_context, LDAP_RES_ANY, LDAP_MSG_ALL,
-			&timeout, &msg_entry);
+  if (ldap_context == NULL)
+    return;
+
+  do {
 
+    result = ldap_result (ldap_context,
+			  (search_msgid != -1) ? search_msgid : LDAP_RES_ANY,
+			  LDAP_MSG_ONE, &timeout, &msg_entry);
 
-  if (result <= 0) {
+    if (result < 0) {
 
-    if (patience == 3) {
+      /* the connection is gone ; the next refresh will reconnect */
+      if (search_msgid != -1) {
 
-      patience--;
-      Ekiga::Runtime::run_in_main (boost::bind (&OPENLDAP::Book::refresh_result, this),
-				   12);
-    } else if (patience == 2) {
+	status = std::string (_("Could not search"));
+	updated (this->shared_from_this ());
+      }
+      disconnect ();
+      return;
+    }
 
-      patience--;
-      Ekiga::Runtime::run_in_main (boost::bind (&OPENLDAP::Book::refresh_result, this),
-				   21);
-    } else if (patience == 1) {
+    if (result == LDAP_RES_SEARCH_ENTRY) {
 
-      patience--;
-      Ekiga::Runtime::run_in_main (boost::bind (&OPENLDAP::Book::refresh_result, this),
-				   30);
-    } else { // patience == 0
+      ContactPtr contact = parse_result (msg_entry);
+      if (contact) {
 
-      status = std::string (_("Could not search"));
-      updated (this->shared_from_this ());
+	add_contact (contact);
+	nbr_found++;
+      }
+    } else if (result == LDAP_RES_SEARCH_RESULT && search_msgid != -1) {
 
-      ldap_unbind_ext (ldap_context, NULL, NULL);
-      ldap_context = NULL;
+      search_done (msg_entry);
     }
 
-    if (msg_entry != NULL)
+    if (msg_entry != NULL) {
+
       ldap_msgfree (msg_entry);
+      msg_entry = NULL;
+    }
+  } while (result > 0 && ldap_context != NULL);
 
-    return;
+  if (search_msgid != -1 && timeout_id != 0) {
+
+    g_source_remove (timeout_id);
+    timeout_id = g_timeout_add_seconds (LDAP_TIMEOUT, ldap_timeout_cb, this);
   }
+}
 
-  msg_result = ldap_first_message (ldap_context, msg_entry);
-  do {
+void
+OPENLDAP::Book::search_done (LDAPMessage* message)
+{
+  int errcode = LDAP_SUCCESS;
+  LDAPControl** controls = NULL;
+  gchar* c_status = NULL;
+  int nbr = nbr_found;
 
-    if (ldap_msgtype (msg_result) == LDAP_RES_SEARCH_ENTRY) {
+  search_msgid = -1;
+  if (page_cookie != NULL) {
 
-      ContactPtr contact = parse_result (msg_result);
-      if (contact) {
-	add_contact (contact);
-        nbr++;
-      }
+    ber_bvfree (page_cookie);
+    page_cookie = NULL;
+  }
+
+  if (ldap_parse_result (ldap_context, message, &errcode,
+			 NULL, NULL, NULL, &controls, 0) == LDAP_SUCCESS
+      && controls != NULL) {
+
+    LDAPControl* control = ldap_control_find (LDAP_CONTROL_PAGEDRESULTS,
+					      controls, NULL);
+    if (control != NULL) {
+
+      ber_int_t count = 0;
+      struct berval cookie = { 0, NULL };
+      if (ldap_parse_pageresponse_control (ldap_context, control,
+					   &count, &cookie) == LDAP_SUCCESS
+	  && cookie.bv_val != NULL && cookie.bv_len > 0)
+	page_cookie = ber_bvdup (&cookie);
+      ber_memfree (cookie.bv_val);
     }
-    msg_result = ldap_next_message (ldap_context, msg_result);
-  } while (msg_result != NULL);
+    ldap_controls_free (controls);
+  }
 
   // Do not count ekiga.net's first entry "Search Results ... 100 entries"
   if (bookinfo.uri_host == EKIGA_NET_URI)
     nbr--;
+
+  if (page_cookie != NULL && errcode == LDAP_SUCCESS) {
+
+    /* more to come : let's ask for the next page */
+    c_status = g_strdup_printf (ngettext ("%d user found so far",
+					  "%d users found so far", nbr), nbr);
+    status = c_status;
+    g_free (c_status);
+    updated (this->shared_from_this ());
+
+    search_page ();
+    return;
+  }
+
+  if (timeout_id != 0) {
+
+    g_source_remove (timeout_id);
+    timeout_id = 0;
+  }
+
   c_status = g_strdup_printf (ngettext ("%d user found",
 					"%d users found", nbr), nbr);
   status = c_status;
   g_free (c_status);
 
   updated (this->shared_from_this ());
+}
+
+void
+OPENLDAP::Book::on_timeout ()
+{
+  timeout_id = 0;
 
-  (void)ldap_msgfree (msg_entry);
+  status = std::string (_("Could not search"));
+  updated (this->shared_from_this ());
 
-  ldap_unbind_ext (ldap_context, NULL, NULL);
-  ldap_context = NULL;
+  disconnect ();
+}
+
+void
+OPENLDAP::Book::cancel_search ()
+{
+  if (search_msgid != -1 && ldap_context != NULL)
+    ldap_abandon_ext (ldap_context, search_msgid, NULL, NULL);
+  search_msgid = -1;
+
+  if (page_cookie != NULL) {
+
+    ber_bvfree (page_cookie);
+    page_cookie = NULL;
+  }
+
+  if (timeout_id != 0) {
+
+    g_source_remove (timeout_id);
+    timeout_id = 0;
+  }
+}
+
+void
+OPENLDAP::Book::disconnect ()
+{
+  cancel_search ();
+
+  /* a connection in progress will be dropped when it comes back */
+  generation++;
+  connecting = false;
+
+  if (io_watch != 0) {
+
+    g_source_remove (io_watch);
+    io_watch = 0;
+  }
+
+  if (ldap_context != NULL) {
+
+    ldap_unbind_ext (ldap_context, NULL, NULL);
+    ldap_context = NULL;
+  }
 }
 
 void
@@ -1165,6 +1394,9 @@ OPENLDAP::Book::on_edit_form_submitted (bool submitted,
   else
     I_am_an_ekiga_net_book = false;
 
+  /* the server or the credentials may have changed */
+  disconnect ();
+
   updated (this->shared_from_this ());
   trigger_saving ();
 
@@ -129,6 +129,14 @@ namespace OPENLDAP
     /* public for access from C */
     bool on_sasl_form_submitted (bool, Ekiga::Form &, std::string &);
     Ekiga::FormBuilder *saslform;
+    void on_readable ();
+    void on_timeout ();
+
+    /* public for access from the connection thread */
+    void on_connected (unsigned int generation_,
+		       struct ldap *ld,
+		       bool initialized,
+		       int result);
 
   private:
     Book (Ekiga::ServiceCore &_core,
@@ -141,7 +149,10 @@ namespace OPENLDAP
 
     void refresh_start ();
     void refresh_bound ();
-    void refresh_result ();
+    void search_page ();
+    void search_done (struct ldapmsg *message);
+    void cancel_search ();
+    void disconnect ();
 
     ContactPtr parse_result(struct ldapmsg *);
 
@@ -164,7 +175,15 @@ namespace OPENLDAP
     struct BookInfo bookinfo;
 
     struct ldap *ldap_context;
-    unsigned int patience;
+    bool connecting;
+    unsigned int generation; // to drop the results of cancelled connections
+    guint io_watch;
+    guint timeout_id;
+
+    int search_msgid;
+    struct berval *page_cookie;
+    std::string current_filter;
+    int nbr_found;
 
     std::string status;
     std::string search_filter;
@@ -36,6 +36,7 @@
 
 #include "services.h"
 #include "contact-core.h"
+#include "ekiga-settings.h"
 
 #include "ldap-main.h"
 #include "ldap-source.h"
@@ -74,6 +75,11 @@ struct LDAPSpark: public Ekiga::Spark
   bool result;
 };
 
+/* loaded at startup when an LDAP server is configured, when idle otherwise */
+extern "C" const char* const ekiga_plugin_startup_settings[] = {
+  CONTACTS_SCHEMA, "ldap-servers", "<server", NULL };
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
@@ -54,7 +54,8 @@ OPENLDAP::Source::create (Ekiga::ServiceCore &_core)
 }
 
 OPENLDAP::Source::Source (Ekiga::ServiceCore &_core):
-  core(_core), doc(), should_add_ekiga_net_book(false)
+  core(_core), doc(), should_add_ekiga_net_book(false),
+  saving(boost::bind (&OPENLDAP::Source::save, this))
 {
   add_action (Ekiga::ActionPtr (new Ekiga::Action ("add-ldap-book", _("Add an LDAP Address Book"),
                                                    boost::bind (&OPENLDAP::Source::new_book, this))));
@@ -66,6 +67,7 @@ OPENLDAP::Source::Source (Ekiga::ServiceCore &_core):
 
 OPENLDAP::Source::~Source ()
 {
+  saving.flush ();
 }
 
 void
@@ -90,9 +92,9 @@ OPENLDAP::Source::add (struct BookInfo bookinfo)
 void
 OPENLDAP::Source::common_add (BookPtr book)
 {
-  book->trigger_saving.connect (boost::bind (&OPENLDAP::Source::save, this));
+  book->trigger_saving.connect (boost::bind (&Ekiga::WriteBehind::schedule, &saving));
   add_book (book);
-  save ();
+  saving.schedule ();
 }
 
 void
@@ -39,6 +39,7 @@
 #define __LDAP_SOURCE_H__
 
 #include "ekiga-settings.h"
+#include "write-behind.h"
 
 #include "services.h"
 #include "form.h"
@@ -103,6 +104,7 @@ namespace OPENLDAP
     gboolean should_add_ekiga_net_book;
 
     boost::shared_ptr<Ekiga::Settings> contacts_settings;
+    Ekiga::WriteBehind saving;
   };
 
 /**
@@ -71,6 +71,15 @@ on_authenticate_c (LmConnection* /*unused*/,
   account->on_authenticate (result);
 }
 
+static LmHandlerResult
+stream_features_handler_c (LmMessageHandler* /*handler*/,
+			   LmConnection* /*connection*/,
+			   LmMessage* message,
+			   LM::Account* account)
+{
+  return account->handle_stream_features (message);
+}
+
 static LmHandlerResult
 iq_handler_c (LmMessageHandler* /*handler*/,
 	      LmConnection* /*connection*/,
@@ -126,6 +135,13 @@ LM::Account::Account (boost::shared_ptr<Ekiga::PersonalDetails> details_,
 
   connection = lm_connection_new (NULL);
 
+  /* loudmouth handles the stream features at the same priority, and a
+   * handler registered later runs before : we see them before it takes them
+   */
+  LmMessageHandler* features_lm_handler = lm_message_handler_new ((LmHandleMessageFunction)stream_features_handler_c, this, NULL);
+  lm_connection_register_message_handler (connection, features_lm_handler, LM_MESSAGE_TYPE_STREAM_FEATURES, LM_HANDLER_PRIORITY_FIRST);
+  lm_message_handler_unref (features_lm_handler);
+
   LmMessageHandler* iq_lm_handler = lm_message_handler_new ((LmHandleMessageFunction)iq_handler_c, this, NULL);
   lm_connection_register_message_handler (connection, iq_lm_handler, LM_MESSAGE_TYPE_IQ, LM_HANDLER_PRIORITY_NORMAL);
   lm_message_handler_unref (iq_lm_handler);
@@ -178,6 +194,11 @@ LM::Account::Account (boost::shared_ptr<Ekiga::PersonalDetails> details_,
   }
 
   connection = lm_connection_new (NULL);
+
+  LmMessageHandler* features_lm_handler = lm_message_handler_new ((LmHandleMessageFunction)stream_features_handler_c, this, NULL);
+  lm_connection_register_message_handler (connection, features_lm_handler, LM_MESSAGE_TYPE_STREAM_FEATURES, LM_HANDLER_PRIORITY_FIRST);
+  lm_message_handler_unref (features_lm_handler);
+
   lm_connection_set_disconnect_function (connection, (LmDisconnectFunction)on_disconnected_c,
 					 this, NULL);
   if (enable_on_startup) {
@@ -194,6 +215,8 @@ LM::Account::enable ()
   unsigned port = LM_CONNECTION_DEFAULT_PORT;
   LmSSL* ssl = NULL;
 
+  features = StreamFeatures ();
+
   server = xmlGetProp (node, BAD_CAST "server");
   {
     xmlChar* port_str = xmlGetProp (node, BAD_CAST "port");
@@ -500,8 +523,8 @@ LM::Account::get_name () const
 void
 LM::Account::handle_up ()
 {
-  dialect->handle_up (connection, get_name ());
-  cluster->handle_up (connection, get_name ());
+  dialect->handle_up (connection, get_name (), features);
+  cluster->handle_up (connection, get_name (), features);
 }
 
 void
@@ -511,6 +534,21 @@ LM::Account::handle_down ()
   cluster->handle_down (connection);
 }
 
+LmHandlerResult
+LM::Account::handle_stream_features (LmMessage* message)
+{
+  /* the features after authentication replace the ones before */
+  features = StreamFeatures ();
+
+  for (LmMessageNode* child = lm_message_get_node (message)->children;
+       child != NULL;
+       child = child->next)
+    if (g_strcmp0 (lm_message_node_get_attribute (child, "xmlns"), "urn:xmpp:features:rosterver") == 0)
+      features.roster_versioning = true;
+
+  return LM_HANDLER_RESULT_ALLOW_MORE_HANDLERS;
+}
+
 LmHandlerResult
 LM::Account::handle_iq (LmMessage* message)
 {
@@ -88,6 +88,8 @@ namespace LM
 
     void on_authenticate (bool result);
 
+    LmHandlerResult handle_stream_features (LmMessage* message);
+
     /* LM::Handler-like interface
      * but not exactly, since it's the hub from which all information flows
      * to the real handlers
@@ -114,6 +116,9 @@ namespace LM
     std::string status;
 
     LmConnection* connection;
+
+    /* from the last stream features of the connection */
+    StreamFeatures features;
   };
 };
 
@@ -43,7 +43,8 @@
 LM::Bank::Bank (boost::shared_ptr<Ekiga::PersonalDetails> details_,
 		boost::shared_ptr<Dialect> dialect_,
 		boost::shared_ptr<Cluster> cluster_):
-  details(details_), cluster(cluster_), dialect(dialect_), doc (NULL)
+  details(details_), cluster(cluster_), dialect(dialect_), doc (NULL),
+  saving(boost::bind (&LM::Bank::save, this))
 {
   contacts_settings = boost::shared_ptr<Ekiga::Settings> (new Ekiga::Settings (CONTACTS_SCHEMA));
   std::string raw = contacts_settings->get_string (JABBER_KEY);
@@ -78,7 +79,7 @@ LM::Bank::Bank (boost::shared_ptr<Ekiga::PersonalDetails> details_,
 void
 LM::Bank::add (boost::shared_ptr<Account> account)
 {
-  account->trigger_saving.connect (boost::bind (&LM::Bank::save, this));
+  account->trigger_saving.connect (boost::bind (&Ekiga::WriteBehind::schedule, &saving));
   add_account (account);
 }
 
@@ -97,6 +98,7 @@ LM::Bank::save () const
 
 LM::Bank::~Bank ()
 {
+  saving.flush ();
 }
 
 bool
@@ -147,6 +149,6 @@ LM::Bank::on_new_account_form_submitted (bool submitted,
   xmlNodePtr root = xmlDocGetRootElement (doc);
   xmlAddChild (root, account->get_node ());
 
-  save ();
+  saving.schedule ();
   add (account);
 }
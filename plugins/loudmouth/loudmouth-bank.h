@@ -43,6 +43,7 @@
 #include "loudmouth-dialect.h"
 
 #include "ekiga-settings.h"
+#include "write-behind.h"
 
 namespace LM
 {
@@ -87,6 +88,8 @@ namespace LM
 
     void on_new_account_form_submitted (bool submitted,
 					Ekiga::Form& result);
+
+    Ekiga::WriteBehind saving;
   };
 
   typedef boost::shared_ptr<Bank> BankPtr;
@@ -52,11 +52,12 @@ LM::Cluster::populate_menu (Ekiga::MenuBuilder& /*builder*/)
 
 void
 LM::Cluster::handle_up (LmConnection* connection,
-			const std::string name)
+			const std::string name,
+			const StreamFeatures& features)
 {
   HeapRosterPtr heap = boost::shared_ptr<HeapRoster> (new HeapRoster (details, dialect));
   add_heap (heap);
-  heap->handle_up (connection, name);
+  heap->handle_up (connection, name, features);
 }
 
 void
@@ -149,7 +149,8 @@ LM::Dialect::on_open_group_chat_submitted (bool submitted,
 
 void
 LM::Dialect::handle_up (LmConnection* /*connection*/,
-			const std::string /*name*/)
+			const std::string /*name*/,
+			const StreamFeatures& /*features*/)
 {
   /* nothing to do afaict */
 }
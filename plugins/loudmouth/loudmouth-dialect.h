@@ -66,7 +66,8 @@ namespace LM
 
     /* LM::Handler implementation */
     void handle_up (LmConnection* connection,
-		    const std::string name);
+		    const std::string name,
+		    const StreamFeatures& features);
     void handle_down (LmConnection* connection);
     LmHandlerResult handle_iq (LmConnection* connection,
 			       LmMessage* message);
@@ -40,6 +40,17 @@
 namespace LM
 {
 
+  /* what the server advertised in the stream features, as far as the
+   * handlers are concerned
+   */
+  struct StreamFeatures
+  {
+    StreamFeatures (): roster_versioning(false)
+    {}
+
+    bool roster_versioning; // XEP-0237
+  };
+
   class Handler
   {
   public:
@@ -47,7 +58,8 @@ namespace LM
     virtual ~Handler () {}
 
     virtual void handle_up (LmConnection* connection,
-			    const std::string name) = 0;
+			    const std::string name,
+			    const StreamFeatures& features) = 0;
 
     virtual void handle_down (LmConnection* connection) = 0;
 
@@ -34,6 +34,9 @@
 
 #include <string.h>
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
+#include <libxml/tree.h>
+#include <libxml/parser.h>
 
 #include "form-request-simple.h"
 
@@ -46,6 +49,7 @@ LM::HeapRoster::HeapRoster (boost::shared_ptr<Ekiga::PersonalDetails> details_,
   details(details_), dialect(dialect_)
 {
   details_connection = details->updated.connect (boost::bind (&LM::HeapRoster::on_personal_details_updated, this));
+  presentities.object_removed.connect (boost::bind (&LM::HeapRoster::on_presentity_removed, this, _1));
 }
 
 LM::HeapRoster::~HeapRoster ()
@@ -82,15 +86,24 @@ LM::HeapRoster::populate_menu_for_group (const std::string /*group*/,
 
 void
 LM::HeapRoster::handle_up (LmConnection* connection_,
-			   const std::string name_)
+			   const std::string name_,
+			   const StreamFeatures& features)
 {
   connection = connection_;
   name = name_;
 
+  load_roster_cache ();
+
   { // populate the roster
     LmMessage* roster_request = lm_message_new_with_sub_type (NULL, LM_MESSAGE_TYPE_IQ, LM_MESSAGE_SUB_TYPE_GET);
     LmMessageNode* node = lm_message_node_add_child (lm_message_get_node (roster_request), "query", NULL);
-    lm_message_node_set_attributes (node, "xmlns", "jabber:iq:roster", NULL);
+    lm_message_node_set_attribute (node, "xmlns", "jabber:iq:roster");
+    /* XEP-0237 forbids the attribute unless the server advertised the
+     * feature ; an empty version means we support versioning but have no
+     * cache
+     */
+    if (features.roster_versioning)
+      lm_message_node_set_attribute (node, "ver", roster_version.c_str ());
     lm_connection_send_with_reply (connection, roster_request,
 				   build_message_handler (boost::bind (&LM::HeapRoster::handle_initial_roster_reply, this, _1, _2)), NULL);
     lm_message_unref (roster_request);
@@ -124,7 +137,7 @@ LM::HeapRoster::handle_iq (LmConnection* /*connection*/,
       const gchar* xmlns = lm_message_node_get_attribute (node, "xmlns");
       if (xmlns != NULL && g_strcmp0 (xmlns, "jabber:iq:roster") == 0) {
 
-	parse_roster (node);
+	parse_roster (node, false);
 	result = LM_HANDLER_RESULT_REMOVE_MESSAGE;
       }
     }
@@ -255,9 +268,15 @@ LM::HeapRoster::handle_initial_roster_reply (LmConnection* /*connection*/,
       const gchar* xmlns = lm_message_node_get_attribute (node, "xmlns");
       if (xmlns != NULL && g_strcmp0 (xmlns, "jabber:iq:roster") == 0) {
 
-	parse_roster (node);
+	parse_roster (node, true);
 	result = LM_HANDLER_RESULT_REMOVE_MESSAGE;
       }
+    } else {
+
+      /* XEP-0237: an empty result means the roster didn't change since the
+       * version we sent, so what we loaded from the cache is right
+       */
+      result = LM_HANDLER_RESULT_REMOVE_MESSAGE;
     }
   }
 
@@ -265,8 +284,11 @@ LM::HeapRoster::handle_initial_roster_reply (LmConnection* /*connection*/,
 }
 
 void
-LM::HeapRoster::parse_roster (LmMessageNode* query)
+LM::HeapRoster::parse_roster (LmMessageNode* query,
+			      bool full)
 {
+  std::set<std::string> seen;
+
   for (LmMessageNode* node = query->children; node != NULL; node = node->next) {
 
     if (g_strcmp0 (node->name, "item") != 0) {
@@ -275,26 +297,28 @@ LM::HeapRoster::parse_roster (LmMessageNode* query)
     }
 
     const gchar* jid = lm_message_node_get_attribute (node, "jid");
-    bool found = false;
-    for (iterator iter = begin (); !found && iter != end (); ++iter) {
+    const gchar* subscription = lm_message_node_get_attribute (node, "subscription");
 
-      if ((*iter)->get_jid () == jid) {
+    if (jid == NULL)
+      continue;
 
-	found = true;
-	const gchar* subscription = lm_message_node_get_attribute (node, "subscription");
-	if (subscription != NULL && g_strcmp0 (subscription, "remove") == 0) {
+    seen.insert (jid);
 
-	  (*iter)->removed ();
-	} else {
+    jid_index_type::iterator iter = jid_index.find (jid);
+    if (iter != jid_index.end ()) {
 
-	  (*iter)->update (node);
-	}
+      if (subscription != NULL && g_strcmp0 (subscription, "remove") == 0) {
+
+	iter->second->removed ();
+      } else {
+
+	iter->second->update (node);
       }
-    }
-    if ( !found) {
+    } else if (subscription == NULL || g_strcmp0 (subscription, "remove") != 0) {
 
       PresentityPtr presentity(new Presentity (connection, node));
       presentity->chat_requested.connect (boost::bind (&LM::HeapRoster::on_chat_requested, this, presentity));
+      jid_index[presentity->get_jid ()] = presentity;
       add_presentity (presentity);
       const gchar* subscription = lm_message_node_get_attribute (node, "subscription");
       if (subscription != NULL && g_strcmp0 (subscription, "none") == 0) {
@@ -326,6 +350,30 @@ LM::HeapRoster::parse_roster (LmMessageNode* query)
       }
     }
   }
+
+  if (full) {
+
+    /* what we had (from the cache) but the server doesn't know about anymore
+     * must go -- we collect first since removing updates the index
+     */
+    std::list<PresentityPtr> gone;
+    for (jid_index_type::const_iterator iter = jid_index.begin ();
+	 iter != jid_index.end ();
+	 ++iter)
+      if (seen.find (iter->first) == seen.end ())
+	gone.push_back (iter->second);
+    for (std::list<PresentityPtr>::iterator iter = gone.begin ();
+	 iter != gone.end ();
+	 ++iter)
+      (*iter)->removed ();
+  }
+
+  const gchar* ver = lm_message_node_get_attribute (query, "ver");
+  if (ver != NULL) {
+
+    roster_version = ver;
+    save_roster_cache ();
+  }
 }
 
 void
@@ -428,19 +476,164 @@ LM::PresentityPtr
 LM::HeapRoster::find_item (const std::string jid)
 {
   PresentityPtr result;
+  jid_index_type::const_iterator iter = jid_index.find (jid);
+
+  if (iter != jid_index.end ())
+    result = iter->second;
+
+  return result;
+}
 
-  for (iterator iter = begin (); iter != end (); ++iter) {
+void
+LM::HeapRoster::on_presentity_removed (PresentityPtr presentity)
+{
+  jid_index_type::iterator iter = jid_index.find (presentity->get_jid ());
 
-    if ((*iter)->get_jid () == jid) {
+  if (iter != jid_index.end () && iter->second == presentity)
+    jid_index.erase (iter);
+}
 
-      result = *iter;
-      break;
-    }
+std::string
+LM::HeapRoster::get_roster_cache_filename () const
+{
+  std::string result;
+  const gchar* jid = lm_connection_get_jid (connection);
+
+  if (jid != NULL) {
+
+    gchar* base = g_strdup_printf ("roster-%s.xml", split_jid (jid).first.c_str ());
+    g_strdelimit (base, G_DIR_SEPARATOR_S, '_');
+    gchar* filename = g_build_filename (g_get_user_cache_dir (), "ekiga", base, NULL);
+    result = filename;
+    g_free (filename);
+    g_free (base);
   }
 
   return result;
 }
 
+void
+LM::HeapRoster::load_roster_cache ()
+{
+  const std::string filename = get_roster_cache_filename ();
+
+  if (filename.empty () || !g_file_test (filename.c_str (), G_FILE_TEST_EXISTS))
+    return;
+
+  xmlDocPtr doc = xmlReadFile (filename.c_str (), NULL, XML_PARSE_NONET);
+  xmlNodePtr root = (doc != NULL) ? xmlDocGetRootElement (doc) : NULL;
+
+  if (root != NULL && xmlStrEqual (root->name, BAD_CAST "query")) {
+
+    /* we rebuild the loudmouth nodes the presentities expect from the
+     * stored xml, and then handle them as a roster push */
+    LmMessage* cached = lm_message_new_with_sub_type (NULL, LM_MESSAGE_TYPE_IQ, LM_MESSAGE_SUB_TYPE_RESULT);
+    LmMessageNode* query = lm_message_node_add_child (lm_message_get_node (cached), "query", NULL);
+    std::set<std::string> stored;
+    bool restored = true;
+
+    for (xmlNodePtr child = root->children; child != NULL; child = child->next) {
+
+      if (child->type != XML_ELEMENT_NODE
+	  || !xmlStrEqual (child->name, BAD_CAST "item"))
+	continue;
+
+      xmlChar* jid = xmlGetProp (child, BAD_CAST "jid");
+      if (jid != NULL) {
+
+	stored.insert ((const char*)jid);
+	xmlFree (jid);
+      }
+      else
+	restored = false;
+
+      LmMessageNode* item = lm_message_node_add_child (query, "item", NULL);
+      for (xmlAttrPtr attr = child->properties; attr != NULL; attr = attr->next) {
+
+	xmlChar* value = xmlGetProp (child, attr->name);
+	if (value != NULL) {
+
+	  lm_message_node_set_attribute (item, (const gchar*)attr->name, (const gchar*)value);
+	  xmlFree (value);
+	}
+      }
+      for (xmlNodePtr group = child->children; group != NULL; group = group->next) {
+
+	if (group->type != XML_ELEMENT_NODE
+	    || !xmlStrEqual (group->name, BAD_CAST "group"))
+	  continue;
+
+	xmlChar* value = xmlNodeGetContent (group);
+	lm_message_node_add_child (item, "group", (const gchar*)value);
+	xmlFree (value);
+      }
+    }
+
+    parse_roster (query, false);
+    lm_message_unref (cached);
+
+    for (std::set<std::string>::const_iterator iter = stored.begin ();
+	 iter != stored.end () && restored;
+	 ++iter)
+      restored = (jid_index.find (*iter) != jid_index.end ());
+
+    /* only trust the version if we could restore the items : otherwise
+     * the server would only send us the changes to a roster we lack */
+    xmlChar* ver = xmlGetProp (root, BAD_CAST "ver");
+    if (ver != NULL && restored)
+      roster_version = (const char*)ver;
+    else
+      roster_version.clear ();
+    if (ver != NULL)
+      xmlFree (ver);
+  }
+  else
+    roster_version.clear ();
+
+  if (doc != NULL)
+    xmlFreeDoc (doc);
+}
+
+void
+LM::HeapRoster::save_roster_cache () const
+{
+  const std::string filename = get_roster_cache_filename ();
+
+  if (filename.empty ())
+    return;
+
+  xmlDocPtr doc = xmlNewDoc (BAD_CAST "1.0");
+  xmlNodePtr root = xmlNewDocNode (doc, NULL, BAD_CAST "query", NULL);
+  xmlDocSetRootElement (doc, root);
+  xmlSetProp (root, BAD_CAST "ver", BAD_CAST roster_version.c_str ());
+
+  static const char* attributes[] = { "jid", "name", "subscription", "ask" };
+
+  for (jid_index_type::const_iterator iter = jid_index.begin ();
+       iter != jid_index.end ();
+       ++iter) {
+
+    xmlNodePtr item = xmlNewChild (root, NULL, BAD_CAST "item", NULL);
+    LmMessageNode* node = iter->second->get_item ();
+    for (unsigned int ii = 0; ii < G_N_ELEMENTS (attributes); ii++) {
+
+      const gchar* value = lm_message_node_get_attribute (node, attributes[ii]);
+      if (value != NULL)
+	xmlSetProp (item, BAD_CAST attributes[ii], BAD_CAST value);
+    }
+    for (LmMessageNode* child = node->children; child != NULL; child = child->next)
+      if (g_strcmp0 (child->name, "group") == 0 && child->value != NULL)
+	xmlNewTextChild (item, NULL, BAD_CAST "group", BAD_CAST child->value);
+  }
+
+  gchar* dirname = g_path_get_dirname (filename.c_str ());
+  g_mkdir_with_parents (dirname, 0700);
+  g_free (dirname);
+
+  xmlSaveFormatFileEnc (filename.c_str (), doc, "UTF-8", 1);
+  xmlFreeDoc (doc);
+}
+
 void
 LM::HeapRoster::on_personal_details_updated ()
 {
@@ -35,6 +35,8 @@
 #ifndef __LOUDMOUTH_HEAP_ROSTER_H__
 #define __LOUDMOUTH_HEAP_ROSTER_H__
 
+#include <boost/unordered_map.hpp>
+
 #include "heap-impl.h"
 #include "personal-details.h"
 #include "loudmouth-dialect.h"
@@ -72,7 +74,8 @@ namespace LM
 
     // implementation of the LM::Handler abstract class :
     void handle_up (LmConnection* connection,
-		    const std::string name);
+		    const std::string name,
+		    const StreamFeatures& features);
     void handle_down (LmConnection* connection);
     LmHandlerResult handle_iq (LmConnection* connection,
 			       LmMessage* message);
@@ -95,7 +98,12 @@ namespace LM
 
     LmHandlerResult handle_initial_roster_reply (LmConnection* connection,
 						 LmMessage* message);
-    void parse_roster (LmMessageNode* query);
+
+    /* when 'full' is true, the query is the whole roster, so items we know
+     * about but which aren't in it get removed ; otherwise it's a push
+     */
+    void parse_roster (LmMessageNode* query,
+		       bool full);
 
     void add_item ();
 
@@ -107,6 +115,26 @@ namespace LM
 
     PresentityPtr find_item (const std::string jid);
 
+    /* jid -> presentity index, kept in sync with the presentities store,
+     * so incoming stanzas don't need to scan the whole roster
+     */
+    typedef boost::unordered_map<std::string, PresentityPtr> jid_index_type;
+    jid_index_type jid_index;
+
+    void on_presentity_removed (PresentityPtr presentity);
+
+    /* XEP-0237 roster versioning : we keep the last roster we got on disk,
+     * with its version, so that on reconnection the server only needs to
+     * send us what changed since then
+     */
+    std::string roster_version;
+
+    std::string get_roster_cache_filename () const;
+
+    void load_roster_cache ();
+
+    void save_roster_cache () const;
+
     void on_personal_details_updated ();
 
     void on_chat_requested (PresentityPtr presentity);
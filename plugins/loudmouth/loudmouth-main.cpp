@@ -39,6 +39,7 @@
 #include "account-core.h"
 #include "chat-core.h"
 #include "personal-details.h"
+#include "ekiga-settings.h"
 
 #include "loudmouth-cluster.h"
 #include "loudmouth-bank.h"
@@ -83,6 +84,11 @@ struct LOUDMOUTHSpark: public Ekiga::Spark
   bool result;
 };
 
+/* loaded at startup when a jabber account is configured, when idle otherwise */
+extern "C" const char* const ekiga_plugin_startup_settings[] = {
+  CONTACTS_SCHEMA, "jabber", "<entry", NULL };
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
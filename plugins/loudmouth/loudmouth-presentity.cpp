@@ -212,6 +212,12 @@ LM::Presentity::get_connection () const
   return connection;
 }
 
+LmMessageNode*
+LM::Presentity::get_item () const
+{
+  return item;
+}
+
 void
 LM::Presentity::update (LmMessageNode* item_)
 {
@@ -39,6 +39,7 @@
 #include "presence-core.h"
 #include "xcap-core.h"
 #include "rl-cluster.h"
+#include "ekiga-settings.h"
 
 struct RLSpark: public Ekiga::Spark
 {
@@ -73,6 +74,13 @@ struct RLSpark: public Ekiga::Spark
   bool result;
 };
 
+extern "C" const char* const ekiga_plugin_requires[] = { "xcap-core", "presence-core", NULL };
+
+/* loaded at startup when a resource list is configured, when idle otherwise */
+extern "C" const char* const ekiga_plugin_startup_settings[] = {
+  CONTACTS_SCHEMA, "resource-lists", "<entry", NULL };
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
@@ -46,7 +46,8 @@
 
 #define RL_KEY "resource-lists"
 
-RL::Cluster::Cluster (Ekiga::ServiceCore& core_): core(core_), doc()
+RL::Cluster::Cluster (Ekiga::ServiceCore& core_): core(core_), doc(),
+  saving(boost::bind (&RL::Cluster::save, this))
 {
   boost::shared_ptr<Ekiga::PresenceCore> presence_core = core.get<Ekiga::PresenceCore> ("presence-core");
 
@@ -88,6 +89,7 @@ RL::Cluster::Cluster (Ekiga::ServiceCore& core_): core(core_), doc()
 
 RL::Cluster::~Cluster ()
 {
+  saving.flush ();
 }
 
 bool
@@ -120,7 +122,7 @@ RL::Cluster::add (const std::string uri,
 
   xmlAddChild (root, heap->get_node ());
 
-  save ();
+  saving.schedule ();
   common_add (heap);
 }
 
@@ -131,7 +133,7 @@ RL::Cluster::common_add (HeapPtr heap)
 
   // FIXME: here we should ask for presence for the heap...
 
-  heap->trigger_saving.connect (boost::bind (&RL::Cluster::save, this));
+  heap->trigger_saving.connect (boost::bind (&Ekiga::WriteBehind::schedule, &saving));
 }
 
 void
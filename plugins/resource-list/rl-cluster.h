@@ -41,6 +41,7 @@
 
 #include "rl-heap.h"
 #include "ekiga-settings.h"
+#include "write-behind.h"
 
 namespace RL {
 
@@ -94,6 +95,7 @@ namespace RL {
                            std::string presence);
 
     boost::shared_ptr<Ekiga::Settings> contacts_settings;
+    Ekiga::WriteBehind saving;
   };
 
   typedef boost::shared_ptr<Cluster> ClusterPtr;
@@ -184,11 +184,10 @@ RL::Heap::visit_presentities (boost::function1<bool, Ekiga::PresentityPtr > visi
 {
   bool go_on = true;
 
-  for (std::map<PresentityPtr,std::list<boost::signals2::connection> >::const_iterator
-	 iter = presentities.begin ();
+  for (presentities_type::const_iterator iter = presentities.begin ();
        go_on && iter != presentities.end ();
        ++iter)
-    go_on = visitor (iter->first);
+    go_on = visitor (iter->second.first);
 }
 
 bool
@@ -250,19 +249,9 @@ RL::Heap::refresh ()
   path->set_credentials (username_str, password_str);
   path = path->build_child ("resource-lists");
 
-  while ( !presentities.empty ()) {
-
-    presentities.begin()->first->removed ();
-    for (std::list<boost::signals2::connection>::const_iterator iter2
-	   = presentities.begin()->second.begin ();
-	 iter2 != presentities.begin()->second.end ();
-	 ++iter2)
-      iter2->disconnect ();
-    presentities.erase (presentities.begin()->first);
-  }
-
-  doc.reset ();
-
+  /* we keep the current presentities around : parse_list will diff the new
+   * document against them
+   */
   xcap->read (path, boost::bind (&RL::Heap::on_document_received, this, _1, _2));
 }
 
@@ -273,6 +262,7 @@ RL::Heap::on_document_received (bool error,
   if (error) {
 
     // FIXME: do something
+    // (at least we keep the presentities we already had)
     std::cout << "XCAP error: " << value << std::endl;
   } else {
 
@@ -295,6 +285,9 @@ RL::Heap::parse_doc (std::string raw)
     std::cout << "Invalid document in " << __PRETTY_FUNCTION__ << std::endl;
     // FIXME: warn the user somehow?
     doc.reset ();
+    list_node = NULL;
+    while ( !presentities.empty ())
+      remove_presentity (presentities.begin ());
   } else {
 
 
@@ -357,6 +350,8 @@ RL::Heap::parse_list (xmlNodePtr list)
   path = path->build_child ("resource-lists");
   path = path->build_child ("list");
 
+  std::set<std::string> seen;
+
   for (xmlNodePtr child = list->children;
        child != NULL;
        child = child->next)
@@ -364,44 +359,84 @@ RL::Heap::parse_list (xmlNodePtr list)
 	&& child->name != NULL
 	&& xmlStrEqual (BAD_CAST ("entry"), child->name)) {
 
-      PresentityPtr presentity(new Presentity (services, path, doc, child, writable));
-      std::list<boost::signals2::connection> conns;
-      conns.push_back (presentity->updated.connect (boost::bind (boost::ref (presentity_updated), presentity)));
-      conns.push_back (presentity->removed.connect (boost::bind(boost::ref (presentity_removed),presentity)));
-      conns.push_back (presentity->trigger_reload.connect (boost::bind (&RL::Heap::refresh, this)));
-      conns.push_back (presentity->questions.connect (boost::ref (questions)));
-      presentities[presentity]=conns;
-      presentity_added (presentity);
-      continue;
+      std::string uri;
+      xmlChar* str = xmlGetProp (child, BAD_CAST "uri");
+      if (str != NULL) {
+
+	uri = (const char*)str;
+	xmlFree (str);
+      }
+
+      if ( !seen.insert (uri).second)
+	continue; // the same uri twice in a list makes no sense
+
+      presentities_type::iterator iter = presentities.find (uri);
+      if (iter != presentities.end ())
+	iter->second.first->update_node (path, doc, child, writable);
+      else
+	add_presentity (path, child, writable);
     }
+
+  presentities_type::iterator iter = presentities.begin ();
+  while (iter != presentities.end ()) {
+
+    if (seen.find (iter->first) == seen.end ())
+      remove_presentity (iter++);
+    else
+      ++iter;
+  }
+}
+
+void
+RL::Heap::add_presentity (boost::shared_ptr<XCAP::Path> path,
+			  xmlNodePtr child,
+			  bool writable)
+{
+  PresentityPtr presentity(new Presentity (services, path, doc, child, writable));
+  std::list<boost::signals2::connection> conns;
+  conns.push_back (presentity->updated.connect (boost::bind (boost::ref (presentity_updated), presentity)));
+  conns.push_back (presentity->removed.connect (boost::bind(boost::ref (presentity_removed),presentity)));
+  conns.push_back (presentity->trigger_reload.connect (boost::bind (&RL::Heap::refresh, this)));
+  conns.push_back (presentity->questions.connect (boost::ref (questions)));
+  presentities[presentity->get_uri ()] = presentity_info (presentity, conns);
+  presentity_added (presentity);
+}
+
+void
+RL::Heap::remove_presentity (presentities_type::iterator iter)
+{
+  boost::shared_ptr<Ekiga::PresenceCore> presence_core = services.get<Ekiga::PresenceCore> ("presence-core");
+  PresentityPtr presentity = iter->second.first;
+
+  presentity->removed ();
+  for (std::list<boost::signals2::connection>::const_iterator iter2
+	 = iter->second.second.begin ();
+       iter2 != iter->second.second.end ();
+       ++iter2)
+    iter2->disconnect ();
+  presentities.erase (iter);
+
+  presence_core->unfetch_presence (presentity->get_uri ());
 }
 
 void
 RL::Heap::push_presence (const std::string uri_,
 			 const std::string presence)
 {
-  for (std::map<PresentityPtr,std::list<boost::signals2::connection> >::const_iterator
-	 iter = presentities.begin ();
-       iter != presentities.end ();
-       ++iter) {
+  presentities_type::const_iterator iter = presentities.find (uri_);
 
-    if (iter->first->get_uri () == uri_)
-      iter->first->set_presence (presence);
-  }
+  if (iter != presentities.end ())
+    iter->second.first->set_presence (presence);
 }
 
 void
 RL::Heap::push_note (const std::string uri_,
 		       const std::string note)
 {
-  for (std::map<PresentityPtr,std::list<boost::signals2::connection> >::const_iterator
-	 iter = presentities.begin ();
-       iter != presentities.end ();
-       ++iter) {
+  presentities_type::const_iterator iter = presentities.find (uri_);
 
-    if (iter->first->get_uri () == uri_)
-      iter->first->set_note (note);
-  }
+  if (iter != presentities.end ())
+    iter->second.first->set_note (note);
 }
 
 void
@@ -516,12 +551,11 @@ RL::Heap::new_entry ()
 			   "contact on a remote server"));
 
   std::set<std::string> all_groups;
-  for (std::map<PresentityPtr,std::list<boost::signals2::connection> >::const_iterator
-	 iter = presentities.begin ();
+  for (presentities_type::const_iterator iter = presentities.begin ();
        iter != presentities.end ();
        ++iter) {
 
-    std::set<std::string> groups = iter->first->get_groups ();
+    std::set<std::string> groups = iter->second.first->get_groups ();
     all_groups.insert (groups.begin (), groups.end ());
   }
 
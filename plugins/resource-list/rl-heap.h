@@ -105,7 +105,19 @@ namespace RL {
     boost::shared_ptr<xmlDoc> doc;
     xmlNodePtr list_node;
 
-    std::map<PresentityPtr, std::list<boost::signals2::connection> > presentities;
+    /* indexed by uri, so a refreshed document can be diffed against what we
+     * already know : unchanged entries keep their presentity (and their
+     * presence subscription) alive
+     */
+    typedef std::pair<PresentityPtr, std::list<boost::signals2::connection> > presentity_info;
+    typedef std::map<std::string, presentity_info> presentities_type;
+    presentities_type presentities;
+
+    void add_presentity (boost::shared_ptr<XCAP::Path> path,
+			 xmlNodePtr child,
+			 bool writable);
+
+    void remove_presentity (presentities_type::iterator iter);
 
     void refresh ();
 
@@ -63,10 +63,26 @@ RL::Presentity::Presentity (Ekiga::ServiceCore &services_,
   name_node(NULL), presence("unknown"), note("")
 {
   boost::shared_ptr<Ekiga::PresenceCore> presence_core(services.get<Ekiga::PresenceCore> ("presence-core"));
+
+  parse_node (path_);
+
+  presence_core->fetch_presence (uri);
+}
+
+RL::Presentity::~Presentity ()
+{
+}
+
+void
+RL::Presentity::parse_node (boost::shared_ptr<XCAP::Path> path_)
+{
   xmlChar *xml_str = NULL;
   xmlNsPtr ns = xmlSearchNsByHref (doc.get (), node,
                                    BAD_CAST "http://www.ekiga.org");
 
+  name_node = NULL;
+  group_nodes.clear ();
+
   if (ns == NULL) {
 
     // FIXME: we should handle the case, even if it shouldn't happen
@@ -110,17 +126,34 @@ RL::Presentity::Presentity (Ekiga::ServiceCore &services_,
     }
   }
 
+  groups.clear ();
   for (std::map<std::string, xmlNodePtr>::const_iterator iter
          = group_nodes.begin ();
        iter != group_nodes.end ();
        iter++)
     groups.insert (iter->first);
-
-  presence_core->fetch_presence (uri);
 }
 
-RL::Presentity::~Presentity ()
+void
+RL::Presentity::update_node (boost::shared_ptr<XCAP::Path> path_,
+			     boost::shared_ptr<xmlDoc> doc_,
+			     xmlNodePtr node_,
+			     bool writable_)
 {
+  const std::string old_name = get_name ();
+  const std::set<std::string> old_groups = groups;
+  const bool old_writable = writable;
+
+  doc = doc_;
+  node = node_;
+  writable = writable_;
+
+  parse_node (path_);
+
+  if (old_name != get_name ()
+      || old_groups != groups
+      || old_writable != writable)
+    updated ();
 }
 
 
@@ -257,11 +290,12 @@ RL::Presentity::edit_presentity_form_submitted (bool submitted,
 
   robust_xmlNodeSetContent (node, &name_node, "name", new_name);
 
+  /* the heap will notice the old uri is gone from the document on reload,
+   * and will take care of unfetching its presence
+   */
   if (uri != new_uri) {
 
-    xmlSetProp (node, (const xmlChar*)"uri", (const xmlChar*)uri.c_str ());
-    boost::shared_ptr<Ekiga::PresenceCore> presence_core(services.get<Ekiga::PresenceCore> ("presence-core"));
-    presence_core->unfetch_presence (uri);
+    xmlSetProp (node, (const xmlChar*)"uri", (const xmlChar*)new_uri.c_str ());
     reload = true;
   }
 
@@ -321,10 +355,13 @@ RL::Presentity::remove ()
 {
   xmlUnlinkNode (node);
   xmlFreeNode (node);
-  boost::shared_ptr<Ekiga::PresenceCore> presence_core = services.get<Ekiga::PresenceCore> ("presence-core");
-
-  presence_core->unfetch_presence (uri);
+  node = NULL;
+  name_node = NULL;
+  group_nodes.clear ();
 
+  /* the presence will be unfetched by the heap when the reloaded document
+   * doesn't have us anymore
+   */
   boost::shared_ptr<XCAP::Core> xcap = services.get<XCAP::Core> ("xcap-core");
   xcap->erase (path,
                boost::bind (&RL::Presentity::erase_result, this, _1));
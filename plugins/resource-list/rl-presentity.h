@@ -78,10 +78,21 @@ namespace RL
 
     bool populate_menu (Ekiga::MenuBuilder &);
 
+    /* rebinds the presentity to the entry node of a freshly downloaded
+     * document -- emits 'updated' only if something visible changed, and
+     * keeps the presence subscription untouched
+     */
+    void update_node (boost::shared_ptr<XCAP::Path> path_,
+		      boost::shared_ptr<xmlDoc> doc_,
+		      xmlNodePtr node_,
+		      bool writable_);
+
     boost::signals2::signal<void(void)> trigger_reload;
 
   private:
 
+    void parse_node (boost::shared_ptr<XCAP::Path> path_);
+
     void edit_presentity ();
 
     bool edit_presentity_form_submitted (bool submitted,
@@ -69,6 +69,10 @@ struct XCAPSpark: public Ekiga::Spark
 };
 
 
+/* only the resource lists need it */
+extern "C" const char* const ekiga_plugin_provides[] = { "xcap-core", NULL };
+extern "C" const int ekiga_plugin_lazy = 1;
+
 extern "C" void
 ekiga_plugin_init (Ekiga::KickStart& kickstart)
 {
@@ -0,0 +1,264 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         ekiga-sound-bundler.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : packs the sound events into the bundle Ekiga
+ *                          maps at startup
+ *
+ */
+
+/* Usage: ekiga-sound-bundler OUTPUT DIRECTORY FILE...
+ *
+ * Reads each PCM WAV file (8 or 16 bits, mono or stereo) from DIRECTORY,
+ * mixes it down to mono and converts it to each of the rates Ekiga plays
+ * its sounds at, with the resampler of the conference mixer, then writes
+ * them all to OUTPUT in the format of sound-bundle-format.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "audio-kernels.h"
+#include "sound-bundle-format.h"
+
+using namespace Ekiga;
+
+namespace
+{
+  const unsigned rates[] = { 48000, 16000 };
+
+  struct Sound
+  {
+    std::string name;
+    unsigned rate;
+    std::vector<short> samples;
+  };
+
+  unsigned
+  get_le16 (const unsigned char* p)
+  {
+    return p[0] | (p[1] << 8);
+  }
+
+  unsigned
+  get_le32 (const unsigned char* p)
+  {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned) p[3] << 24);
+  }
+
+  bool
+  read_file (const std::string & path,
+             std::vector<unsigned char> & contents)
+  {
+    FILE* file = fopen (path.c_str (), "rb");
+    unsigned char block[4096];
+    size_t n;
+
+    if (file == NULL)
+      return false;
+
+    while ((n = fread (block, 1, sizeof (block), file)) > 0)
+      contents.insert (contents.end (), block, block + n);
+
+    bool ok = !ferror (file);
+    fclose (file);
+
+    return ok;
+  }
+
+  /* mono, 16 bits, at the rate of the file */
+  bool
+  read_wav (const std::string & path,
+            std::vector<short> & samples,
+            unsigned & rate)
+  {
+    std::vector<unsigned char> wav;
+    unsigned channels = 0;
+    unsigned bits = 0;
+    const unsigned char* data = NULL;
+    size_t data_size = 0;
+
+    if (!read_file (path, wav) || wav.size () < 12
+        || memcmp (&wav[0], "RIFF", 4) || memcmp (&wav[8], "WAVE", 4)) {
+
+      fprintf (stderr, "%s: not a WAV file\n", path.c_str ());
+      return false;
+    }
+
+    for (size_t pos = 12; pos + 8 <= wav.size (); ) {
+
+      const unsigned char* chunk = &wav[pos];
+      size_t size = std::min ((size_t) get_le32 (chunk + 4), wav.size () - pos - 8);
+
+      if (!memcmp (chunk, "fmt ", 4) && size >= 16) {
+
+        if (get_le16 (chunk + 8) != 1) {
+
+          fprintf (stderr, "%s: not PCM\n", path.c_str ());
+          return false;
+        }
+        channels = get_le16 (chunk + 10);
+        rate = get_le32 (chunk + 12);
+        bits = get_le16 (chunk + 22);
+      }
+      else if (!memcmp (chunk, "data", 4)) {
+
+        data = chunk + 8;
+        data_size = size;
+      }
+      pos += 8 + size + (size & 1);
+    }
+
+    if (data == NULL || (channels != 1 && channels != 2) || (bits != 8 && bits != 16) || rate == 0) {
+
+      fprintf (stderr, "%s: unsupported WAV format (%u channels, %u bits)\n", path.c_str (), channels, bits);
+      return false;
+    }
+
+    const unsigned frame_size = channels * bits / 8;
+    for (size_t i = 0; i + frame_size <= data_size; i += frame_size) {
+
+      int sum = 0;
+      for (unsigned c = 0; c < channels; c++)
+        if (bits == 16)
+          sum += (short) get_le16 (data + i + 2 * c);
+        else
+          sum += (data[i + c] - 128) << 8;
+      samples.push_back ((short) (sum / (int) channels));
+    }
+
+    return true;
+  }
+
+  bool
+  write_bundle (const std::string & path,
+                const std::vector<Sound> & sounds)
+  {
+    SoundBundleHeader header;
+    std::vector<SoundBundleEntry> entries (sounds.size ());
+    uint32_t offset = sizeof (header) + entries.size () * sizeof (SoundBundleEntry);
+    static const char padding[SOUND_BUNDLE_ALIGNMENT] = { 0 };
+
+    memcpy (header.magic, SOUND_BUNDLE_MAGIC, sizeof (header.magic));
+    header.byte_order = SOUND_BUNDLE_BYTE_ORDER;
+    header.count = sounds.size ();
+
+    for (size_t i = 0; i < sounds.size (); i++) {
+
+      offset = (offset + SOUND_BUNDLE_ALIGNMENT - 1) / SOUND_BUNDLE_ALIGNMENT * SOUND_BUNDLE_ALIGNMENT;
+
+      memset (&entries[i], 0, sizeof (SoundBundleEntry));
+      strncpy (entries[i].name, sounds[i].name.c_str (), SOUND_BUNDLE_NAME_SIZE - 1);
+      entries[i].rate = sounds[i].rate;
+      entries[i].samples = sounds[i].samples.size ();
+      entries[i].offset = offset;
+
+      offset += sounds[i].samples.size () * sizeof (short);
+    }
+
+    FILE* file = fopen (path.c_str (), "wb");
+    if (file == NULL) {
+
+      perror (path.c_str ());
+      return false;
+    }
+
+    size_t written = fwrite (&header, sizeof (header), 1, file);
+    written += fwrite (&entries[0], sizeof (SoundBundleEntry), entries.size (), file);
+    long position = sizeof (header) + entries.size () * sizeof (SoundBundleEntry);
+
+    for (size_t i = 0; i < sounds.size (); i++) {
+
+      fwrite (padding, 1, entries[i].offset - position, file);
+      written += fwrite (&sounds[i].samples[0], sizeof (short), sounds[i].samples.size (), file);
+      position = entries[i].offset + sounds[i].samples.size () * sizeof (short);
+    }
+
+    bool ok = (fclose (file) == 0);
+    size_t expected = 1 + entries.size ();
+    for (size_t i = 0; i < sounds.size (); i++)
+      expected += sounds[i].samples.size ();
+
+    if (!ok || written != expected) {
+
+      fprintf (stderr, "%s: write error\n", path.c_str ());
+      remove (path.c_str ());
+      return false;
+    }
+
+    return true;
+  }
+};
+
+int
+main (int argc,
+      char* argv[])
+{
+  std::vector<Sound> sounds;
+
+  if (argc < 4) {
+
+    fprintf (stderr, "Usage: %s OUTPUT DIRECTORY FILE...\n", argv[0]);
+    return 1;
+  }
+
+  for (int arg = 3; arg < argc; arg++) {
+
+    std::vector<short> samples;
+    unsigned rate = 0;
+
+    if (strlen (argv[arg]) >= SOUND_BUNDLE_NAME_SIZE) {
+
+      fprintf (stderr, "%s: name too long\n", argv[arg]);
+      return 1;
+    }
+
+    if (!read_wav (std::string (argv[2]) + "/" + argv[arg], samples, rate) || samples.empty ())
+      return 1;
+
+    for (unsigned r = 0; r < sizeof (rates) / sizeof (rates[0]); r++) {
+
+      AudioKernels::Resampler resampler (rate, rates[r]);
+      Sound sound;
+
+      sound.name = argv[arg];
+      sound.rate = rates[r];
+      resampler.process (&samples[0], samples.size (), sound.samples);
+      sounds.push_back (sound);
+
+      printf ("%s: %u Hz -> %u Hz, %u samples\n", argv[arg], rate, rates[r], (unsigned) sound.samples.size ());
+    }
+  }
+
+  return write_bundle (argv[1], sounds) ? 0 : 1;
+}
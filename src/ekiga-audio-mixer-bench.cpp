@@ -0,0 +1,262 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         ekiga-audio-mixer-bench.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : checks the conference mixer and reports how
+ *                          many calls it can bridge
+ *
+ */
+
+/* Usage: ekiga-audio-mixer-bench [seconds]
+ *   default: 60 seconds of conference.
+ *
+ * First checks that the SIMD mixing kernels give exactly what the plain
+ * ones give, that every leg hears the others but not itself, and that a
+ * sound survives going through the rate conversions. Then it runs
+ * bridges of 2 to 32 legs, with codecs at 8 to 48 kHz, the way the media
+ * threads use them (each leg says and hears a period for each mix), and
+ * prints how much of one core each needs, at every level the processor
+ * supports. The exit status is 1 if any check fails.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <glib.h>
+
+#include "audio-mixer.h"
+
+using namespace Ekiga;
+
+namespace
+{
+  const char* level_names[] = { "scalar", "sse2", "avx2" };
+
+  /* the usual codec rates, which the legs take in turn */
+  const unsigned leg_rates[] = { 8000, 16000, 48000, 8000, 16000, 32000, 44100, 48000 };
+
+  bool
+  check_kernels ()
+  {
+    const unsigned n = 997;
+    std::vector<int> sum (n);
+    std::vector<short> samples (n);
+    std::vector<int> reference_sum;
+    std::vector<short> result (n);
+    std::vector<short> reference;
+    bool ok = true;
+
+    for (unsigned level = AudioKernels::Scalar; level <= (unsigned) AudioKernels::get_best_level (); level++) {
+
+      /* the same sums each time, large enough to saturate */
+      srand (1);
+      for (unsigned i = 0; i < n; i++) {
+
+        sum[i] = (rand () % 262144) - 131072;
+        samples[i] = rand ();
+      }
+
+      AudioKernels::set_level ((AudioKernels::Level) level);
+      AudioKernels::accumulate (&sum[0], &samples[0], n);
+      AudioKernels::minus_one (&sum[0], &samples[0], &result[0], n);
+
+      if (level == AudioKernels::Scalar) {
+
+        reference_sum = sum;
+        reference = result;
+      }
+      else if (sum != reference_sum || result != reference) {
+
+        fprintf (stderr, "The mixing kernels differ at level %s\n", level_names[level]);
+        ok = false;
+      }
+    }
+    AudioKernels::set_level (AudioKernels::get_best_level ());
+
+    return ok;
+  }
+
+  bool
+  check_minus_one ()
+  {
+    const short says[] = { 1000, 2000, 4000, -30000 };
+    const short hears[] = { -24000, -25000, -27000, 7000 };
+    AudioMixer mixer (16000, 20);
+    std::vector<AudioMixer::LegId> legs;
+    std::vector<short> samples (mixer.get_period_size ());
+    bool ok = true;
+
+    for (unsigned i = 0; i < 4; i++)
+      legs.push_back (mixer.add_leg ());
+
+    for (unsigned i = 0; i < 4; i++) {
+
+      std::fill (samples.begin (), samples.end (), says[i]);
+      mixer.put (legs[i], &samples[0], samples.size (), mixer.get_rate (), false);
+    }
+    mixer.mix ();
+
+    for (unsigned i = 0; i < 4; i++) {
+
+      mixer.get (legs[i], &samples[0], samples.size (), mixer.get_rate (), false);
+      for (unsigned j = 0; j < samples.size (); j++)
+        if (samples[j] != hears[i]) {
+
+          fprintf (stderr, "Leg %u hears %d instead of %d\n", i, samples[j], hears[i]);
+          ok = false;
+          break;
+        }
+    }
+
+    return ok;
+  }
+
+  double
+  rms (const std::vector<short> & samples,
+       unsigned start)
+  {
+    double total = 0;
+
+    for (unsigned i = start; i < samples.size (); i++)
+      total += (double) samples[i] * samples[i];
+
+    return sqrt (total / (samples.size () - start));
+  }
+
+  /* a 440 Hz tone from an 8 kHz leg, heard by a 44.1 kHz one, and back */
+  bool
+  check_rates ()
+  {
+    AudioKernels::Resampler up (8000, 44100);
+    AudioKernels::Resampler down (44100, 8000);
+    std::vector<short> tone;
+    std::vector<short> high;
+    std::vector<short> back;
+
+    for (unsigned i = 0; i < 8000; i++)
+      tone.push_back ((short) (10000 * sin (2 * M_PI * 440 * i / 8000)));
+
+    /* by odd pieces, to check the state carried between them */
+    for (unsigned i = 0; i < tone.size (); i += 157)
+      up.process (&tone[i], std::min (157u, (unsigned) tone.size () - i), high);
+    for (unsigned i = 0; i < high.size (); i += 331)
+      down.process (&high[i], std::min (331u, (unsigned) high.size () - i), back);
+
+    double ratio = rms (back, 100) / rms (tone, 100);
+    long length = (long) back.size () - (long) tone.size ();
+
+    if (labs ((long) high.size () - 44100) > 2 || labs (length) > 2 || ratio < 0.9 || ratio > 1.02) {
+
+      fprintf (stderr, "Rate conversion: %u samples up, %u back, level %.3f\n",
+               (unsigned) high.size (), (unsigned) back.size (), ratio);
+      return false;
+    }
+
+    return true;
+  }
+
+  /* microseconds of work per period of conference */
+  double
+  run_bridge (unsigned leg_count,
+              unsigned periods)
+  {
+    AudioMixer mixer (48000, 20);
+    std::vector<AudioMixer::LegId> legs;
+    std::vector<std::vector<short> > sounds;
+    std::vector<short> heard (48000 / 50);
+
+    for (unsigned i = 0; i < leg_count; i++) {
+
+      unsigned rate = leg_rates[i % G_N_ELEMENTS (leg_rates)];
+      std::vector<short> sound (rate / 50);
+
+      for (unsigned j = 0; j < sound.size (); j++)
+        sound[j] = (short) (3000 * sin (2 * M_PI * (200 + 100 * i) * j / rate));
+      sounds.push_back (sound);
+      legs.push_back (mixer.add_leg ());
+    }
+
+    gint64 start = g_get_monotonic_time ();
+    for (unsigned p = 0; p < periods; p++) {
+
+      for (unsigned i = 0; i < leg_count; i++)
+        mixer.put (legs[i], &sounds[i][0], sounds[i].size (), leg_rates[i % G_N_ELEMENTS (leg_rates)], false);
+
+      mixer.mix ();
+
+      for (unsigned i = 0; i < leg_count; i++)
+        mixer.get (legs[i], &heard[0], sounds[i].size (), leg_rates[i % G_N_ELEMENTS (leg_rates)], false);
+    }
+
+    return (double) (g_get_monotonic_time () - start) / periods;
+  }
+};
+
+int
+main (int argc,
+      char* argv[])
+{
+  const unsigned seconds = (argc > 1) ? atoi (argv[1]) : 60;
+  const unsigned leg_counts[] = { 2, 3, 4, 8, 16, 32 };
+  bool ok = true;
+
+  if (seconds == 0) {
+
+    fprintf (stderr, "Usage: %s [seconds]\n", argv[0]);
+    return 1;
+  }
+
+  ok = check_kernels () && ok;
+  ok = check_minus_one () && ok;
+  ok = check_rates () && ok;
+
+  printf ("%u s of conference, mixed at 48 kHz by periods of 20 ms\n"
+          "(microseconds per period, and the share of one core)\n", seconds);
+
+  for (unsigned c = 0; c < G_N_ELEMENTS (leg_counts); c++) {
+
+    printf ("  %2u legs", leg_counts[c]);
+
+    for (unsigned level = AudioKernels::Scalar; level <= (unsigned) AudioKernels::get_best_level (); level++) {
+
+      AudioKernels::set_level ((AudioKernels::Level) level);
+      double elapsed = run_bridge (leg_counts[c], seconds * 50);
+      printf ("  %6s %7.1f %5.2f%%", level_names[level], elapsed, elapsed / 200.0);
+    }
+    printf ("\n");
+  }
+
+  if (!ok)
+    fprintf (stderr, "The conference mixer failed its checks!\n");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,424 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+/*
+ *                         ekiga-call-bench.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : places calls between two headless engines
+ *                          on the loopback, and reports how it went
+ *
+ */
+
+/* Usage: ekiga-call-bench [calls [hold-seconds [port]]]
+ *   defaults: 4 calls, held 10 seconds, the caller listening on port 5070
+ *   and the callee on the next one.
+ *
+ * The callee is a forked copy of the same binary, answering automatically.
+ * Both use the memory GSettings backend, so the user settings are neither
+ * read nor touched; the schemas must be findable (GSETTINGS_SCHEMA_DIR when
+ * running from the build tree). No sound or video hardware is needed.
+ *
+ * Reported: call setup latency, CPU per established call, memory growth of
+ * the caller and the RTCP round trip time of the audio. The exit status is
+ * non-zero when some call could not be established or cleared.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include "engine.h"
+#include "runtime.h"
+#include "call-core.h"
+#include "scoped-connections.h"
+#include "ekiga-settings.h"
+
+/* seconds */
+#define WARMUP_DELAY 3
+#define SETUP_TIMEOUT 30
+#define CLEAR_TIMEOUT 10
+
+struct Bench
+{
+  Bench (): core(NULL), calls(4), hold(10), port(5070),
+    ended(0), holding(false), stopping(false), done(false),
+    cpu_hold(0), rss_before(0), rss_established(0), rss_after(0)
+  {}
+
+  Ekiga::ServiceCore* core;
+
+  unsigned calls;
+  unsigned hold;
+  unsigned port;
+
+  std::map<std::string, gint64> dialed;   // uri -> time of the dial
+  std::map<std::string, gint64> started;  // call id -> time of the dial
+  std::list<boost::shared_ptr<Ekiga::Call> > active;
+  unsigned ended;
+
+  bool holding;
+  bool stopping;
+  bool done;
+
+  std::vector<double> setup_latencies; // ms
+  std::vector<int> round_trips;        // ms
+  double cpu_hold;                     // s
+  long rss_before;                     // kB
+  long rss_established;
+  long rss_after;
+};
+
+static double
+cpu_seconds (int who)
+{
+  struct rusage usage;
+
+  if (getrusage (who, &usage) != 0)
+    return 0;
+
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+    + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+/* resident set size in kB, 0 if unknown */
+static long
+resident_size ()
+{
+  long result = 0;
+  char line[128];
+  FILE* status = fopen ("/proc/self/status", "r");
+
+  if (status == NULL)
+    return 0;
+
+  while (fgets (line, sizeof (line), status) != NULL)
+    if (strncmp (line, "VmRSS:", 6) == 0)
+      result = strtol (line + 6, NULL, 10);
+
+  fclose (status);
+  return result;
+}
+
+template<typename T>
+static T
+percentile (std::vector<T> values,
+            unsigned p)
+{
+  if (values.empty ())
+    return T ();
+
+  std::sort (values.begin (), values.end ());
+  return values[std::min ((size_t) (values.size () * p / 100), values.size () - 1)];
+}
+
+static void
+configure (unsigned port,
+           bool answer)
+{
+  Ekiga::Settings sip (SIP_SCHEMA);
+  Ekiga::Settings call_options (CALL_OPTIONS_SCHEMA);
+  Ekiga::Settings nat (NAT_SCHEMA);
+
+  sip.set_int ("listen-port", port);
+  call_options.set_bool ("auto-answer", answer);
+  nat.set_bool ("enable-stun", false);
+}
+
+static void finish (Bench* bench);
+
+static gboolean
+on_clear_timeout (gpointer data)
+{
+  finish ((Bench*) data);
+  return FALSE;
+}
+
+static void
+stop_calls (Bench* bench)
+{
+  if (bench->stopping)
+    return;
+  bench->stopping = true;
+
+  bench->cpu_hold = cpu_seconds (RUSAGE_SELF) - bench->cpu_hold;
+
+  std::list<boost::shared_ptr<Ekiga::Call> > calls = bench->active;
+  for (std::list<boost::shared_ptr<Ekiga::Call> >::iterator iter = calls.begin ();
+       iter != calls.end ();
+       ++iter)
+    (*iter)->hang_up ();
+
+  g_timeout_add_seconds (CLEAR_TIMEOUT, on_clear_timeout, bench);
+  if (bench->ended == bench->calls)
+    finish (bench);
+}
+
+static gboolean
+on_hold_sample (gpointer data)
+{
+  Bench* bench = (Bench*) data;
+
+  if (bench->stopping)
+    return FALSE;
+
+  for (std::list<boost::shared_ptr<Ekiga::Call> >::iterator iter = bench->active.begin ();
+       iter != bench->active.end ();
+       ++iter) {
+
+    int rtt = (*iter)->get_statistics ().round_trip_time;
+    if (rtt > 0)
+      bench->round_trips.push_back (rtt);
+  }
+
+  return TRUE;
+}
+
+static gboolean
+on_hold_over (gpointer data)
+{
+  stop_calls ((Bench*) data);
+  return FALSE;
+}
+
+static void
+start_hold (Bench* bench)
+{
+  if (bench->holding)
+    return;
+  bench->holding = true;
+
+  bench->rss_established = resident_size ();
+  bench->cpu_hold = cpu_seconds (RUSAGE_SELF);
+
+  g_timeout_add_seconds (1, on_hold_sample, bench);
+  g_timeout_add_seconds (bench->hold, on_hold_over, bench);
+}
+
+static gboolean
+on_setup_timeout (gpointer data)
+{
+  start_hold ((Bench*) data);
+  return FALSE;
+}
+
+static gboolean
+start_calls (gpointer data)
+{
+  Bench* bench = (Bench*) data;
+  boost::shared_ptr<Ekiga::CallCore> call_core = bench->core->get<Ekiga::CallCore> ("call-core");
+
+  bench->rss_before = resident_size ();
+
+  for (unsigned ii = 0; ii < bench->calls; ii++) {
+
+    gchar* uri = g_strdup_printf ("sip:bench-%u@127.0.0.1:%u", ii, bench->port + 1);
+    bench->dialed[uri] = g_get_monotonic_time ();
+    if (!call_core->dial (uri))
+      bench->ended++;
+    g_free (uri);
+  }
+
+  g_timeout_add_seconds (SETUP_TIMEOUT, on_setup_timeout, bench);
+
+  return FALSE;
+}
+
+static void
+on_setup_call (Bench* bench,
+               boost::shared_ptr<Ekiga::Call> call)
+{
+  std::map<std::string, gint64>::iterator iter = bench->dialed.find (call->get_remote_uri ());
+
+  /* the uri could have been rewritten: then take the oldest dial */
+  if (iter == bench->dialed.end ())
+    iter = bench->dialed.begin ();
+  if (iter == bench->dialed.end ())
+    return;
+
+  bench->started[call->get_id ()] = iter->second;
+  bench->dialed.erase (iter);
+}
+
+static void
+on_established_call (Bench* bench,
+                     boost::shared_ptr<Ekiga::Call> call)
+{
+  std::map<std::string, gint64>::iterator iter = bench->started.find (call->get_id ());
+
+  if (iter != bench->started.end ())
+    bench->setup_latencies.push_back ((g_get_monotonic_time () - iter->second) / 1000.0);
+
+  bench->active.push_back (call);
+  if (bench->active.size () == bench->calls)
+    start_hold (bench);
+}
+
+static void
+on_ended_call (Bench* bench,
+               boost::shared_ptr<Ekiga::Call> call)
+{
+  bench->active.remove (call);
+  bench->ended++;
+
+  if (bench->ended == bench->calls) {
+
+    if (bench->stopping)
+      finish (bench);
+    else
+      stop_calls (bench); // they all failed: no need to wait
+  }
+}
+
+static void
+finish (Bench* bench)
+{
+  if (bench->done)
+    return;
+  bench->done = true;
+
+  bench->rss_after = resident_size ();
+  Ekiga::Runtime::quit ();
+}
+
+static void
+report (const Bench& bench,
+        double callee_cpu)
+{
+  unsigned established = bench.setup_latencies.size ();
+
+  printf ("calls placed:           %u\n", bench.calls);
+  printf ("calls established:      %u\n", established);
+  printf ("setup latency (ms):     p50 %.1f  p95 %.1f  max %.1f\n",
+          percentile (bench.setup_latencies, 50),
+          percentile (bench.setup_latencies, 95),
+          percentile (bench.setup_latencies, 100));
+  if (established > 0 && bench.hold > 0)
+    printf ("caller CPU per call:    %.2f%% of a core\n",
+            100.0 * bench.cpu_hold / bench.hold / established);
+  printf ("callee CPU, whole run:  %.2f s\n", callee_cpu);
+  printf ("caller RSS (kB):        before %ld  established %ld (+%ld)  after %ld (+%ld)\n",
+          bench.rss_before,
+          bench.rss_established, bench.rss_established - bench.rss_before,
+          bench.rss_after, bench.rss_after - bench.rss_before);
+  printf ("media round trip (ms):  p50 %d  p95 %d  (%u samples)\n",
+          percentile (bench.round_trips, 50),
+          percentile (bench.round_trips, 95),
+          (unsigned) bench.round_trips.size ());
+}
+
+static void
+run_engine (Ekiga::ServiceCore& core,
+            char* program)
+{
+  char* args[] = { program, NULL };
+
+  Ekiga::Runtime::init ();
+  engine_init (core, 1, args, true);
+}
+
+int
+main (int argc,
+      char* argv[])
+{
+  Bench bench;
+
+  if (argc > 1)
+    bench.calls = atoi (argv[1]);
+  if (argc > 2)
+    bench.hold = atoi (argv[2]);
+  if (argc > 3)
+    bench.port = atoi (argv[3]);
+
+  if (bench.calls == 0 || bench.port == 0) {
+
+    fprintf (stderr, "Usage: %s [calls [hold-seconds [port]]]\n", argv[0]);
+    return 1;
+  }
+
+  g_setenv ("GSETTINGS_BACKEND", "memory", TRUE);
+
+  /* the engine is a singleton per process: the callee gets its own */
+  pid_t callee = fork ();
+  if (callee < 0) {
+
+    perror ("fork");
+    return 1;
+  }
+
+  if (callee == 0) {
+
+    Ekiga::ServiceCore core;
+
+    configure (bench.port + 1, true);
+    run_engine (core, argv[0]);
+    Ekiga::Runtime::run (); // until the caller kills us
+    return 0;
+  }
+
+  double callee_cpu = 0;
+  {
+    Ekiga::ServiceCore core;
+    Ekiga::scoped_connections conns;
+
+    configure (bench.port, false);
+    run_engine (core, argv[0]);
+    bench.core = &core;
+
+    boost::shared_ptr<Ekiga::CallCore> call_core = core.get<Ekiga::CallCore> ("call-core");
+    conns.add (call_core->setup_call.connect (boost::bind (&on_setup_call, &bench, _1)));
+    conns.add (call_core->established_call.connect (boost::bind (&on_established_call, &bench, _1)));
+    conns.add (call_core->cleared_call.connect (boost::bind (&on_ended_call, &bench, _1)));
+    conns.add (call_core->missed_call.connect (boost::bind (&on_ended_call, &bench, _1)));
+
+    g_timeout_add_seconds (WARMUP_DELAY, start_calls, &bench);
+    Ekiga::Runtime::run ();
+
+    kill (callee, SIGTERM);
+    waitpid (callee, NULL, 0);
+    callee_cpu = cpu_seconds (RUSAGE_CHILDREN);
+
+    bench.active.clear ();
+    engine_close (core);
+  }
+
+  report (bench, callee_cpu);
+
+  return (bench.setup_latencies.size () == bench.calls && bench.ended == bench.calls) ? 0 : 1;
+}
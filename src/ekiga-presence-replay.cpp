@@ -0,0 +1,303 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         ekiga-presence-replay.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : replays a recorded burst of presence list
+ *                          notifications through the Opal presence rules
+ *
+ */
+
+/* Usage: ekiga-presence-replay burst.xml [rounds]
+ *        ekiga-presence-replay --generate contacts > burst.xml
+ *   where the burst is the bodies of the NOTIFYs a presence list
+ *   subscription got, saved one after the other from a capture : each part
+ *   starts with its own "<?xml" declaration. By default, 100 rounds.
+ *   The second form writes a made up burst for that many contacts.
+ *
+ * Every part goes through what Opal::Account does with it : it is parsed,
+ * the states are mapped with the rank tables, and the uris are looked up
+ * in the roster by their index key. The roster is made of the uris of the
+ * burst. For comparison, a tenth of the lookups also walk the roster,
+ * which is what the account did before it had an index (it even reparsed
+ * the XML node of each presentity, so the walk here is a lower bound).
+ *
+ * The exit status is non-zero if the burst can't be read, if the rank
+ * tables aren't sorted (classify_presence stops at the first match), or
+ * if a uri written differently doesn't get the same index key.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+#include <glib.h>
+
+#include "opal-presence-rules.h"
+
+static void
+generate (unsigned contacts)
+{
+  srand (1);
+
+  for (unsigned i = 0; i < contacts; i++) {
+
+    const unsigned kind = rand () % 4;
+
+    printf ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<presence xmlns=\"urn:ietf:params:xml:ns:pidf\""
+            " xmlns:dm=\"urn:ietf:params:xml:ns:pidf:data-model\""
+            " xmlns:rpid=\"urn:ietf:params:xml:ns:pidf:rpid\""
+            " entity=\"sip:user%u@example.org\">\n"
+            "<tuple id=\"t%u\"><status><basic>%s</basic></status></tuple>\n",
+            i, i, kind == 0 ? "closed" : "open");
+
+    if (kind == 2) {
+
+      printf ("<dm:person id=\"p%u\"><rpid:activities>", i);
+      for (unsigned n = 1 + rand () % 3; n > 0; n--)
+        printf ("<rpid:%s/>", Opal::activity_rules[rand () % Opal::activity_rules_size].keyword);
+      printf ("</rpid:activities></dm:person>\n");
+    }
+    else if (kind == 3)
+      printf ("<dm:person id=\"p%u\"><dm:note>%s</dm:note></dm:person>\n",
+              i, Opal::note_rules[rand () % Opal::note_rules_size].keyword);
+
+    printf ("</presence>\n");
+  }
+
+  /* the list meta-information, with a few resources the server gave up on */
+  printf ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<list xmlns=\"urn:ietf:params:xml:ns:rlmi\" uri=\"sip:buddies@example.org\""
+          " version=\"1\" fullState=\"true\">\n");
+  for (unsigned i = 0; i < contacts; i++)
+    printf ("<resource uri=\"sip:user%u@example.org\"><instance id=\"i%u\" state=\"%s\"/></resource>\n",
+            i, i, i % 10 == 9 ? "terminated" : "active");
+  printf ("</list>\n");
+}
+
+static std::vector<std::string>
+split_parts (const std::string & burst)
+{
+  std::vector<std::string> result;
+  size_t start = burst.find ("<?xml");
+
+  while (start != std::string::npos) {
+
+    const size_t end = burst.find ("<?xml", start + 1);
+    result.push_back (burst.substr (start, end == std::string::npos ? end : end - start));
+    start = end;
+  }
+
+  return result;
+}
+
+static bool
+check_ranks (const char* name,
+             const Opal::PresenceRule* rules,
+             unsigned size)
+{
+  for (unsigned i = 1; i < size; i++)
+    if (rules[i].rank < rules[i - 1].rank) {
+
+      fprintf (stderr, "The %s rules aren't sorted: \"%s\" comes after \"%s\"!\n",
+               name, rules[i].keyword, rules[i - 1].keyword);
+      return false;
+    }
+
+  return true;
+}
+
+/* the ways a server or a user may write the same uri */
+static bool
+check_key (const std::string & uri)
+{
+  const std::string key = Opal::index_key (uri);
+  std::vector<std::string> variants;
+
+  variants.push_back (key);
+  variants.push_back (uri + ";transport=tcp");
+  if (!uri.compare (0, 4, "sip:"))
+    variants.push_back ("pres:" + uri.substr (4));
+  const size_t at = uri.find ("@");
+  if (at != std::string::npos) {
+
+    std::string upper = uri;
+    for (size_t i = 0; i < upper.length (); i++)
+      if (i < uri.find (":") || i > at)
+        upper[i] = g_ascii_toupper (upper[i]);
+    variants.push_back (upper);
+  }
+
+  for (size_t i = 0; i < variants.size (); i++)
+    if (Opal::index_key (variants[i]) != key) {
+
+      fprintf (stderr, "\"%s\" and \"%s\" have different index keys!\n",
+               uri.c_str (), variants[i].c_str ());
+      return false;
+    }
+
+  return true;
+}
+
+int
+main (int argc,
+      char** argv)
+{
+  boost::unordered_map<std::string, unsigned> roster;
+  std::vector<std::string> roster_uris;
+  std::map<std::string, unsigned> states;
+  unsigned rounds = 100;
+  unsigned updates = 0;
+  unsigned found = 0;
+  unsigned walked = 0;
+  unsigned walk_found = 0;
+  gint64 parse_time = 0;
+  gint64 index_time = 0;
+  gint64 walk_time = 0;
+  bool ok = true;
+
+  if (argc == 3 && std::string (argv[1]) == "--generate") {
+
+    generate (atoi (argv[2]));
+    return 0;
+  }
+
+  if (argc < 2 || argc > 3) {
+
+    fprintf (stderr,
+             "Usage: %s burst.xml [rounds]\n"
+             "       %s --generate contacts > burst.xml\n", argv[0], argv[0]);
+    return 1;
+  }
+
+  if (argc > 2)
+    rounds = atoi (argv[2]);
+  if (rounds == 0)
+    rounds = 1;
+
+  std::ifstream file (argv[1]);
+  if (!file) {
+
+    perror (argv[1]);
+    return 1;
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf ();
+
+  const std::vector<std::string> parts = split_parts (contents.str ());
+  if (parts.empty ()) {
+
+    fprintf (stderr, "%s: no notification in there\n", argv[1]);
+    return 1;
+  }
+
+  ok = check_ranks ("note", Opal::note_rules, Opal::note_rules_size) && ok;
+  ok = check_ranks ("activity", Opal::activity_rules, Opal::activity_rules_size) && ok;
+
+  /* the roster is what the burst is about */
+  for (size_t i = 0; i < parts.size (); i++) {
+
+    std::list<Opal::PresenceUpdate> list;
+    Opal::parse_presence_notification (parts[i], list);
+    for (std::list<Opal::PresenceUpdate>::const_iterator iter = list.begin ();
+         iter != list.end ();
+         ++iter)
+      if (roster.insert (std::make_pair (Opal::index_key (iter->uri), roster_uris.size ())).second) {
+
+        roster_uris.push_back (iter->uri);
+        ok = check_key (iter->uri) && ok;
+      }
+  }
+
+  for (unsigned round = 0; round < rounds; round++) {
+
+    for (size_t i = 0; i < parts.size (); i++) {
+
+      std::list<Opal::PresenceUpdate> list;
+
+      gint64 start = g_get_monotonic_time ();
+      Opal::parse_presence_notification (parts[i], list);
+      parse_time += g_get_monotonic_time () - start;
+
+      for (std::list<Opal::PresenceUpdate>::const_iterator iter = list.begin ();
+           iter != list.end ();
+           ++iter) {
+
+        start = g_get_monotonic_time ();
+        if (roster.find (Opal::index_key (iter->uri)) != roster.end ())
+          found++;
+        index_time += g_get_monotonic_time () - start;
+
+        if (updates % 10 == 0) {
+
+          start = g_get_monotonic_time ();
+          for (size_t n = 0; n < roster_uris.size (); n++)
+            if (roster_uris[n] == iter->uri) {
+
+              walk_found++;
+              break;
+            }
+          walk_time += g_get_monotonic_time () - start;
+          walked++;
+        }
+
+        if (round == 0)
+          states[iter->presence]++;
+        updates++;
+      }
+    }
+  }
+
+  printf ("%lu parts, %lu contacts, %u rounds\n",
+          (unsigned long) parts.size (), (unsigned long) roster_uris.size (), rounds);
+  printf ("\nstates in the burst:\n");
+  for (std::map<std::string, unsigned>::const_iterator iter = states.begin ();
+       iter != states.end ();
+       ++iter)
+    printf ("  %-10s %u\n", iter->first.c_str (), iter->second);
+
+  printf ("\nparse and map: %8.2f us per part\n",
+          (double) parse_time / (parts.size () * rounds));
+  if (updates > 0)
+    printf ("index lookup:  %8.2f us per update (%u of %u found)\n",
+            (double) index_time / updates, found, updates);
+  if (walked > 0)
+    printf ("roster walk:   %8.2f us per update (%u of %u found)\n",
+            (double) walk_time / walked, walk_found, walked);
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         ekiga-rate-replay.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : replays a recorded call quality trace through
+ *                          the video rate controller
+ *
+ */
+
+/* Usage: ekiga-rate-replay trace.csv [bitrate [fps [width height]]]
+ *   where the trace is a call quality export (running ekiga with
+ *   EKIGA_CALL_QUALITY_DIR set writes one per call), and the rest is the
+ *   configured video: by default 256 kbit/s, 30 fps, 640x480.
+ *
+ * Every sample is shown with the loss and round trip time the remote
+ * reported, and what the controller asked the encoder for. The exit
+ * status is non-zero if the trace can't be read, or if the controller
+ * ever went over the configured video or under its floor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "video-rate-controller.h"
+
+static std::vector<std::string>
+split (const std::string & line)
+{
+  std::vector<std::string> result;
+  std::istringstream stream (line);
+  std::string field;
+
+  while (std::getline (stream, field, ','))
+    result.push_back (field);
+
+  return result;
+}
+
+static int
+field (const std::vector<std::string> & fields,
+       const std::map<std::string, size_t> & columns,
+       const std::string name,
+       int fallback)
+{
+  std::map<std::string, size_t>::const_iterator iter = columns.find (name);
+
+  if (iter == columns.end () || iter->second >= fields.size ())
+    return fallback;
+
+  return atoi (fields[iter->second].c_str ());
+}
+
+int
+main (int argc,
+      char** argv)
+{
+  Ekiga::VideoRateSettings ceiling;
+  Ekiga::VideoRateController controller;
+  std::map<std::string, size_t> columns;
+  std::string line;
+  unsigned samples = 0;
+  unsigned changes = 0;
+  unsigned lowest = 0;
+  double sum = 0;
+  bool ok = true;
+
+  if (argc < 2 || argc == 5 || argc > 6) {
+
+    fprintf (stderr, "Usage: %s trace.csv [bitrate [fps [width height]]]\n", argv[0]);
+    return 1;
+  }
+
+  ceiling.bitrate = (argc > 2) ? atoi (argv[2]) : 256;
+  ceiling.frame_rate = (argc > 3) ? atoi (argv[3]) : 30;
+  ceiling.width = (argc > 5) ? atoi (argv[4]) : 640;
+  ceiling.height = (argc > 5) ? atoi (argv[5]) : 480;
+  if (ceiling.bitrate == 0 || ceiling.frame_rate == 0) {
+
+    fprintf (stderr, "%s: the bitrate and frame rate can't be zero\n", argv[0]);
+    return 1;
+  }
+
+  std::ifstream trace (argv[1]);
+  if (!trace || !std::getline (trace, line)) {
+
+    perror (argv[1]);
+    return 1;
+  }
+
+  std::vector<std::string> header = split (line);
+  for (size_t i = 0; i < header.size (); i++)
+    columns[header[i]] = i;
+  if (columns.find ("remote_lost_packets") == columns.end ()) {
+
+    fprintf (stderr, "%s: not a call quality export\n", argv[1]);
+    return 1;
+  }
+
+  controller.reset (ceiling);
+  lowest = ceiling.bitrate;
+
+  printf ("offset  loss  rtt   rate  target   fps  size\n");
+  while (std::getline (trace, line)) {
+
+    std::vector<std::string> fields = split (line);
+    RTCPStatistics stats;
+
+    stats.jitter = field (fields, columns, "jitter", -1);
+    stats.remote_jitter = field (fields, columns, "remote_jitter", -1);
+    stats.lost_packets = field (fields, columns, "lost_packets", 0);
+    stats.remote_lost_packets = field (fields, columns, "remote_lost_packets", 0);
+    stats.round_trip_time = field (fields, columns, "round_trip_time", -1);
+    stats.transmitted_video_bandwidth = field (fields, columns, "transmitted_video_bandwidth", 0);
+
+    if (controller.update (stats))
+      changes++;
+
+    const Ekiga::VideoRateSettings & target = controller.get_target ();
+    printf ("%6d  %3u%%  %4d  %5u  %6u  %4u  %ux%u\n",
+            field (fields, columns, "offset", samples), stats.remote_lost_packets,
+            stats.round_trip_time, controller.get_rate (), target.bitrate,
+            target.frame_rate, target.width, target.height);
+
+    if (target.bitrate > ceiling.bitrate || target.frame_rate > ceiling.frame_rate
+        || target.width > ceiling.width || target.height > ceiling.height
+        || target.bitrate == 0 || target.frame_rate == 0) {
+
+      fprintf (stderr, "The controller went out of bounds at sample %u!\n", samples);
+      ok = false;
+    }
+
+    samples++;
+    sum += target.bitrate;
+    if (target.bitrate < lowest)
+      lowest = target.bitrate;
+  }
+
+  if (samples == 0) {
+
+    fprintf (stderr, "%s: no samples\n", argv[1]);
+    return 1;
+  }
+
+  printf ("\n%u samples, %u changes of the encoder settings\n", samples, changes);
+  printf ("target bitrate: mean %.0f kbit/s, lowest %u kbit/s, last %u kbit/s\n",
+          sum / samples, lowest, controller.get_target ().bitrate);
+
+  return ok ? 0 : 1;
+}
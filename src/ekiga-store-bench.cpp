@@ -0,0 +1,211 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         ekiga-store-bench.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : churns objects through an Ekiga::DynamicObjectStore
+ *                          and reports how long it took
+ *
+ */
+
+/* Usage: ekiga-store-bench [objects [rounds]]
+ *   defaults: 10000 objects, 10 rounds.
+ *
+ * Each round adds the objects (each with an extra connection, as the heaps
+ * do), looks every one of them up by key, removes half of them through
+ * their removed signal, adds them back, then empties the store. For
+ * comparison, a tenth of the lookups are also done by walking the store,
+ * which is what the plugins did before the store had a key index.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <glib.h>
+
+#include "dynamic-object.h"
+#include "dynamic-object-store.h"
+
+namespace
+{
+  class Item: public Ekiga::DynamicObject<Item>
+  {
+  public:
+
+    Item (const std::string uri_): uri(uri_)
+    {}
+
+    const std::string get_uri () const
+    { return uri; }
+
+    boost::signals2::signal<void(void)> questions;
+
+  private:
+
+    std::string uri;
+  };
+
+  typedef boost::shared_ptr<Item> ItemPtr;
+
+  void
+  on_question ()
+  {
+  }
+
+  std::string
+  item_key (ItemPtr item)
+  {
+    return item->get_uri ();
+  }
+
+  struct find_by_walk
+  {
+    find_by_walk (const std::string uri_): uri(uri_)
+    {}
+
+    bool operator() (ItemPtr item)
+    {
+      if (item->get_uri () == uri)
+        result = item;
+
+      return !result;
+    }
+
+    std::string uri;
+    ItemPtr result;
+  };
+
+  struct Timings
+  {
+    Timings (): add(0), lookup(0), walk(0), remove(0), clear(0)
+    {}
+
+    gint64 add;
+    gint64 lookup;
+    gint64 walk;
+    gint64 remove;
+    gint64 clear;
+  };
+
+  void
+  add_all (Ekiga::DynamicObjectStore<Item>& store,
+           const std::vector<ItemPtr>& items)
+  {
+    for (std::vector<ItemPtr>::const_iterator iter = items.begin ();
+         iter != items.end ();
+         ++iter) {
+
+      store.add_object (*iter);
+      store.add_connection (*iter, (*iter)->questions.connect (&on_question));
+    }
+  }
+
+  bool
+  run_round (const std::vector<ItemPtr>& items,
+             Timings& timings)
+  {
+    Ekiga::DynamicObjectStore<Item> store;
+    gint64 start;
+    unsigned found = 0;
+
+    store.set_key (&item_key);
+
+    start = g_get_monotonic_time ();
+    add_all (store, items);
+    timings.add += g_get_monotonic_time () - start;
+
+    start = g_get_monotonic_time ();
+    for (std::vector<ItemPtr>::const_iterator iter = items.begin ();
+         iter != items.end ();
+         ++iter)
+      if (store.find_by_key ((*iter)->get_uri ()) == *iter)
+        found++;
+    timings.lookup += g_get_monotonic_time () - start;
+
+    start = g_get_monotonic_time ();
+    for (size_t i = 0; i < items.size (); i += 10) {
+
+      find_by_walk helper(items[i]->get_uri ());
+      store.visit_objects (boost::ref (helper));
+    }
+    timings.walk += g_get_monotonic_time () - start;
+
+    start = g_get_monotonic_time ();
+    for (size_t i = 0; i < items.size (); i += 2)
+      items[i]->removed (items[i]);
+    add_all (store, items);
+    timings.remove += g_get_monotonic_time () - start;
+
+    start = g_get_monotonic_time ();
+    store.remove_all_objects ();
+    timings.clear += g_get_monotonic_time () - start;
+
+    return found == items.size () && store.size () == 0;
+  }
+};
+
+int
+main (int argc,
+      char* argv[])
+{
+  const unsigned objects = (argc > 1) ? atoi (argv[1]) : 10000;
+  const unsigned rounds = (argc > 2) ? atoi (argv[2]) : 10;
+  std::vector<ItemPtr> items;
+  Timings timings;
+  bool ok = true;
+
+  if (objects == 0 || rounds == 0) {
+
+    fprintf (stderr, "Usage: %s [objects [rounds]]\n", argv[0]);
+    return 1;
+  }
+
+  for (unsigned i = 0; i < objects; i++) {
+
+    gchar* uri = g_strdup_printf ("sip:contact%u@example.org", i);
+    items.push_back (ItemPtr (new Item (uri)));
+    g_free (uri);
+  }
+
+  for (unsigned i = 0; i < rounds; i++)
+    ok = run_round (items, timings) && ok;
+
+  printf ("%u objects, %u rounds (microseconds per object)\n", objects, rounds);
+  printf ("  add with a connection    %8.3f\n", (double) timings.add / (objects * rounds));
+  printf ("  lookup by key            %8.3f\n", (double) timings.lookup / (objects * rounds));
+  printf ("  lookup by walking        %8.3f\n", (double) timings.walk / ((objects + 9) / 10 * rounds));
+  printf ("  remove half, add back    %8.3f\n", (double) timings.remove / (objects * rounds));
+  printf ("  remove all               %8.3f\n", (double) timings.clear / (objects * rounds));
+
+  if (!ok)
+    fprintf (stderr, "The store lost track of some objects!\n");
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+
+/*
+ *                         ekiga-trace-analyser.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : reads a dump of the trace ring, and shows
+ *                          what happened, call by call
+ *
+ */
+
+/* Usage: ekiga-trace-analyser dump-file
+ *   where the dump comes from running ekiga with EKIGA_TRACE_FILE=dump-file,
+ *   then sending it SIGUSR1 (or from a crash).
+ *
+ * The events are grouped by call (or SIP dialog, or device), in the order
+ * they first appeared, with their time since the beginning of the dump and
+ * since the previous event of the group. The SIP messages of a call are
+ * grouped with it, through the Call-ID its events mapped its token to.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "trace-ring.h"
+
+static const char*
+event_name (uint16_t event)
+{
+  static const char* names[] = {
+    "?",
+    "call setup",
+    "call alerting",
+    "call established",
+    "call cleared",
+    "media opened",
+    "media closed",
+    "SIP received",
+    "device opened",
+    "device closed",
+    "device error",
+    "SIP sent",
+    "Call-ID"
+  };
+
+  if (event < Ekiga::TraceEventCount)
+    return names[event];
+
+  return names[0];
+}
+
+/* The records of a thread are in order, but those of different threads
+ * can have taken their sequence numbers and their timestamps in different
+ * orders
+ */
+struct EarlierRecord
+{
+  EarlierRecord (const std::vector<Ekiga::TraceRecord>& _records): records(_records)
+  {}
+
+  bool operator() (size_t a,
+                   size_t b) const
+  { return records[a].timestamp < records[b].timestamp; }
+
+  const std::vector<Ekiga::TraceRecord>& records;
+};
+
+static void
+describe (const Ekiga::TraceRecord& rec,
+          std::string& result)
+{
+  char buffer[128];
+
+  switch (rec.event) {
+
+  case Ekiga::TraceCallSetUp:
+    snprintf (buffer, sizeof (buffer), "%s %s", rec.value ? "to" : "from", rec.text);
+    break;
+  case Ekiga::TraceCallCleared:
+    snprintf (buffer, sizeof (buffer), "%s (reason %lld)", rec.text, (long long) rec.value);
+    break;
+  case Ekiga::TraceMediaOpened:
+  case Ekiga::TraceMediaClosed:
+    snprintf (buffer, sizeof (buffer), "%s %s", rec.text, rec.value ? "(sending)" : "(receiving)");
+    break;
+  case Ekiga::TraceSipReceived:
+    snprintf (buffer, sizeof (buffer), "<-- %s", rec.text);
+    break;
+  case Ekiga::TraceSipSent:
+    snprintf (buffer, sizeof (buffer), "--> %s", rec.text);
+    break;
+  case Ekiga::TraceDeviceError:
+    snprintf (buffer, sizeof (buffer), "%s (error %lld)", rec.text, (long long) rec.value);
+    break;
+  default:
+    snprintf (buffer, sizeof (buffer), "%s", rec.text);
+  }
+
+  result = buffer;
+}
+
+int
+main (int argc,
+      char** argv)
+{
+  FILE* file = NULL;
+  Ekiga::TraceHeader header;
+  std::vector<Ekiga::TraceRecord> records;
+  std::vector<std::string> order;
+  std::map<std::string, std::vector<size_t> > groups;
+  std::map<std::string, std::string> call_ids;  // Call-ID -> call token
+
+  if (argc != 2) {
+
+    fprintf (stderr, "Usage: %s dump-file\n", argv[0]);
+    return 1;
+  }
+
+  file = fopen (argv[1], "rb");
+  if (file == NULL) {
+
+    perror (argv[1]);
+    return 1;
+  }
+
+  if (fread (&header, sizeof (header), 1, file) != 1
+      || memcmp (header.magic, EKIGA_TRACE_MAGIC, sizeof (header.magic)) != 0
+      || header.record_size != sizeof (Ekiga::TraceRecord)) {
+
+    fprintf (stderr, "%s: not a trace dump from this version of ekiga\n", argv[1]);
+    fclose (file);
+    return 1;
+  }
+
+  // the dump can be shorter than announced, if ekiga was busy writing
+  Ekiga::TraceRecord rec;
+  while (records.size () < header.count && fread (&rec, sizeof (rec), 1, file) == 1) {
+
+    rec.id[sizeof (rec.id) - 1] = '\0';
+    rec.text[sizeof (rec.text) - 1] = '\0';
+    records.push_back (rec);
+  }
+  fclose (file);
+
+  if (records.empty ()) {
+
+    printf ("No event recorded.\n");
+    return 0;
+  }
+
+  for (size_t ii = 0; ii < records.size (); ii++)
+    if (records[ii].event == Ekiga::TraceCallIdMapped)
+      call_ids[records[ii].text] = records[ii].id;
+
+  uint64_t start = records[0].timestamp;
+  uint64_t end = records[0].timestamp;
+  for (size_t ii = 0; ii < records.size (); ii++) {
+
+    std::string id = records[ii].id;
+    std::map<std::string, std::string>::const_iterator call = call_ids.find (id);
+    if (call != call_ids.end ())
+      id = call->second;
+
+    if (groups.find (id) == groups.end ())
+      order.push_back (id);
+    groups[id].push_back (ii);
+    start = std::min (start, records[ii].timestamp);
+    end = std::max (end, records[ii].timestamp);
+  }
+
+  printf ("%lu events over %.3f s\n", (unsigned long) records.size (),
+          (end - start) / 1000000.0);
+
+  for (std::vector<std::string>::const_iterator iter = order.begin ();
+       iter != order.end ();
+       ++iter) {
+
+    std::vector<size_t>& group = groups[*iter];
+    std::stable_sort (group.begin (), group.end (), EarlierRecord (records));
+    uint64_t previous = records[group[0]].timestamp;
+
+    printf ("\n======================== %s\n", iter->empty () ? "(none)" : iter->c_str ());
+    for (std::vector<size_t>::const_iterator it = group.begin ();
+         it != group.end ();
+         ++it) {
+
+      const Ekiga::TraceRecord& current = records[*it];
+      std::string description;
+
+      describe (current, description);
+      printf ("%12.3f ms %+10.3f ms  [%04x]  %-16s %s\n",
+              (current.timestamp - start) / 1000.0,
+              (int64_t) (current.timestamp - previous) / 1000.0,
+              current.thread,
+              event_name (current.event),
+              description.c_str ());
+      previous = current.timestamp;
+    }
+  }
+
+  return 0;
+}
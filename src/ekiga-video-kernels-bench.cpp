@@ -0,0 +1,198 @@
+/*
+ * Ekiga -- A VoIP and Video-Conferencing application
+ * Copyright (C) 2000-2009 Damien Sandras <dsandras@seconix.com>
+
+ * This program is free software; you can  redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version. This program is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Ekiga is licensed under the GPL license and as a special exception, you
+ * have permission to link or otherwise combine this program with the
+ * programs OPAL, OpenH323 and PWLIB, and distribute the combination, without
+ * applying the requirements of the GNU GPL to the OPAL, OpenH323 and PWLIB
+ * programs, as long as you do follow the requirements of the GNU GPL for all
+ * the rest of the software thus combined.
+ */
+
+
+/*
+ *                         ekiga-video-kernels-bench.cpp  -  description
+ *                         ------------------------------------------
+ *   begin                : written in 2026
+ *   copyright            : (c) 2026 by the Ekiga developers
+ *   description          : checks the SIMD video kernels against the plain
+ *                          ones and reports how long they take
+ *
+ */
+
+/* Usage: ekiga-video-kernels-bench [rounds]
+ *   default: 50 rounds.
+ *
+ * For each picture size (an odd one, to exercise the line tails, then 720p
+ * and 1080p), every kernel is run at every level the processor supports,
+ * on the same random pictures ; the results must be byte for byte those of
+ * the plain version, and the time per picture is printed for each level.
+ * The exit status is 1 if any result differs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <glib.h>
+
+#include "video-kernels.h"
+
+using namespace Ekiga::VideoKernels;
+
+namespace
+{
+  const char* level_names[] = { "scalar", "sse2", "avx2" };
+
+  enum Kernel {
+
+    Blend,
+    Mirror,
+    Halve,
+    Scale,
+    ToRgba,
+    KernelCount
+  };
+
+  const char* kernel_names[] = {
+    "blend (quarter inset)", "mirror", "halve", "scale (to 2/3)", "to_rgba"
+  };
+
+  struct Pictures
+  {
+    Pictures (unsigned width_,
+              unsigned height_): width(width_), height(height_),
+      source(width * height * 3 / 2), inset((width / 2) * (height / 2) * 3 / 2),
+      result(width * height * 4)
+    {
+      for (size_t i = 0; i < source.size (); i++)
+        source[i] = rand ();
+      for (size_t i = 0; i < inset.size (); i++)
+        inset[i] = rand ();
+    }
+
+    unsigned width;
+    unsigned height;
+    std::vector<char> source;
+    std::vector<char> inset;
+    std::vector<char> result;
+  };
+
+  /* runs the kernel once, leaving what it produced in pictures.result */
+  void
+  run (Kernel kernel,
+       Pictures & pictures)
+  {
+    ConstI420 source (&pictures.source[0], pictures.width, pictures.height);
+
+    switch (kernel) {
+
+    case Blend: {
+      I420 result (&pictures.result[0], pictures.width, pictures.height);
+      ConstI420 inset (&pictures.inset[0], pictures.width / 2, pictures.height / 2);
+      memcpy (&pictures.result[0], &pictures.source[0], pictures.source.size ());
+      blend (inset, result, pictures.width / 3, pictures.height / 3, 160);
+      break;
+    }
+
+    case Mirror:
+      mirror (source, I420 (&pictures.result[0], pictures.width, pictures.height));
+      break;
+
+    case Halve:
+      halve (source, I420 (&pictures.result[0], pictures.width / 2, pictures.height / 2));
+      break;
+
+    case Scale:
+      scale (source, I420 (&pictures.result[0], pictures.width * 2 / 3 & ~1u, pictures.height * 2 / 3 & ~1u));
+      break;
+
+    case ToRgba:
+      to_rgba (source, (unsigned char*) &pictures.result[0], 4 * pictures.width);
+      break;
+
+    case KernelCount:
+    default:
+      break;
+    }
+  }
+
+  bool
+  check_size (unsigned width,
+              unsigned height,
+              unsigned rounds)
+  {
+    Pictures pictures (width, height);
+    std::vector<char> reference;
+    bool ok = true;
+
+    printf ("%ux%u (microseconds per picture)\n", width, height);
+
+    for (unsigned kernel = 0; kernel < KernelCount; kernel++) {
+
+      printf ("  %-22s", kernel_names[kernel]);
+
+      for (unsigned level = Scalar; level <= (unsigned) get_best_level (); level++) {
+
+        set_level ((Level) level);
+        memset (&pictures.result[0], 0, pictures.result.size ());
+        run ((Kernel) kernel, pictures);
+
+        if (level == Scalar)
+          reference = pictures.result;
+        else if (pictures.result != reference) {
+
+          fprintf (stderr, "%ux%u: %s differs at level %s\n",
+                   width, height, kernel_names[kernel], level_names[level]);
+          ok = false;
+        }
+
+        gint64 start = g_get_monotonic_time ();
+        for (unsigned i = 0; i < rounds; i++)
+          run ((Kernel) kernel, pictures);
+        printf (" %6s %8.1f", level_names[level], (double) (g_get_monotonic_time () - start) / rounds);
+      }
+      printf ("\n");
+    }
+
+    return ok;
+  }
+};
+
+int
+main (int argc,
+      char* argv[])
+{
+  const unsigned rounds = (argc > 1) ? atoi (argv[1]) : 50;
+  bool ok = true;
+
+  if (rounds == 0) {
+
+    fprintf (stderr, "Usage: %s [rounds]\n", argv[0]);
+    return 1;
+  }
+
+  ok = check_size (178, 98, rounds) && ok;
+  ok = check_size (1280, 720, rounds) && ok;
+  ok = check_size (1920, 1080, rounds) && ok;
+
+  if (!ok)
+    fprintf (stderr, "The SIMD kernels don't match the plain ones!\n");
+
+  return ok ? 0 : 1;
+}